@@ -75,6 +75,12 @@ void sigint_handler(int sig, siginfo_t* info, void*) {
   abort();
 }
 
+/** Handler for SIGUSR1, i.e., a request for the statistics while solving. */
+void sigusr1_handler(int sig, siginfo_t* info, void*) {
+  // the statistics are flushed by the solver at its next check
+  StatisticsRegistry::requestFlush();
+}
+
 /** Handler for SIGSEGV (segfault). */
 void segv_handler(int sig, siginfo_t* info, void* c) {
   uintptr_t extent = reinterpret_cast<uintptr_t>(cvc4StackBase) - cvc4StackSize;
@@ -271,6 +277,14 @@ void cvc4_init() throw(Exception) {
     throw Exception(string("sigaction(SIGXCPU) failure: ") + strerror(errno));
   }
 
+  struct sigaction act5;
+  act5.sa_sigaction = sigusr1_handler;
+  act5.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&act5.sa_mask);
+  if(sigaction(SIGUSR1, &act5, NULL)) {
+    throw Exception(string("sigaction(SIGUSR1) failure: ") + strerror(errno));
+  }
+
   struct sigaction act3;
   act3.sa_sigaction = segv_handler;
   act3.sa_flags = SA_SIGINFO | SA_ONSTACK;
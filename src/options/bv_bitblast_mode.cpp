@@ -68,4 +68,40 @@ std::ostream& operator<<(std::ostream& out, theory::bv::SatSolverMode solver) {
   return out;
 }
 
+std::ostream& operator<<(std::ostream& out, theory::bv::BvMultiplierMode mode) {
+  switch(mode) {
+  case theory::bv::BV_MULTIPLIER_SHIFT_ADD:
+    out << "BV_MULTIPLIER_SHIFT_ADD";
+    break;
+  case theory::bv::BV_MULTIPLIER_WALLACE:
+    out << "BV_MULTIPLIER_WALLACE";
+    break;
+  case theory::bv::BV_MULTIPLIER_DADDA:
+    out << "BV_MULTIPLIER_DADDA";
+    break;
+  case theory::bv::BV_MULTIPLIER_KARATSUBA:
+    out << "BV_MULTIPLIER_KARATSUBA";
+    break;
+  default:
+    out << "BvMultiplierMode:UNKNOWN![" << unsigned(mode) << "]";
+  }
+
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, theory::bv::BvDividerMode mode) {
+  switch(mode) {
+  case theory::bv::BV_DIVIDER_RESTORING:
+    out << "BV_DIVIDER_RESTORING";
+    break;
+  case theory::bv::BV_DIVIDER_NON_RESTORING:
+    out << "BV_DIVIDER_NON_RESTORING";
+    break;
+  default:
+    out << "BvDividerMode:UNKNOWN![" << unsigned(mode) << "]";
+  }
+
+  return out;
+}
+
 }/* CVC4 namespace */
@@ -66,6 +66,26 @@ enum SatSolverMode {
   SAT_SOLVER_CRYPTOMINISAT,
 };/* enum SatSolver */
 
+/** Enumeration of multiplier circuits used when bit-blasting bvmul */
+enum BvMultiplierMode {
+  /** Shift-and-add array multiplier */
+  BV_MULTIPLIER_SHIFT_ADD,
+  /** Wallace tree reduction of the partial products */
+  BV_MULTIPLIER_WALLACE,
+  /** Dadda tree reduction of the partial products */
+  BV_MULTIPLIER_DADDA,
+  /** Karatsuba splitting down to Dadda trees for narrow operands */
+  BV_MULTIPLIER_KARATSUBA
+};/* enum BvMultiplierMode */
+
+/** Enumeration of divider circuits used when bit-blasting bvudiv/bvurem */
+enum BvDividerMode {
+  /** Restoring divider */
+  BV_DIVIDER_RESTORING,
+  /** Non-restoring divider */
+  BV_DIVIDER_NON_RESTORING
+};/* enum BvDividerMode */
+
 
 }/* CVC4::theory::bv namespace */
 }/* CVC4::theory namespace */
@@ -73,6 +93,8 @@ enum SatSolverMode {
 std::ostream& operator<<(std::ostream& out, theory::bv::BitblastMode mode);
 std::ostream& operator<<(std::ostream& out, theory::bv::BvSlicerMode mode);
 std::ostream& operator<<(std::ostream& out, theory::bv::SatSolverMode mode);
+std::ostream& operator<<(std::ostream& out, theory::bv::BvMultiplierMode mode);
+std::ostream& operator<<(std::ostream& out, theory::bv::BvDividerMode mode);
 
 }/* CVC4 namespace */
 
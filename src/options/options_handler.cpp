@@ -990,12 +990,8 @@ theory::bv::BitblastMode OptionsHandler::stringToBitblastMode(std::string option
     }
     return theory::bv::BITBLAST_MODE_LAZY;
   } else if(optarg == "eager") {
-
-    if (options::incrementalSolving() &&
-        options::incrementalSolving.wasSetByUser()) {
-      throw OptionException(std::string("Eager bit-blasting does not currently support incremental mode. \n\
-                                         Try --bitblast=lazy"));
-    }
+    // whether incremental mode is supported is decided in
+    // SmtEngine::setDefaults(), once all the options are known
     if (!options::bitvectorToBool.wasSetByUser()) {
       options::bitvectorToBool.set(true);
     }
@@ -1060,6 +1056,78 @@ void OptionsHandler::setBitblastAig(std::string option, bool arg) throw(OptionEx
   }
 }
 
+void OptionsHandler::setBitblastNativeAig(std::string option, bool arg) throw(OptionException) {
+  if(arg) {
+    if(options::bitblastMode.wasSetByUser()) {
+      if(options::bitblastMode() != theory::bv::BITBLAST_MODE_EAGER) {
+        throw OptionException("bitblast-native-aig must be used with eager bitblaster");
+      }
+    } else {
+      theory::bv::BitblastMode mode = stringToBitblastMode("", "eager");
+      options::bitblastMode.set(mode);
+    }
+  }
+}
+
+const std::string OptionsHandler::s_bvMultiplierModeHelp = "\
+Multiplier circuits supported by the --bv-multiplier option:\n\
+\n\
+shift-add (default)\n\
++ Shift-and-add array multiplier\n\
+\n\
+wallace\n\
++ Wallace tree reduction of the partial products\n\
+\n\
+dadda\n\
++ Dadda tree reduction of the partial products\n\
+\n\
+karatsuba\n\
++ Karatsuba splitting of wide operands, narrow ones use a Dadda tree\n\
+  (see --bv-karatsuba-threshold)\n\
+";
+
+theory::bv::BvMultiplierMode OptionsHandler::stringToBvMultiplierMode(std::string option, std::string optarg) throw(OptionException) {
+  if(optarg == "shift-add") {
+    return theory::bv::BV_MULTIPLIER_SHIFT_ADD;
+  } else if(optarg == "wallace") {
+    return theory::bv::BV_MULTIPLIER_WALLACE;
+  } else if(optarg == "dadda") {
+    return theory::bv::BV_MULTIPLIER_DADDA;
+  } else if(optarg == "karatsuba") {
+    return theory::bv::BV_MULTIPLIER_KARATSUBA;
+  } else if(optarg == "help") {
+    puts(s_bvMultiplierModeHelp.c_str());
+    exit(1);
+  } else {
+    throw OptionException(std::string("unknown option for --bv-multiplier: `") +
+                          optarg + "'.  Try --bv-multiplier=help.");
+  }
+}
+
+const std::string OptionsHandler::s_bvDividerModeHelp = "\
+Divider circuits supported by the --bv-divider option:\n\
+\n\
+restoring (default)\n\
++ Restoring divider\n\
+\n\
+non-restoring\n\
++ Non-restoring divider, one controlled add/subtract per quotient bit\n\
+";
+
+theory::bv::BvDividerMode OptionsHandler::stringToBvDividerMode(std::string option, std::string optarg) throw(OptionException) {
+  if(optarg == "restoring") {
+    return theory::bv::BV_DIVIDER_RESTORING;
+  } else if(optarg == "non-restoring") {
+    return theory::bv::BV_DIVIDER_NON_RESTORING;
+  } else if(optarg == "help") {
+    puts(s_bvDividerModeHelp.c_str());
+    exit(1);
+  } else {
+    throw OptionException(std::string("unknown option for --bv-divider: `") +
+                          optarg + "'.  Try --bv-divider=help.");
+  }
+}
+
 // theory/uf/options_handlers.h
 const std::string OptionsHandler::s_ufssModeHelp = "\
 UF strong solver options currently supported by the --uf-ss option:\n\
@@ -114,6 +114,9 @@ public:
   theory::bv::BitblastMode stringToBitblastMode(std::string option, std::string optarg) throw(OptionException);
   theory::bv::BvSlicerMode stringToBvSlicerMode(std::string option, std::string optarg) throw(OptionException);
   void setBitblastAig(std::string option, bool arg) throw(OptionException);
+  void setBitblastNativeAig(std::string option, bool arg) throw(OptionException);
+  theory::bv::BvMultiplierMode stringToBvMultiplierMode(std::string option, std::string optarg) throw(OptionException);
+  theory::bv::BvDividerMode stringToBvDividerMode(std::string option, std::string optarg) throw(OptionException);
 
   theory::bv::SatSolverMode stringToSatSolver(std::string option, std::string optarg) throw(OptionException);
     
@@ -198,6 +201,8 @@ public:
   static const std::string s_bvSatSolverHelp;
   static const std::string s_booleanTermConversionModeHelp;
   static const std::string s_bvSlicerModeHelp;
+  static const std::string s_bvMultiplierModeHelp;
+  static const std::string s_bvDividerModeHelp;
   static const std::string s_cegqiFairModeHelp;
   static const std::string s_decisionModeHelp;
   static const std::string s_instFormatHelp ;
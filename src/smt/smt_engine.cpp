@@ -20,6 +20,7 @@
 #include <cctype>
 #include <ext/hash_map>
 #include <iterator>
+#include <list>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -222,6 +223,10 @@ struct SmtEngineStatistics {
 
   /** Has something simplified to false? */
   IntStat d_simplifiedToFalse;
+  /** number of queries answered from the query cache */
+  IntStat d_numQueryCacheHits;
+  /** number of queries missing in the query cache */
+  IntStat d_numQueryCacheMisses;
   /** Number of resource units spent. */
   ReferenceStat<uint64_t> d_resourceUnitsUsed;
 
@@ -247,6 +252,8 @@ struct SmtEngineStatistics {
     d_pushPopTime("smt::SmtEngine::pushPopTime"),
     d_processAssertionsTime("smt::SmtEngine::processAssertionsTime"),
     d_simplifiedToFalse("smt::SmtEngine::simplifiedToFalse", 0),
+    d_numQueryCacheHits("smt::SmtEngine::numQueryCacheHits", 0),
+    d_numQueryCacheMisses("smt::SmtEngine::numQueryCacheMisses", 0),
     d_resourceUnitsUsed("smt::SmtEngine::resourceUnitsUsed")
  {
 
@@ -271,6 +278,8 @@ struct SmtEngineStatistics {
     smtStatisticsRegistry()->registerStat(&d_pushPopTime);
     smtStatisticsRegistry()->registerStat(&d_processAssertionsTime);
     smtStatisticsRegistry()->registerStat(&d_simplifiedToFalse);
+    smtStatisticsRegistry()->registerStat(&d_numQueryCacheHits);
+    smtStatisticsRegistry()->registerStat(&d_numQueryCacheMisses);
     smtStatisticsRegistry()->registerStat(&d_resourceUnitsUsed);
   }
 
@@ -296,6 +305,8 @@ struct SmtEngineStatistics {
     smtStatisticsRegistry()->unregisterStat(&d_pushPopTime);
     smtStatisticsRegistry()->unregisterStat(&d_processAssertionsTime);
     smtStatisticsRegistry()->unregisterStat(&d_simplifiedToFalse);
+    smtStatisticsRegistry()->unregisterStat(&d_numQueryCacheHits);
+    smtStatisticsRegistry()->unregisterStat(&d_numQueryCacheMisses);
     smtStatisticsRegistry()->unregisterStat(&d_resourceUnitsUsed);
   }
 };/* struct SmtEngineStatistics */
@@ -542,6 +553,18 @@ class SmtEnginePrivate : public NodeManagerListener {
    */
   unsigned d_simplifyAssertionsDepth;
 
+  typedef std::list< std::pair<Node, Result> > QueryCacheList;
+  typedef hash_map<Node, QueryCacheList::iterator, NodeHashFunction> QueryCacheIndex;
+
+  /**
+   * The results of earlier queries for --bv-query-cache, keyed by the
+   * conjunction of their rewritten assertions, most recently used first.
+   * The keys are hash-consed, so two queries with syntactically the same
+   * rewritten assertions share a key.
+   */
+  QueryCacheList d_queryCache;
+  QueryCacheIndex d_queryCacheIndex;
+
   /** TODO: whether certain preprocess steps are necessary */
   //bool d_needsExpandDefs;
   //bool d_needsRewriteBoolTerms;
@@ -839,6 +862,23 @@ public:
   void addFormula(TNode n, bool inUnsatCore, bool inInput = true)
     throw(TypeCheckingException, LogicException);
 
+  /**
+   * Returns the key of the current query in the query cache: the
+   * conjunction of the rewritten assertions in the assertion list, sorted
+   * and without duplicates.
+   */
+  Node getQueryCacheKey();
+
+  /** Looks up key in the query cache, returns true and sets r on a hit. */
+  bool lookupQueryCache(TNode key, Result& r);
+
+  /**
+   * Stores the result of a query in the query cache, evicting the least
+   * recently used result when the cache is full.  Unknown results are not
+   * stored.
+   */
+  void storeQueryCache(TNode key, const Result& r);
+
   /** Expand definitions in n. */
   Node expandDefinitions(TNode n, NodeToNodeHashMap& cache,
                          bool expandOnly = false)
@@ -1580,16 +1620,35 @@ void SmtEngine::setDefaults() {
   }
 
 
+  // incremental eager bit-blasting guards the formulas of each user level
+  // with activation literals, which needs the assumptions of the MiniSat
+  // back end and cannot go through an AIG
   if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER &&
-      options::incrementalSolving()) {
+      options::incrementalSolving() &&
+      (options::bvSatSolver() != theory::bv::SAT_SOLVER_MINISAT ||
+       options::bitvectorAig() ||
+       options::bitvectorNativeAig())) {
     if (options::incrementalSolving.wasSetByUser()) {
-      throw OptionException(std::string("Eager bit-blasting does not currently support incremental mode. \n\
+      throw OptionException(std::string("Eager bit-blasting only supports incremental mode with the MiniSat back end and without AIGs. \n\
                                          Try --bitblast=lazy"));
     }
     Notice() << "SmtEngine: turning off incremental to support eager bit-blasting" << endl;
     setOption("incremental", SExpr("false"));
   }
 
+  // the query cache answers without running the solver, so there is no
+  // model, proof or unsat core for a cached answer
+  if (options::bvQueryCache() > 0 &&
+      (!options::incrementalSolving() ||
+       !d_logic.isPure(THEORY_BV) || d_logic.isQuantified() ||
+       options::produceModels() || options::produceAssignments() ||
+       options::checkModels() || options::unsatCores() ||
+       options::proof())) {
+    Notice() << "SmtEngine: turning off bv-query-cache, it needs incremental "
+             << "QF_BV without models, proofs or unsat cores" << endl;
+    options::bvQueryCache.set(0);
+  }
+
   if (! options::bvEagerExplanations.wasSetByUser() &&
       d_logic.isTheoryEnabled(THEORY_ARRAY) &&
       d_logic.isTheoryEnabled(THEORY_BV)) {
@@ -4287,6 +4346,55 @@ void SmtEnginePrivate::addFormula(TNode n, bool inUnsatCore, bool inInput)
   //d_assertions.push_back(Rewriter::rewrite(n));
 }
 
+Node SmtEnginePrivate::getQueryCacheKey() {
+  Assert(d_smt.d_assertionList != NULL);
+  std::vector<Node> assertions;
+  for(SmtEngine::AssertionList::const_iterator i = d_smt.d_assertionList->begin();
+      i != d_smt.d_assertionList->end(); ++i) {
+    Node n = Rewriter::rewrite(Node::fromExpr(*i));
+    if(n != d_true) {
+      assertions.push_back(n);
+    }
+  }
+  std::sort(assertions.begin(), assertions.end());
+  assertions.erase(std::unique(assertions.begin(), assertions.end()),
+                   assertions.end());
+  if(assertions.empty()) {
+    return d_true;
+  }
+  if(assertions.size() == 1) {
+    return assertions[0];
+  }
+  return NodeManager::currentNM()->mkNode(kind::AND, assertions);
+}
+
+bool SmtEnginePrivate::lookupQueryCache(TNode key, Result& r) {
+  QueryCacheIndex::iterator it = d_queryCacheIndex.find(key);
+  if(it == d_queryCacheIndex.end()) {
+    ++(d_smt.d_stats->d_numQueryCacheMisses);
+    return false;
+  }
+  // move the entry to the front
+  d_queryCache.splice(d_queryCache.begin(), d_queryCache, it->second);
+  r = it->second->second;
+  ++(d_smt.d_stats->d_numQueryCacheHits);
+  Trace("smt") << "SmtEnginePrivate::lookupQueryCache(" << key << ") => " << r << endl;
+  return true;
+}
+
+void SmtEnginePrivate::storeQueryCache(TNode key, const Result& r) {
+  if(r.isSat() == Result::SAT_UNKNOWN) {
+    return;
+  }
+  Assert(d_queryCacheIndex.find(key) == d_queryCacheIndex.end());
+  d_queryCache.push_front(std::make_pair(Node(key), r));
+  d_queryCacheIndex[key] = d_queryCache.begin();
+  if(d_queryCache.size() > options::bvQueryCache()) {
+    d_queryCacheIndex.erase(d_queryCache.back().first);
+    d_queryCache.pop_back();
+  }
+}
+
 void SmtEngine::ensureBoolean(const Expr& e) throw(TypeCheckingException) {
   Type type = e.getType(options::typeChecking());
   Type boolType = d_exprManager->booleanType();
@@ -4344,17 +4452,34 @@ Result SmtEngine::checkSatisfiability(const Expr& ex, bool inUnsatCore, bool isQ
     d_queryMade = true;
 
     // Add the formula
+    Expr ea;
     if(!e.isNull()) {
       d_problemExtended = true;
-      Expr ea = isQuery ? e.notExpr() : e;
+      ea = isQuery ? e.notExpr() : e;
       if(d_assertionList != NULL) {
         d_assertionList->push_back(ea);
       }
-      d_private->addFormula(ea.getNode(), inUnsatCore);
+    }
+
+    // Answer a repeated query from the cache.  internalPush() has processed
+    // the earlier assertions, so nothing is left pending when the check is
+    // skipped.
+    Node queryKey;
+    if(options::bvQueryCache() > 0) {
+      queryKey = d_private->getQueryCacheKey();
     }
 
     Result r(Result::SAT_UNKNOWN, Result::UNKNOWN_REASON);
-    r = isQuery ? check().asValidityResult() : check().asSatisfiabilityResult();
+    if(queryKey.isNull() || !d_private->lookupQueryCache(queryKey, r)) {
+      if(!ea.isNull()) {
+        d_private->addFormula(ea.getNode(), inUnsatCore);
+      }
+      r = check().asSatisfiabilityResult();
+      if(!queryKey.isNull()) {
+        d_private->storeQueryCache(queryKey, r);
+      }
+    }
+    r = isQuery ? r.asValidityResult() : r.asSatisfiabilityResult();
 
     if (options::solveIntAsBV() > 0 &&r.asSatisfiabilityResult().isSat() == Result::UNSAT) {
       r = Result(Result::SAT_UNKNOWN, Result::UNKNOWN_REASON);
@@ -37,6 +37,7 @@ DioSolver::DioSolver(context::Context* ctxt) :
   d_inputConstraints(ctxt),
   d_nextInputConstraintToEnqueue(ctxt, 0),
   d_trail(ctxt),
+  d_combinationCache(),
   d_subs(ctxt),
   d_currentF(),
   d_savedQueue(ctxt),
@@ -55,7 +56,10 @@ DioSolver::Statistics::Statistics() :
   d_cuts("theory::arith::dio::cuts",0),
   d_conflicts("theory::arith::dio::conflicts",0),
   d_conflictTimer("theory::arith::dio::conflictTimer"),
-  d_cutTimer("theory::arith::dio::cutTimer")
+  d_cutTimer("theory::arith::dio::cutTimer"),
+  d_eliminationsReused("theory::arith::dio::eliminationsReused",0),
+  d_eliminationsRecomputed("theory::arith::dio::eliminationsRecomputed",0),
+  d_cacheFlushes("theory::arith::dio::cacheFlushes",0)
 {
   smtStatisticsRegistry()->registerStat(&d_conflictCalls);
   smtStatisticsRegistry()->registerStat(&d_cutCalls);
@@ -65,6 +69,10 @@ DioSolver::Statistics::Statistics() :
 
   smtStatisticsRegistry()->registerStat(&d_conflictTimer);
   smtStatisticsRegistry()->registerStat(&d_cutTimer);
+
+  smtStatisticsRegistry()->registerStat(&d_eliminationsReused);
+  smtStatisticsRegistry()->registerStat(&d_eliminationsRecomputed);
+  smtStatisticsRegistry()->registerStat(&d_cacheFlushes);
 }
 
 DioSolver::Statistics::~Statistics(){
@@ -76,6 +84,10 @@ DioSolver::Statistics::~Statistics(){
 
   smtStatisticsRegistry()->unregisterStat(&d_conflictTimer);
   smtStatisticsRegistry()->unregisterStat(&d_cutTimer);
+
+  smtStatisticsRegistry()->unregisterStat(&d_eliminationsReused);
+  smtStatisticsRegistry()->unregisterStat(&d_eliminationsRecomputed);
+  smtStatisticsRegistry()->unregisterStat(&d_cacheFlushes);
 }
 
 bool DioSolver::queueConditions(TrailIndex t){
@@ -532,9 +544,6 @@ SumPair DioSolver::purifyIndex(TrailIndex i){
 }
 
 DioSolver::TrailIndex DioSolver::combineEqAtIndexes(DioSolver::TrailIndex i, const Integer& q, DioSolver::TrailIndex j, const Integer& r){
-  Constant cq = Constant::mkConstant(q);
-  Constant cr = Constant::mkConstant(r);
-
   const SumPair& si = d_trail[i].d_eq;
   const SumPair& sj = d_trail[j].d_eq;
 
@@ -542,16 +551,40 @@ DioSolver::TrailIndex DioSolver::combineEqAtIndexes(DioSolver::TrailIndex i, con
   Debug("arith::dio") << "d_facts[i] = " << si.getNode() << endl
                       << "d_facts[j] = " << sj.getNode() << endl;
 
+  TrailIndex k = d_trail.size();
 
-  SumPair newSi = (si * cq) + (sj * cr);
+  if(options::dioCache()){
+    Combination key(d_trail[i], q, d_trail[j], r);
+    CombinationCache::const_iterator cached = d_combinationCache.find(key);
+    if(cached != d_combinationCache.end()){
+      ++(d_statistics.d_eliminationsReused);
+      d_trail.push_back((*cached).second);
+      Debug("arith::dio") << "reused "<< d_trail[k].d_eq.getNode()
+                          <<" with proof " << d_trail[k].d_proof.getNode() << endl;
+      return k;
+    }
+  }
 
+  Constant cq = Constant::mkConstant(q);
+  Constant cr = Constant::mkConstant(r);
+
+  SumPair newSi = (si * cq) + (sj * cr);
 
   const Polynomial& pi = d_trail[i].d_proof;
   const Polynomial& pj = d_trail[j].d_proof;
   Polynomial newPi = (pi * cq) + (pj * cr);
 
-  TrailIndex k = d_trail.size();
-  d_trail.push_back(Constraint(newSi, newPi));
+  ++(d_statistics.d_eliminationsRecomputed);
+  Constraint derived(newSi, newPi);
+  if(options::dioCache()){
+    if(d_combinationCache.size() >= options::dioCacheSize()){
+      ++(d_statistics.d_cacheFlushes);
+      d_combinationCache.clear();
+    }
+    d_combinationCache.insert(make_pair(Combination(d_trail[i], q, d_trail[j], r), derived));
+  }
+
+  d_trail.push_back(derived);
 
 
   Debug("arith::dio") << "derived "<< newSi.getNode()
@@ -102,6 +102,53 @@ private:
   };
   context::CDList<Constraint> d_trail;
 
+  /**
+   * A combination d_trail[i] * q + d_trail[j] * r, identified by the
+   * equalities and proofs of i and j rather than by their trail positions.
+   * This keeps the key meaningful after the trail has been backtracked.
+   */
+  struct Combination {
+    Node d_eqI;
+    Node d_proofI;
+    Node d_eqJ;
+    Node d_proofJ;
+    Integer d_q;
+    Integer d_r;
+    Combination(const Constraint& ci, const Integer& q,
+                const Constraint& cj, const Integer& r) :
+      d_eqI(ci.d_eq.getNode()), d_proofI(ci.d_proof.getNode()),
+      d_eqJ(cj.d_eq.getNode()), d_proofJ(cj.d_proof.getNode()),
+      d_q(q), d_r(r)
+    {}
+    bool operator==(const Combination& other) const{
+      return d_eqI == other.d_eqI && d_proofI == other.d_proofI &&
+        d_eqJ == other.d_eqJ && d_proofJ == other.d_proofJ &&
+        d_q == other.d_q && d_r == other.d_r;
+    }
+  };
+  struct CombinationHashFunction {
+    size_t operator()(const Combination& c) const{
+      NodeHashFunction nh;
+      IntegerHashFunction ih;
+      size_t h = nh(c.d_eqI);
+      h = h * 31 + nh(c.d_proofI);
+      h = h * 31 + nh(c.d_eqJ);
+      h = h * 31 + nh(c.d_proofJ);
+      h = h * 31 + ih(c.d_q);
+      return h * 31 + ih(c.d_r);
+    }
+  };
+
+  /**
+   * Caches the results of combineEqAtIndexes().
+   * This is not context dependent: the result of a combination only depends
+   * on the equations being combined, so eliminations are reused when the
+   * same equalities are reasserted after a pop.
+   * The cache is flushed when it grows beyond options::dioCacheSize().
+   */
+  typedef std::hash_map<Combination, Constraint, CombinationHashFunction> CombinationCache;
+  CombinationCache d_combinationCache;
+
   // /** Compare by d_minimal. */
   // struct TrailMinimalCoefficientOrder {
   //   const context::CDList<Constraint>& d_trail;
@@ -415,6 +462,10 @@ public:
     TimerStat d_conflictTimer;
     TimerStat d_cutTimer;
 
+    IntStat d_eliminationsReused;
+    IntStat d_eliminationsRecomputed;
+    IntStat d_cacheFlushes;
+
     Statistics();
     ~Statistics();
   };
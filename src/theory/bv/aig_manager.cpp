@@ -0,0 +1,430 @@
+/*********************                                                        */
+/*! \file aig_manager.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief In-tree And-Inverter Graph used as a bit-blasting target.
+ **
+ ** In-tree And-Inverter Graph used as a bit-blasting target.
+ **/
+
+#include "theory/bv/aig_manager.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/cvc4_assert.h"
+#include "smt/smt_statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+std::ostream& operator<<(std::ostream& out, const AigEdge& edge) {
+  if (edge.isConst()) {
+    return out << (edge.isTrue() ? "1" : "0");
+  }
+  return out << (edge.isNegated() ? "~a" : "a") << edge.getId();
+}
+
+AigManager* AigManager::s_current = NULL;
+
+AigManager::AigManager()
+  : d_nodes()
+  , d_strash()
+  , d_statistics()
+{
+  // node 0 is the constant false
+  d_nodes.push_back(AigNode(AigEdge(), AigEdge(), false));
+  Assert (s_current == NULL);
+  s_current = this;
+}
+
+AigManager::~AigManager() {
+  if (s_current == this) {
+    s_current = NULL;
+  }
+}
+
+AigManager* AigManager::currentAigM() {
+  Assert (s_current != NULL);
+  return s_current;
+}
+
+AigEdge AigManager::mkInput() {
+  AigNodeId id = d_nodes.size();
+  d_nodes.push_back(AigNode(AigEdge(), AigEdge(), true));
+  ++(d_statistics.d_numInputs);
+  return AigEdge(id, false);
+}
+
+bool AigManager::simplifyAndAsymmetric(AigEdge a, AigEdge b, AigEdge& result) {
+  // a is a gate, b is compared against its children
+  AigEdge a0 = getLeft(a.getId());
+  AigEdge a1 = getRight(a.getId());
+
+  if (!a.isNegated()) {
+    // contradiction: (x & y) & ~x = false
+    if (b == ~a0 || b == ~a1) {
+      result = AigEdge();
+      return true;
+    }
+    // idempotence: (x & y) & x = x & y
+    if (b == a0 || b == a1) {
+      result = a;
+      return true;
+    }
+    return false;
+  }
+
+  // subsumption: ~(x & y) & ~x = ~x
+  if (b == ~a0 || b == ~a1) {
+    result = b;
+    return true;
+  }
+  // substitution: ~(x & y) & x = ~y & x
+  if (b == a0) {
+    result = mkAnd(~a1, b);
+    return true;
+  }
+  if (b == a1) {
+    result = mkAnd(~a0, b);
+    return true;
+  }
+  return false;
+}
+
+bool AigManager::simplifyAnd(AigEdge a, AigEdge b, AigEdge& result) {
+  // one-level rules
+  if (a.isFalse() || b.isFalse() || a == ~b) {
+    ++(d_statistics.d_numConstantFolds);
+    result = AigEdge();
+    return true;
+  }
+  if (a.isTrue() || a == b) {
+    ++(d_statistics.d_numConstantFolds);
+    result = b;
+    return true;
+  }
+  if (b.isTrue()) {
+    ++(d_statistics.d_numConstantFolds);
+    result = a;
+    return true;
+  }
+
+  // two-level rules
+  bool aIsAnd = isAnd(a.getId());
+  bool bIsAnd = isAnd(b.getId());
+  if ((aIsAnd && simplifyAndAsymmetric(a, b, result)) ||
+      (bIsAnd && simplifyAndAsymmetric(b, a, result))) {
+    ++(d_statistics.d_numTwoLevelRewrites);
+    return true;
+  }
+  if (!aIsAnd || !bIsAnd) {
+    return false;
+  }
+
+  AigEdge a0 = getLeft(a.getId()), a1 = getRight(a.getId());
+  AigEdge b0 = getLeft(b.getId()), b1 = getRight(b.getId());
+  if (!a.isNegated() && !b.isNegated()) {
+    // contradiction: (x & y) & (~x & z) = false
+    if (a0 == ~b0 || a0 == ~b1 || a1 == ~b0 || a1 == ~b1) {
+      ++(d_statistics.d_numTwoLevelRewrites);
+      result = AigEdge();
+      return true;
+    }
+    return false;
+  }
+  if (a.isNegated() && b.isNegated()) {
+    // resolution: ~(x & y) & ~(x & ~y) = ~x
+    if ((a0 == b0 && a1 == ~b1) || (a0 == b1 && a1 == ~b0)) {
+      ++(d_statistics.d_numTwoLevelRewrites);
+      result = ~a0;
+      return true;
+    }
+    if ((a1 == b0 && a0 == ~b1) || (a1 == b1 && a0 == ~b0)) {
+      ++(d_statistics.d_numTwoLevelRewrites);
+      result = ~a1;
+      return true;
+    }
+    return false;
+  }
+
+  // one positive and one negated gate
+  AigEdge pos = a.isNegated() ? b : a;
+  AigEdge neg = a.isNegated() ? a : b;
+  AigEdge p0 = getLeft(pos.getId()), p1 = getRight(pos.getId());
+  AigEdge n0 = getLeft(neg.getId()), n1 = getRight(neg.getId());
+  // subsumption: (x & y) & ~(~x & z) = x & y
+  if (n0 == ~p0 || n0 == ~p1 || n1 == ~p0 || n1 == ~p1) {
+    ++(d_statistics.d_numTwoLevelRewrites);
+    result = pos;
+    return true;
+  }
+  // substitution: (x & y) & ~(x & z) = (x & y) & ~z
+  if (n0 == p0 || n0 == p1) {
+    ++(d_statistics.d_numTwoLevelRewrites);
+    result = mkAnd(pos, ~n1);
+    return true;
+  }
+  if (n1 == p0 || n1 == p1) {
+    ++(d_statistics.d_numTwoLevelRewrites);
+    result = mkAnd(pos, ~n0);
+    return true;
+  }
+  return false;
+}
+
+AigEdge AigManager::mkAnd(AigEdge a, AigEdge b) {
+  if (b < a) {
+    std::swap(a, b);
+  }
+
+  AigEdge result;
+  if (simplifyAnd(a, b, result)) {
+    return result;
+  }
+
+  uint64_t key = andKey(a, b);
+  StrashTable::const_iterator it = d_strash.find(key);
+  if (it != d_strash.end()) {
+    ++(d_statistics.d_numStrashHits);
+    return AigEdge(it->second, false);
+  }
+
+  AigNodeId id = d_nodes.size();
+  d_nodes.push_back(AigNode(a, b, false));
+  ++(d_nodes[a.getId()].d_fanout);
+  ++(d_nodes[b.getId()].d_fanout);
+  d_strash[key] = id;
+  ++(d_statistics.d_numAnds);
+  return AigEdge(id, false);
+}
+
+AigEdge AigManager::mkXor(AigEdge a, AigEdge b) {
+  if (a.isConst()) {
+    return a.isTrue() ? ~b : b;
+  }
+  if (b.isConst()) {
+    return b.isTrue() ? ~a : a;
+  }
+  if (a == b) {
+    return AigEdge();
+  }
+  if (a == ~b) {
+    return ~AigEdge();
+  }
+  return mkOr(mkAnd(a, ~b), mkAnd(~a, b));
+}
+
+AigEdge AigManager::mkIte(AigEdge cond, AigEdge a, AigEdge b) {
+  if (cond.isConst()) {
+    return cond.isTrue() ? a : b;
+  }
+  if (a == b) {
+    return a;
+  }
+  if (a == ~b) {
+    return ~mkXor(cond, a);
+  }
+  return mkOr(mkAnd(cond, a), mkAnd(~cond, b));
+}
+
+AigManager::Statistics::Statistics()
+  : d_numInputs("theory::bv::AigManager::numInputs", 0)
+  , d_numAnds("theory::bv::AigManager::numAnds", 0)
+  , d_numStrashHits("theory::bv::AigManager::numStrashHits", 0)
+  , d_numConstantFolds("theory::bv::AigManager::numConstantFolds", 0)
+  , d_numTwoLevelRewrites("theory::bv::AigManager::numTwoLevelRewrites", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numInputs);
+  smtStatisticsRegistry()->registerStat(&d_numAnds);
+  smtStatisticsRegistry()->registerStat(&d_numStrashHits);
+  smtStatisticsRegistry()->registerStat(&d_numConstantFolds);
+  smtStatisticsRegistry()->registerStat(&d_numTwoLevelRewrites);
+}
+
+AigManager::Statistics::~Statistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_numInputs);
+  smtStatisticsRegistry()->unregisterStat(&d_numAnds);
+  smtStatisticsRegistry()->unregisterStat(&d_numStrashHits);
+  smtStatisticsRegistry()->unregisterStat(&d_numConstantFolds);
+  smtStatisticsRegistry()->unregisterStat(&d_numTwoLevelRewrites);
+}
+
+
+AigCnfEmitter::AigCnfEmitter(AigManager* aigM, prop::SatSolver* satSolver)
+  : d_aigM(aigM)
+  , d_satSolver(satSolver)
+  , d_variables()
+  , d_statistics()
+{}
+
+bool AigCnfEmitter::hasLiteral(AigEdge edge) const {
+  return edge.isConst() || d_variables.find(edge.getId()) != d_variables.end();
+}
+
+prop::SatLiteral AigCnfEmitter::getLiteral(AigEdge edge) const {
+  Assert (hasLiteral(edge));
+  return toLiteral(edge);
+}
+
+prop::SatLiteral AigCnfEmitter::toLiteral(AigEdge edge) const {
+  if (edge.isConst()) {
+    return prop::SatLiteral(d_satSolver->trueVar(), edge.isFalse());
+  }
+  VariableMap::const_iterator it = d_variables.find(edge.getId());
+  Assert (it != d_variables.end());
+  return prop::SatLiteral(it->second, edge.isNegated());
+}
+
+void AigCnfEmitter::addClause(prop::SatClause& clause) {
+  ++(d_statistics.d_numClauses);
+  d_satSolver->addClause(clause, false);
+}
+
+void AigCnfEmitter::collectConjuncts(AigNodeId id, std::vector<AigEdge>& conjuncts) {
+  Assert (d_aigM->isAnd(id));
+  std::vector<AigNodeId> stack;
+  stack.push_back(id);
+  while (!stack.empty()) {
+    AigNodeId current = stack.back();
+    stack.pop_back();
+    AigEdge children[2] = { d_aigM->getLeft(current), d_aigM->getRight(current) };
+    for (unsigned i = 0; i < 2; ++i) {
+      AigEdge child = children[i];
+      AigNodeId childId = child.getId();
+      if (!child.isNegated() &&
+          d_aigM->isAnd(childId) &&
+          d_aigM->getFanout(childId) == 1 &&
+          d_variables.find(childId) == d_variables.end()) {
+        stack.push_back(childId);
+      } else {
+        conjuncts.push_back(child);
+      }
+    }
+  }
+}
+
+void AigCnfEmitter::encodeAnd(AigNodeId id, prop::SatVariable var,
+                              const std::vector<AigEdge>& conjuncts) {
+  prop::SatLiteral lit(var);
+  std::vector<AigEdge> sorted(conjuncts);
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  // a collapsed gate can contain both polarities of the same node
+  for (unsigned i = 1; i < sorted.size(); ++i) {
+    if (sorted[i] == ~sorted[i - 1]) {
+      prop::SatClause clause;
+      clause.push_back(~lit);
+      addClause(clause);
+      return;
+    }
+  }
+
+  prop::SatClause big;
+  big.push_back(lit);
+  for (unsigned i = 0; i < sorted.size(); ++i) {
+    prop::SatLiteral child = toLiteral(sorted[i]);
+    prop::SatClause clause;
+    clause.push_back(~lit);
+    clause.push_back(child);
+    addClause(clause);
+    big.push_back(~child);
+  }
+  addClause(big);
+}
+
+prop::SatLiteral AigCnfEmitter::convert(AigEdge edge) {
+  TimerStat::CodeTimer emitTimer(d_statistics.d_emitTime, true);
+  if (hasLiteral(edge)) {
+    return toLiteral(edge);
+  }
+
+  // post-order traversal, a node is encoded once all its conjuncts are
+  std::vector<std::pair<AigNodeId, bool> > stack;
+  stack.push_back(std::make_pair(edge.getId(), false));
+  while (!stack.empty()) {
+    AigNodeId current = stack.back().first;
+    bool expanded = stack.back().second;
+    stack.pop_back();
+    if (d_variables.find(current) != d_variables.end()) {
+      continue;
+    }
+
+    if (d_aigM->isInput(current)) {
+      d_variables[current] = d_satSolver->newVar(false, false, false);
+      ++(d_statistics.d_numVariables);
+      continue;
+    }
+
+    std::vector<AigEdge> conjuncts;
+    collectConjuncts(current, conjuncts);
+    if (!expanded) {
+      stack.push_back(std::make_pair(current, true));
+      for (unsigned i = 0; i < conjuncts.size(); ++i) {
+        if (!hasLiteral(conjuncts[i])) {
+          stack.push_back(std::make_pair(conjuncts[i].getId(), false));
+        }
+      }
+      continue;
+    }
+
+    prop::SatVariable var = d_satSolver->newVar(false, false, false);
+    ++(d_statistics.d_numVariables);
+    d_variables[current] = var;
+    encodeAnd(current, var, conjuncts);
+  }
+
+  return toLiteral(edge);
+}
+
+void AigCnfEmitter::assertEdge(AigEdge edge) {
+  TimerStat::CodeTimer emitTimer(d_statistics.d_emitTime, true);
+  // top-level conjunctions are split into their conjuncts regardless of
+  // fanout, so no variable is needed for the asserted gate itself
+  std::vector<AigEdge> toAssert;
+  toAssert.push_back(edge);
+  while (!toAssert.empty()) {
+    AigEdge current = toAssert.back();
+    toAssert.pop_back();
+    if (current.isTrue()) {
+      continue;
+    }
+    if (!current.isNegated() &&
+        d_aigM->isAnd(current.getId()) &&
+        !hasLiteral(current)) {
+      toAssert.push_back(d_aigM->getLeft(current.getId()));
+      toAssert.push_back(d_aigM->getRight(current.getId()));
+      continue;
+    }
+    prop::SatClause clause;
+    clause.push_back(convert(current));
+    addClause(clause);
+  }
+}
+
+AigCnfEmitter::Statistics::Statistics()
+  : d_numVariables("theory::bv::AigCnfEmitter::numVariables", 0)
+  , d_numClauses("theory::bv::AigCnfEmitter::numClauses", 0)
+  , d_emitTime("theory::bv::AigCnfEmitter::emitTime")
+{
+  smtStatisticsRegistry()->registerStat(&d_numVariables);
+  smtStatisticsRegistry()->registerStat(&d_numClauses);
+  smtStatisticsRegistry()->registerStat(&d_emitTime);
+}
+
+AigCnfEmitter::Statistics::~Statistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_numVariables);
+  smtStatisticsRegistry()->unregisterStat(&d_numClauses);
+  smtStatisticsRegistry()->unregisterStat(&d_emitTime);
+}
+
+}/* CVC4::theory::bv namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,192 @@
+/*********************                                                        */
+/*! \file aig_manager.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief In-tree And-Inverter Graph used as a bit-blasting target.
+ **
+ ** In-tree And-Inverter Graph used as a bit-blasting target. AND gates are
+ ** structurally hashed and simplified with constant propagation and the
+ ** two-level rules of Brummayer and Biere ("Local Two-Level And-Inverter
+ ** Graph Minimization without Blowup") when they are created. The
+ ** AigCnfEmitter translates the cone of influence of an edge directly to
+ ** clauses without building intermediate Boolean Nodes.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__AIG_MANAGER_H
+#define __CVC4__THEORY__BV__AIG_MANAGER_H
+
+#include <stdint.h>
+#include <ext/hash_map>
+#include <iosfwd>
+#include <vector>
+
+#include "prop/sat_solver.h"
+#include "prop/sat_solver_types.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+typedef unsigned AigNodeId;
+
+/**
+ * A possibly complemented reference to an AIG node. The low bit of the
+ * literal is the complement flag, the remaining bits the node id. Node 0 is
+ * the constant false, so the literals 0 and 1 are false and true.
+ */
+class AigEdge {
+  unsigned d_lit;
+public:
+  AigEdge() : d_lit(0) {}
+  AigEdge(AigNodeId id, bool negated) : d_lit((id << 1) | (negated ? 1 : 0)) {}
+
+  AigNodeId getId() const { return d_lit >> 1; }
+  bool isNegated() const { return d_lit & 1; }
+  bool isConst() const { return getId() == 0; }
+  bool isTrue() const { return d_lit == 1; }
+  bool isFalse() const { return d_lit == 0; }
+  unsigned getLiteral() const { return d_lit; }
+
+  AigEdge operator~() const {
+    AigEdge result;
+    result.d_lit = d_lit ^ 1;
+    return result;
+  }
+  AigEdge getRegular() const { return AigEdge(getId(), false); }
+
+  bool operator==(const AigEdge& other) const { return d_lit == other.d_lit; }
+  bool operator!=(const AigEdge& other) const { return d_lit != other.d_lit; }
+  bool operator<(const AigEdge& other) const { return d_lit < other.d_lit; }
+};/* class AigEdge */
+
+struct AigEdgeHashFunction {
+  size_t operator()(const AigEdge& edge) const { return edge.getLiteral(); }
+};/* struct AigEdgeHashFunction */
+
+std::ostream& operator<<(std::ostream& out, const AigEdge& edge);
+
+/**
+ * Owns the nodes of an And-Inverter Graph. Nodes are only ever added, so
+ * edges stay valid for the lifetime of the manager.
+ */
+class AigManager {
+  struct AigNode {
+    AigEdge d_left;
+    AigEdge d_right;
+    /** number of AND gates using this node as a child */
+    unsigned d_fanout;
+    bool d_isInput;
+    AigNode(AigEdge left, AigEdge right, bool isInput)
+      : d_left(left), d_right(right), d_fanout(0), d_isInput(isInput) {}
+  };
+
+  struct AndKeyHashFunction {
+    size_t operator()(uint64_t key) const {
+      key ^= key >> 33;
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      return (size_t)key;
+    }
+  };
+  typedef __gnu_cxx::hash_map<uint64_t, AigNodeId, AndKeyHashFunction> StrashTable;
+
+  std::vector<AigNode> d_nodes;
+  StrashTable d_strash;
+
+  static AigManager* s_current;
+
+  static uint64_t andKey(AigEdge a, AigEdge b) {
+    return (((uint64_t)a.getLiteral()) << 32) | b.getLiteral();
+  }
+  /** Applies the one- and two-level rewrite rules, returns true if the
+   * gate was simplified into result */
+  bool simplifyAnd(AigEdge a, AigEdge b, AigEdge& result);
+  bool simplifyAndAsymmetric(AigEdge a, AigEdge b, AigEdge& result);
+
+  class Statistics {
+  public:
+    IntStat d_numInputs;
+    IntStat d_numAnds;
+    IntStat d_numStrashHits;
+    IntStat d_numConstantFolds;
+    IntStat d_numTwoLevelRewrites;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+
+public:
+  AigManager();
+  ~AigManager();
+
+  /** The manager used by the mk* functions of bitblast_utils.h */
+  static AigManager* currentAigM();
+
+  AigEdge mkInput();
+  AigEdge mkAnd(AigEdge a, AigEdge b);
+  AigEdge mkOr(AigEdge a, AigEdge b) { return ~mkAnd(~a, ~b); }
+  AigEdge mkXor(AigEdge a, AigEdge b);
+  AigEdge mkIte(AigEdge cond, AigEdge a, AigEdge b);
+
+  bool isInput(AigNodeId id) const { return d_nodes[id].d_isInput; }
+  bool isAnd(AigNodeId id) const { return id != 0 && !d_nodes[id].d_isInput; }
+  AigEdge getLeft(AigNodeId id) const { return d_nodes[id].d_left; }
+  AigEdge getRight(AigNodeId id) const { return d_nodes[id].d_right; }
+  unsigned getFanout(AigNodeId id) const { return d_nodes[id].d_fanout; }
+  unsigned getNumNodes() const { return d_nodes.size(); }
+};/* class AigManager */
+
+/**
+ * Incrementally converts AIG cones to CNF. Every AND node that is reached
+ * gets one SAT variable, except chains of un-negated single-fanout AND
+ * nodes which are collapsed into one n-ary gate. Nodes are only encoded
+ * once, later cones reuse the variables of earlier ones.
+ */
+class AigCnfEmitter {
+  typedef __gnu_cxx::hash_map<AigNodeId, prop::SatVariable> VariableMap;
+
+  AigManager* d_aigM;
+  prop::SatSolver* d_satSolver;
+  VariableMap d_variables;
+
+  /** Collects the inputs of the maximal n-ary AND rooted at id */
+  void collectConjuncts(AigNodeId id, std::vector<AigEdge>& conjuncts);
+  void encodeAnd(AigNodeId id, prop::SatVariable var, const std::vector<AigEdge>& conjuncts);
+  prop::SatLiteral toLiteral(AigEdge edge) const;
+  void addClause(prop::SatClause& clause);
+
+  class Statistics {
+  public:
+    IntStat d_numVariables;
+    IntStat d_numClauses;
+    TimerStat d_emitTime;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+
+public:
+  AigCnfEmitter(AigManager* aigM, prop::SatSolver* satSolver);
+
+  /** Makes sure the cone of edge is encoded and returns its literal */
+  prop::SatLiteral convert(AigEdge edge);
+  /** Encodes the cone of edge and asserts that it is true */
+  void assertEdge(AigEdge edge);
+
+  bool hasLiteral(AigEdge edge) const;
+  prop::SatLiteral getLiteral(AigEdge edge) const;
+};/* class AigCnfEmitter */
+
+}/* CVC4::theory::bv namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__BV__AIG_MANAGER_H */
@@ -19,6 +19,7 @@
 
 #include "cvc4_private.h"
 #include "expr/node.h"
+#include "options/bv_options.h"
 #include "theory/bv/bitblast_utils.h"
 #include "theory/bv/theory_bv_utils.h"
 #include <ostream>
@@ -394,6 +395,86 @@ void DefaultMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
   }
 }
 
+/**
+ * Multiplies bits by bits of node[i] with the circuit selected by mode.
+ */
+template <class T>
+void multiplyBits(const std::vector<T>& a, const std::vector<T>& b,
+                  std::vector<T>& res, BvMultiplierMode mode) {
+  switch (mode) {
+  case BV_MULTIPLIER_WALLACE:
+    treeMultiplier(a, b, a.size(), false, res);
+    break;
+  case BV_MULTIPLIER_DADDA:
+    treeMultiplier(a, b, a.size(), true, res);
+    break;
+  case BV_MULTIPLIER_KARATSUBA:
+    karatsubaMultiplier(a, b, a.size(), options::bvKaratsubaThreshold(), res);
+    break;
+  default:
+    shiftAddMultiplier(a, b, res);
+  }
+}
+
+template <class T>
+void CircuitMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb,
+                    BvMultiplierMode mode) {
+  Debug("bitvector-bb") << "theory::bv::CircuitMultBB bitblasting " << node << "\n";
+  Assert(res.size() == 0 &&
+         node.getKind() == kind::BITVECTOR_MULT);
+
+  // constant factors are folded and applied last as a shift/add chain
+  bool useCsd = options::bvMultConstCsd();
+  unsigned size = utils::getSize(node);
+  BitVector constant(size, 1u);
+  bool hasConstant = false;
+  for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+    if (useCsd && node[i].isConst()) {
+      constant = constant * node[i].getConst<BitVector>();
+      hasConstant = true;
+      continue;
+    }
+    std::vector<T> current;
+    bb->bbTerm(node[i], current);
+    if (res.empty()) {
+      res = current;
+      continue;
+    }
+    std::vector<T> newres;
+    multiplyBits(res, current, newres, mode);
+    res = newres;
+  }
+
+  if (hasConstant) {
+    if (res.empty()) {
+      bb->bbTerm(utils::mkConst(constant), res);
+    } else {
+      std::vector<T> newres;
+      csdConstMultiplier(res, constant, newres);
+      res = newres;
+    }
+  }
+  Assert(res.size() == size);
+  if(Debug.isOn("bitvector-bb")) {
+    Debug("bitvector-bb") << "with bits: " << toString(res)  << "\n";
+  }
+}
+
+template <class T>
+void WallaceMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
+  CircuitMultBB(node, res, bb, BV_MULTIPLIER_WALLACE);
+}
+
+template <class T>
+void DaddaMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
+  CircuitMultBB(node, res, bb, BV_MULTIPLIER_DADDA);
+}
+
+template <class T>
+void KaratsubaMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
+  CircuitMultBB(node, res, bb, BV_MULTIPLIER_KARATSUBA);
+}
+
 template <class T>
 void DefaultPlusBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
   Debug("bitvector-bb") << "theory::bv::DefaultPlusBB bitblasting " << node << "\n";
@@ -571,6 +652,41 @@ void DefaultUremBB (TNode node, std::vector<T>& rem, TBitblaster<T>* bb) {
 }
 
 
+template <class T>
+void NonRestoringUdivBB (TNode node, std::vector<T>& q, TBitblaster<T>* bb) {
+  Debug("bitvector-bb") << "theory::bv::NonRestoringUdivBB bitblasting " << node << "\n";
+  Assert(node.getKind() == kind::BITVECTOR_UDIV_TOTAL &&  q.size() == 0);
+
+  std::vector<T> a, b;
+  bb->bbTerm(node[0], a);
+  bb->bbTerm(node[1], b);
+
+  // the divider already gives a udiv 0 = 11..11 and a urem 0 = a
+  std::vector<T> r;
+  uDivModNonRestoring(a, b, q, r);
+
+  // cache the remainder in case we need it later
+  Node remainder = utils::mkNode(kind::BITVECTOR_UREM_TOTAL, node[0], node[1]);
+  bb->storeBBTerm(remainder, r);
+}
+
+template <class T>
+void NonRestoringUremBB (TNode node, std::vector<T>& rem, TBitblaster<T>* bb) {
+  Debug("bitvector-bb") << "theory::bv::NonRestoringUremBB bitblasting " << node << "\n";
+  Assert(node.getKind() == kind::BITVECTOR_UREM_TOTAL &&  rem.size() == 0);
+
+  std::vector<T> a, b;
+  bb->bbTerm(node[0], a);
+  bb->bbTerm(node[1], b);
+
+  std::vector<T> q;
+  uDivModNonRestoring(a, b, q, rem);
+
+  // cache the quotient in case we need it later
+  Node quotient = utils::mkNode(kind::BITVECTOR_UDIV_TOTAL, node[0], node[1]);
+  bb->storeBBTerm(quotient, q);
+}
+
 template <class T>
 void DefaultSdivBB (TNode node, std::vector<T>& bits, TBitblaster<T>* bb) {
   Debug("bitvector") << "theory::bv:: Unimplemented kind "
@@ -20,8 +20,10 @@
 #define __CVC4__BITBLAST__UTILS_H
 
 
+#include <algorithm>
 #include <ostream>
 #include "expr/node.h"
+#include "theory/bv/aig_manager.h"
 
 #ifdef CVC4_USE_ABC
 #include "base/main/main.h"
@@ -127,6 +129,76 @@ Node mkIte<Node>(Node cond, Node a, Node b) {
   return NodeManager::currentNM()->mkNode(kind::ITE, cond, a, b);
 }
 
+template <> inline
+std::string toString<AigEdge> (const std::vector<AigEdge>& bits) {
+  std::ostringstream os;
+  for (int i = bits.size() - 1; i >= 0; --i) {
+    os << bits[i] << " ";
+  }
+  os <<"\n";
+  return os.str();
+}
+
+template <> inline
+AigEdge mkTrue<AigEdge>() {
+  return ~AigEdge();
+}
+
+template <> inline
+AigEdge mkFalse<AigEdge>() {
+  return AigEdge();
+}
+
+template <> inline
+AigEdge mkNot<AigEdge>(AigEdge a) {
+  return ~a;
+}
+
+template <> inline
+AigEdge mkOr<AigEdge>(AigEdge a, AigEdge b) {
+  return AigManager::currentAigM()->mkOr(a, b);
+}
+
+template <> inline
+AigEdge mkOr<AigEdge>(const std::vector<AigEdge>& children) {
+  Assert (children.size());
+  AigEdge result = children[0];
+  for (unsigned i = 1; i < children.size(); ++i) {
+    result = AigManager::currentAigM()->mkOr(result, children[i]);
+  }
+  return result;
+}
+
+template <> inline
+AigEdge mkAnd<AigEdge>(AigEdge a, AigEdge b) {
+  return AigManager::currentAigM()->mkAnd(a, b);
+}
+
+template <> inline
+AigEdge mkAnd<AigEdge>(const std::vector<AigEdge>& children) {
+  Assert (children.size());
+  AigEdge result = children[0];
+  for (unsigned i = 1; i < children.size(); ++i) {
+    result = AigManager::currentAigM()->mkAnd(result, children[i]);
+  }
+  return result;
+}
+
+template <> inline
+AigEdge mkXor<AigEdge>(AigEdge a, AigEdge b) {
+  return AigManager::currentAigM()->mkXor(a, b);
+}
+
+template <> inline
+AigEdge mkIff<AigEdge>(AigEdge a, AigEdge b) {
+  return ~AigManager::currentAigM()->mkXor(a, b);
+}
+
+template <> inline
+AigEdge mkIte<AigEdge>(AigEdge cond, AigEdge a, AigEdge b) {
+  return AigManager::currentAigM()->mkIte(cond, a, b);
+}
+
 /*
  Various helper functions that get called by the bitblasting procedures
  */
@@ -230,6 +302,286 @@ inline void shiftAddMultiplier(const std::vector<T>&a, const std::vector<T>&b, s
   }
 }
 
+/**
+ * Full adder, returns the carry-out and stores the sum bit in sum.
+ */
+template <class T>
+T inline fullAdder(T a, T b, T carry, T& sum) {
+  T a_xor_b = mkXor(a, b);
+  sum = mkXor(a_xor_b, carry);
+  return mkOr(mkAnd(a, b), mkAnd(a_xor_b, carry));
+}
+
+/**
+ * Half adder, returns the carry-out and stores the sum bit in sum.
+ */
+template <class T>
+T inline halfAdder(T a, T b, T& sum) {
+  sum = mkXor(a, b);
+  return mkAnd(a, b);
+}
+
+/**
+ * Computes a * b modulo 2^width with a column compression multiplier. The
+ * partial products of each weight are reduced with full and half adders
+ * until at most two bits remain per column, which are then added with a
+ * ripple carry adder. If dadda is true the columns are only reduced as far
+ * as Dadda's height schedule requires, otherwise every column is reduced
+ * as much as possible in each stage (Wallace). Operands may be narrower
+ * than width, missing bits are zero.
+ */
+template <class T>
+inline void treeMultiplier(const std::vector<T>& a, const std::vector<T>& b,
+                           unsigned width, bool dadda, std::vector<T>& res) {
+  Assert(res.size() == 0);
+  std::vector<std::vector<T> > columns(width);
+  unsigned height = 0;
+  for (unsigned i = 0; i < b.size() && i < width; ++i) {
+    for (unsigned j = 0; j < a.size() && i + j < width; ++j) {
+      T pp = mkAnd(a[j], b[i]);
+      if (pp != mkFalse<T>()) {
+        columns[i + j].push_back(pp);
+        height = std::max(height, (unsigned)columns[i + j].size());
+      }
+    }
+  }
+
+  // Dadda's maximal column heights 2, 3, 4, 6, 9, ...
+  std::vector<unsigned> targets;
+  for (unsigned d = 2; d < height; d = (d * 3) / 2) {
+    targets.push_back(d);
+  }
+
+  while (height > 2) {
+    unsigned target = 2;
+    if (dadda && !targets.empty()) {
+      target = targets.back();
+      targets.pop_back();
+    }
+    std::vector<std::vector<T> > next(width);
+    for (unsigned k = 0; k < width; ++k) {
+      const std::vector<T>& column = columns[k];
+      unsigned pos = 0;
+      // next[k] already holds the carries coming from column k - 1
+      while (column.size() - pos >= 2) {
+        unsigned left = column.size() - pos;
+        if (dadda) {
+          unsigned newHeight = left + next[k].size();
+          if (newHeight <= target) break;
+          T sum, carry;
+          if (newHeight - target >= 2 && left >= 3) {
+            carry = fullAdder(column[pos], column[pos + 1], column[pos + 2], sum);
+            pos += 3;
+          } else {
+            carry = halfAdder(column[pos], column[pos + 1], sum);
+            pos += 2;
+          }
+          next[k].push_back(sum);
+          if (k + 1 < width) next[k + 1].push_back(carry);
+        } else {
+          T sum, carry;
+          if (left >= 3) {
+            carry = fullAdder(column[pos], column[pos + 1], column[pos + 2], sum);
+            pos += 3;
+          } else if (column.size() >= 3) {
+            // a leftover pair in a column that needed reduction
+            carry = halfAdder(column[pos], column[pos + 1], sum);
+            pos += 2;
+          } else {
+            break;
+          }
+          next[k].push_back(sum);
+          if (k + 1 < width) next[k + 1].push_back(carry);
+        }
+      }
+      for (; pos < column.size(); ++pos) {
+        next[k].push_back(column[pos]);
+      }
+    }
+    columns.swap(next);
+    height = 0;
+    for (unsigned k = 0; k < width; ++k) {
+      height = std::max(height, (unsigned)columns[k].size());
+    }
+  }
+
+  std::vector<T> row0, row1;
+  for (unsigned k = 0; k < width; ++k) {
+    row0.push_back(columns[k].size() > 0 ? columns[k][0] : mkFalse<T>());
+    row1.push_back(columns[k].size() > 1 ? columns[k][1] : mkFalse<T>());
+  }
+  rippleCarryAdder(row0, row1, res, mkFalse<T>());
+}
+
+/**
+ * Computes a + b modulo 2^width, missing operand bits are zero.
+ */
+template <class T>
+inline void addModulo(const std::vector<T>& a, const std::vector<T>& b,
+                      unsigned width, std::vector<T>& res) {
+  std::vector<T> a1(a), b1(b);
+  a1.resize(width, mkFalse<T>());
+  b1.resize(width, mkFalse<T>());
+  res.clear();
+  rippleCarryAdder(a1, b1, res, mkFalse<T>());
+}
+
+/**
+ * Computes a - b modulo 2^width, missing operand bits are zero.
+ */
+template <class T>
+inline void subModulo(const std::vector<T>& a, const std::vector<T>& b,
+                      unsigned width, std::vector<T>& res) {
+  std::vector<T> a1(a), b1(b), not_b;
+  a1.resize(width, mkFalse<T>());
+  b1.resize(width, mkFalse<T>());
+  negateBits(b1, not_b);
+  res.clear();
+  rippleCarryAdder(a1, not_b, res, mkTrue<T>());
+}
+
+/**
+ * Computes a * b modulo 2^width by Karatsuba splitting. With a = a1 2^h + a0
+ * and b = b1 2^h + b0 the cross terms a0 b1 + a1 b0 are obtained from the
+ * single product (a0 + a1)(b0 + b1) minus a0 b0 and a1 b1. Operands at most
+ * threshold bits wide are multiplied with a Dadda tree.
+ */
+template <class T>
+inline void karatsubaMultiplier(const std::vector<T>& a, const std::vector<T>& b,
+                                unsigned width, unsigned threshold,
+                                std::vector<T>& res) {
+  Assert(res.size() == 0);
+  // bits at or above width do not contribute to the result
+  std::vector<T> a1(a.begin(), a.begin() + std::min((unsigned)a.size(), width));
+  std::vector<T> b1(b.begin(), b.begin() + std::min((unsigned)b.size(), width));
+  unsigned n = std::max(a1.size(), b1.size());
+  if (n <= threshold || n < 4) {
+    treeMultiplier(a1, b1, width, true, res);
+    return;
+  }
+  a1.resize(n, mkFalse<T>());
+  b1.resize(n, mkFalse<T>());
+
+  unsigned h = n / 2;
+  std::vector<T> a_lo(a1.begin(), a1.begin() + h), a_hi(a1.begin() + h, a1.end());
+  std::vector<T> b_lo(b1.begin(), b1.begin() + h), b_hi(b1.begin() + h, b1.end());
+
+  // a0 b0 is exact on 2h bits
+  std::vector<T> z0;
+  karatsubaMultiplier(a_lo, b_lo, std::min(width, 2 * h), threshold, z0);
+  z0.resize(width, mkFalse<T>());
+  if (h >= width) {
+    res = z0;
+    return;
+  }
+
+  // everything else is shifted by at least h
+  unsigned mid_width = width - h;
+  std::vector<T> z2;
+  karatsubaMultiplier(a_hi, b_hi, mid_width, threshold, z2);
+
+  std::vector<T> a_sum, b_sum;
+  addModulo(a_lo, a_hi, n - h + 1, a_sum);
+  addModulo(b_lo, b_hi, n - h + 1, b_sum);
+  std::vector<T> z1, z1_minus_z0, middle;
+  karatsubaMultiplier(a_sum, b_sum, mid_width, threshold, z1);
+  std::vector<T> z0_low(z0.begin(), z0.begin() + mid_width);
+  subModulo(z1, z0_low, mid_width, z1_minus_z0);
+  subModulo(z1_minus_z0, z2, mid_width, middle);
+
+  std::vector<T> shifted(h, mkFalse<T>());
+  shifted.insert(shifted.end(), middle.begin(), middle.end());
+  if (2 * h < width) {
+    std::vector<T> shifted_z2(2 * h, mkFalse<T>());
+    shifted_z2.insert(shifted_z2.end(), z2.begin(), z2.begin() + (width - 2 * h));
+    std::vector<T> sum;
+    addModulo(shifted, shifted_z2, width, sum);
+    shifted = sum;
+  }
+  addModulo(z0, shifted, width, res);
+}
+
+/**
+ * Computes a * c modulo 2^a.size() for the constant c as a chain of shifted
+ * additions and subtractions of a, one per non-zero digit of the canonical
+ * signed digit (non-adjacent form) recoding of c.
+ */
+template <class T>
+inline void csdConstMultiplier(const std::vector<T>& a, const BitVector& c,
+                               std::vector<T>& res) {
+  Assert(res.size() == 0);
+  unsigned n = a.size();
+  makeZero(res, n);
+  unsigned carry = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    unsigned bit = (c.isBitSet(i) ? 1 : 0) + carry;
+    bool next = i + 1 < n && c.isBitSet(i + 1);
+    int digit = 0;
+    if (bit == 1) {
+      digit = next ? -1 : 1;
+      carry = next ? 1 : 0;
+    } else {
+      carry = bit == 2 ? 1 : 0;
+    }
+    if (digit == 0) {
+      continue;
+    }
+    std::vector<T> shifted(i, mkFalse<T>());
+    shifted.insert(shifted.end(), a.begin(), a.begin() + (n - i));
+    std::vector<T> sum;
+    if (digit > 0) {
+      addModulo(res, shifted, n, sum);
+    } else {
+      subModulo(res, shifted, n, sum);
+    }
+    res = sum;
+  }
+}
+
+/**
+ * Unsigned division and remainder with a non-restoring divider. The partial
+ * remainder lives in [-b, b) and is kept on n + 1 bits; each step adds or
+ * subtracts b depending on its sign, without the multiplexers a restoring
+ * divider needs. A final step adds b back to a negative remainder. Division
+ * by zero yields q = 11..1 and r = a without special casing.
+ */
+template <class T>
+inline void uDivModNonRestoring(const std::vector<T>& a, const std::vector<T>& b,
+                                std::vector<T>& q, std::vector<T>& r) {
+  Assert(a.size() == b.size() && q.size() == 0 && r.size() == 0);
+  unsigned n = a.size();
+  std::vector<T> b_ext(b);
+  b_ext.push_back(mkFalse<T>());
+
+  std::vector<T> rem;
+  makeZero(rem, n + 1);
+  T negative = mkFalse<T>();
+  q.resize(n);
+  for (int i = n - 1; i >= 0; --i) {
+    // rem = 2 * rem + a[i] +/- b
+    std::vector<T> shifted;
+    shifted.push_back(a[i]);
+    shifted.insert(shifted.end(), rem.begin(), rem.begin() + n);
+    T positive = mkNot(negative);
+    std::vector<T> operand;
+    for (unsigned j = 0; j <= n; ++j) {
+      operand.push_back(mkXor(b_ext[j], positive));
+    }
+    rem.clear();
+    rippleCarryAdder(shifted, operand, rem, positive);
+    negative = rem[n];
+    q[i] = mkNot(negative);
+  }
+
+  std::vector<T> correction;
+  for (unsigned j = 0; j <= n; ++j) {
+    correction.push_back(mkAnd(b_ext[j], negative));
+  }
+  std::vector<T> corrected;
+  rippleCarryAdder(rem, correction, corrected, mkFalse<T>());
+  r.insert(r.end(), corrected.begin(), corrected.begin() + n);
+}
+
 template <class T>
 T inline uLessThanBB(const std::vector<T>&a, const std::vector<T>& b, bool orEqual) {
   Assert (a.size() && b.size());
@@ -25,6 +25,8 @@
 #include "bitblast_strategies_template.h"
 #include "context/cdhashmap.h"
 #include "expr/node.h"
+#include "options/bv_options.h"
+#include "options/smt_options.h"
 #include "prop/sat_solver.h"
 #include "theory/theory_registrar.h"
 #include "theory/valuation.h"
@@ -163,10 +165,30 @@ class TLazyBitblaster :  public TBitblaster<Node> {
 
   context::CDO<bool> d_satSolverFullModel;
 
+  /** Whether wide arithmetic operators are abstracted (--bv-cegar) */
+  bool d_cegar;
+  /** The terms bit-blasted as unconstrained bits, in creation order */
+  std::vector<Node> d_abstractedTerms;
+  /** The abstracted terms whose circuit has been added */
+  TNodeSet d_refinedTerms;
+
   void addAtom(TNode atom);
   bool hasValue(TNode a);
   Node getModelFromSatSolver(TNode a, bool fullModel);
 
+  bool isAbstractable(TNode node) const;
+  /**
+   * Bit-blasts node as fresh bits, constrained only by a few lemmas that
+   * are linear in its width.
+   */
+  void abstractTerm(TNode node, Bits& bits);
+  /**
+   * Adds the circuit of every abstracted term whose value in the current
+   * SAT model differs from its value on the values of its children.
+   * Returns false if there was no such term.
+   */
+  bool refineAbstraction();
+
 public:
   void bbTerm(TNode node, Bits&  bits);
   void bbAtom(TNode node);
@@ -231,8 +253,12 @@ private:
   public:
     IntStat d_numTermClauses, d_numAtomClauses;
     IntStat d_numTerms, d_numAtoms;
+    /** lookups answered by the term and atom caches, which persist across
+     * check-sat calls */
+    IntStat d_numTermCacheHits, d_numAtomCacheHits;
     IntStat d_numExplainedPropagations;
     IntStat d_numBitblastingPropagations;
+    IntStat d_numAbstractedTerms, d_numRefinedTerms, d_numRefinements;
     TimerStat d_bitblastTimer;
     Statistics(const std::string& name);
     ~Statistics();
@@ -269,11 +295,38 @@ class EagerBitblaster : public TBitblaster<Node> {
   // This is either an MinisatEmptyNotify or NULL.
   MinisatEmptyNotify* d_notify;
 
+  /** Disables the formulas of the popped user levels */
+  class UserContextNotify : public context::ContextNotifyObj {
+    EagerBitblaster* d_bitblaster;
+  protected:
+    void contextNotifyPop() { d_bitblaster->userContextPopped(); }
+  public:
+    UserContextNotify(context::Context* c, EagerBitblaster* bb)
+      : context::ContextNotifyObj(c), d_bitblaster(bb) {}
+  };
+
+  // In incremental mode the formulas asserted at user level i > 0 are
+  // guarded by the activation literal d_activationLits[i - 1], which is
+  // assumed while solving and asserted false once level i is popped.
+  // Learned clauses that depend on a formula contain the negation of its
+  // activation literal, so the others stay valid across pops.
+  bool d_incremental;
+  context::Context* d_userContext;
+  UserContextNotify* d_userNotify;
+  prop::BVSatSolverInterface* d_bvSatSolver;
+  std::vector<prop::SatLiteral> d_activationLits;
+  /** Whether the activation literals are assumed in d_nullContext */
+  bool d_assumptionsAsserted;
+
   Node getModelFromSatSolver(TNode a, bool fullModel);
   bool isSharedTerm(TNode node);
+  prop::SatLiteral getActivationLiteral(unsigned level);
+  void clearAssumptions();
+  void userContextPopped();
 
 public:
-  EagerBitblaster(theory::bv::TheoryBV* theory_bv);
+  EagerBitblaster(theory::bv::TheoryBV* theory_bv,
+                  const std::string& name = "EagerBitblaster");
   ~EagerBitblaster();
 
   void addAtom(TNode atom);
@@ -356,6 +409,46 @@ private:
 
 };
 
+/**
+ * Eager bit-blaster that builds an in-tree AIG instead of Boolean Nodes and
+ * emits the clauses for it directly, without going through the CnfStream.
+ */
+class NativeAigBitblaster : public TBitblaster<AigEdge> {
+  typedef __gnu_cxx::hash_map<Node, AigEdge, NodeHashFunction> NodeAigMap;
+
+  AigManager* d_aigM;
+  context::Context* d_nullContext;
+  prop::SatSolver* d_satSolver;
+  MinisatEmptyNotify* d_notify;
+  AigCnfEmitter* d_cnfEmitter;
+
+  theory::bv::TheoryBV* d_bv;
+  NodeAigMap d_aigCache;
+  NodeAigMap d_bbAtoms;
+  NodeAigMap d_nodeToAigInput;
+  TNodeSet d_variables;
+
+  AigEdge mkInput(TNode input);
+  Node getModelFromSatSolver(TNode a, bool fullModel);
+  bool isSharedTerm(TNode node);
+public:
+  NativeAigBitblaster(theory::bv::TheoryBV* theory_bv);
+  ~NativeAigBitblaster();
+
+  void makeVariable(TNode node, Bits& bits);
+  void bbTerm(TNode node, Bits&  bits);
+  void bbAtom(TNode node);
+  AigEdge getBBAtom(TNode atom) const;
+  bool hasBBAtom(TNode atom) const;
+  void storeBBAtom(TNode atom, AigEdge atom_bb);
+  AigEdge bbFormula(TNode formula);
+
+  /** Bit-blasts formula and asserts its clauses to the SAT solver */
+  void assertFormula(TNode formula);
+  bool solve();
+  void collectModelInfo(TheoryModel* m, bool fullModel);
+};
+
 
 // Bitblaster implementation
 
@@ -413,6 +506,28 @@ template <class T> void TBitblaster<T>::initTermBBStrategies() {
   d_termBBStrategies [ kind::BITVECTOR_SIGN_EXTEND ]  = DefaultSignExtendBB<T>;
   d_termBBStrategies [ kind::BITVECTOR_ROTATE_RIGHT ] = DefaultRotateRightBB<T>;
   d_termBBStrategies [ kind::BITVECTOR_ROTATE_LEFT ]  = DefaultRotateLeftBB<T>;
+
+  // bit-vector proofs only know the default circuits
+  if (options::proof()) {
+    return;
+  }
+  switch (options::bvMultiplier()) {
+  case BV_MULTIPLIER_WALLACE:
+    d_termBBStrategies [ kind::BITVECTOR_MULT ] = WallaceMultBB<T>;
+    break;
+  case BV_MULTIPLIER_DADDA:
+    d_termBBStrategies [ kind::BITVECTOR_MULT ] = DaddaMultBB<T>;
+    break;
+  case BV_MULTIPLIER_KARATSUBA:
+    d_termBBStrategies [ kind::BITVECTOR_MULT ] = KaratsubaMultBB<T>;
+    break;
+  default:
+    break;
+  }
+  if (options::bvDivider() == BV_DIVIDER_NON_RESTORING) {
+    d_termBBStrategies [ kind::BITVECTOR_UDIV_TOTAL ] = NonRestoringUdivBB<T>;
+    d_termBBStrategies [ kind::BITVECTOR_UREM_TOTAL ] = NonRestoringUremBB<T>;
+  }
 }
 
 template <class T>
@@ -15,44 +15,84 @@
  **/
 
 #include "options/bv_options.h"
+#include "options/smt_options.h"
 #include "theory/bv/bitblaster_template.h"
 #include "proof/bitvector_proof.h"
+#include "smt/smt_statistics_registry.h"
 #include "theory/bv/bv_eager_solver.h"
 
+#include <algorithm>
+#include <ext/hash_map>
+#include <sstream>
+
 using namespace std;
 using namespace CVC4;
 using namespace CVC4::theory;
 using namespace CVC4::theory::bv;
 
+namespace {
+
+unsigned findRoot(std::vector<unsigned>& parent, unsigned i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+}/* anonymous namespace */
+
 EagerBitblastSolver::EagerBitblastSolver(TheoryBV* bv)
-  : d_assertionSet()
+  : d_assertionSet(bv->getUserContext())
   , d_bitblaster(NULL)
   , d_aigBitblaster(NULL)
+  , d_nativeAigBitblaster(NULL)
   , d_useAig(options::bitvectorAig())
+  , d_useNativeAig(options::bitvectorNativeAig() && !options::bitvectorAig())
   , d_bv(bv)
+  , d_useCones(options::bitvectorEagerCones() > 1 && !d_useAig &&
+               !d_useNativeAig && !options::incrementalSolving() &&
+               !options::proof())
+  , d_cones()
+  , d_coneAssertions()
+  , d_coneBitblasted()
+  , d_numPartitioned(0)
+  , d_statistics()
 {}
 
 EagerBitblastSolver::~EagerBitblastSolver() {
   if (d_useAig) {
-    Assert (d_bitblaster == NULL); 
+    Assert (d_bitblaster == NULL && d_nativeAigBitblaster == NULL); 
     delete d_aigBitblaster;
   }
+  else if (d_useNativeAig) {
+    Assert (d_bitblaster == NULL && d_aigBitblaster == NULL);
+    delete d_nativeAigBitblaster;
+  }
   else {
-    Assert (d_aigBitblaster == NULL); 
+    Assert (d_aigBitblaster == NULL && d_nativeAigBitblaster == NULL); 
+    for (unsigned i = 1; i < d_cones.size(); ++i) {
+      delete d_cones[i];
+    }
     delete d_bitblaster;
   }
 }
 
 void EagerBitblastSolver::turnOffAig() {
   Assert (d_aigBitblaster == NULL &&
+          d_nativeAigBitblaster == NULL &&
           d_bitblaster == NULL);
   d_useAig = false;
+  d_useNativeAig = false;
+  d_useCones = false;
 }
 
 void EagerBitblastSolver::initialize() {
   Assert(!isInitialized());
   if (d_useAig) {
     d_aigBitblaster = new AigBitblaster();
+  } else if (d_useNativeAig) {
+    d_nativeAigBitblaster = new NativeAigBitblaster(d_bv);
   } else {
     d_bitblaster = new EagerBitblaster(d_bv);
     THEORY_PROOF(
@@ -65,10 +105,12 @@ void EagerBitblastSolver::initialize() {
 }
 
 bool EagerBitblastSolver::isInitialized() {
-  bool init = d_aigBitblaster != NULL || d_bitblaster != NULL;
+  bool init = d_aigBitblaster != NULL || d_nativeAigBitblaster != NULL ||
+    d_bitblaster != NULL;
   if (init) {
     Assert (!d_useAig || d_aigBitblaster);
-    Assert (d_useAig || d_bitblaster);
+    Assert (!d_useNativeAig || d_nativeAigBitblaster);
+    Assert (d_useAig || d_useNativeAig || d_bitblaster);
   }
   return init;
 }
@@ -78,9 +120,15 @@ void EagerBitblastSolver::assertFormula(TNode formula) {
   Assert (isInitialized());
   Debug("bitvector-eager") << "EagerBitblastSolver::assertFormula "<< formula <<"\n"; 
   d_assertionSet.insert(formula);
+  if (d_useCones) {
+    // the groups are only known once all the formulas are asserted
+    return;
+  }
   //ensures all atoms are bit-blasted and converted to AIG
   if (d_useAig) 
     d_aigBitblaster->bbFormula(formula);
+  else if (d_useNativeAig)
+    d_nativeAigBitblaster->assertFormula(formula);
   else
     d_bitblaster->bbFormula(formula);
 }
@@ -98,10 +146,145 @@ bool EagerBitblastSolver::checkSat() {
     Node query = utils::mkAnd(assertions); 
     return d_aigBitblaster->solve(query);
   }
+
+  if (d_useNativeAig) {
+    return d_nativeAigBitblaster->solve();
+  }
+
+  if (d_useCones) {
+    if (d_numPartitioned != assertions.size()) {
+      partition(assertions);
+    }
+    // the groups share no symbols, so the assertions are satisfiable iff
+    // every group is, and the groups after an unsatisfiable one need not be
+    // bit-blasted at all
+    for (unsigned i = 0; i < d_cones.size(); ++i) {
+      if (!d_coneBitblasted[i]) {
+        for (unsigned j = 0; j < d_coneAssertions[i].size(); ++j) {
+          d_cones[i]->bbFormula(d_coneAssertions[i][j]);
+        }
+        d_coneBitblasted[i] = true;
+      }
+      if (!d_cones[i]->solve()) {
+        Debug("bitvector-eager") << "EagerBitblastSolver::checkSat group " << i
+                                 << " of " << d_cones.size() << " is unsat\n";
+        for (unsigned j = i + 1; j < d_cones.size(); ++j) {
+          if (!d_coneBitblasted[j]) {
+            ++(d_statistics.d_numGroupsSkipped);
+          }
+        }
+        return false;
+      }
+    }
+    return true;
+  }
   
   return d_bitblaster->solve(); 
 }
 
+void EagerBitblastSolver::partition(const std::vector<TNode>& assertions) {
+  if (!d_cones.empty()) {
+    // new assertions may connect the old groups, start over
+    for (unsigned i = 0; i < d_cones.size(); ++i) {
+      delete d_cones[i];
+    }
+    d_cones.clear();
+    d_bitblaster = new EagerBitblaster(d_bv);
+  }
+  d_coneAssertions.clear();
+  d_coneBitblasted.clear();
+  d_numPartitioned = assertions.size();
+
+  // union-find over the assertions, two assertions are in the same cone iff
+  // they are connected through shared non-constant subterms
+  std::vector<unsigned> parent(assertions.size());
+  std::vector<unsigned> weight(assertions.size(), 0);
+  for (unsigned i = 0; i < assertions.size(); ++i) {
+    parent[i] = i;
+  }
+  __gnu_cxx::hash_map<TNode, unsigned, TNodeHashFunction> owner;
+  std::vector<TNode> stack;
+  for (unsigned i = 0; i < assertions.size(); ++i) {
+    stack.push_back(assertions[i]);
+    while (!stack.empty()) {
+      TNode current = stack.back();
+      stack.pop_back();
+      if (current.isConst()) {
+        continue;
+      }
+      __gnu_cxx::hash_map<TNode, unsigned, TNodeHashFunction>::iterator it =
+          owner.find(current);
+      if (it != owner.end()) {
+        parent[findRoot(parent, it->second)] = findRoot(parent, i);
+        continue;
+      }
+      owner[current] = i;
+      ++weight[i];
+      if (current.getKind() == kind::APPLY_UF) {
+        stack.push_back(current.getOperator());
+      }
+      for (unsigned j = 0; j < current.getNumChildren(); ++j) {
+        stack.push_back(current[j]);
+      }
+    }
+  }
+
+  // collect the cones with their size in nodes
+  std::vector<unsigned> coneOf(assertions.size());
+  std::vector< std::pair<unsigned, unsigned> > cones;
+  __gnu_cxx::hash_map<unsigned, unsigned> coneIndex;
+  for (unsigned i = 0; i < assertions.size(); ++i) {
+    unsigned root = findRoot(parent, i);
+    if (coneIndex.find(root) == coneIndex.end()) {
+      coneIndex[root] = cones.size();
+      cones.push_back(std::make_pair(0, cones.size()));
+    }
+    coneOf[i] = coneIndex[root];
+    cones[coneOf[i]].first += weight[i];
+  }
+  d_statistics.d_numCones += cones.size();
+
+  // assign the largest cones first, each to the currently smallest group
+  unsigned numGroups = std::min<unsigned>(options::bitvectorEagerCones(),
+                                          cones.size());
+  std::sort(cones.begin(), cones.end());
+  std::vector<unsigned> groupOfCone(cones.size());
+  std::vector<unsigned> groupWeight(numGroups, 0);
+  for (unsigned k = cones.size(); k-- > 0;) {
+    unsigned g = std::min_element(groupWeight.begin(), groupWeight.end()) -
+                 groupWeight.begin();
+    groupWeight[g] += cones[k].first;
+    groupOfCone[cones[k].second] = g;
+  }
+
+  // solve the smaller groups first, they are the cheapest way to find an
+  // unsatisfiable one
+  std::vector< std::pair<unsigned, unsigned> > groups;
+  for (unsigned g = 0; g < numGroups; ++g) {
+    groups.push_back(std::make_pair(groupWeight[g], g));
+  }
+  std::sort(groups.begin(), groups.end());
+  std::vector<unsigned> position(numGroups);
+  for (unsigned g = 0; g < numGroups; ++g) {
+    position[groups[g].second] = g;
+  }
+
+  d_coneAssertions.resize(numGroups);
+  d_coneBitblasted.resize(numGroups, false);
+  for (unsigned i = 0; i < assertions.size(); ++i) {
+    d_coneAssertions[position[groupOfCone[coneOf[i]]]].push_back(assertions[i]);
+  }
+  d_cones.push_back(d_bitblaster);
+  for (unsigned g = 1; g < numGroups; ++g) {
+    std::stringstream name;
+    name << "EagerBitblaster" << g;
+    d_cones.push_back(new EagerBitblaster(d_bv, name.str()));
+  }
+  d_statistics.d_numGroups += numGroups;
+  Debug("bitvector-eager") << "EagerBitblastSolver::partition " << cones.size()
+                           << " cones into " << numGroups << " groups\n";
+}
+
 bool EagerBitblastSolver::hasAssertions(const std::vector<TNode> &formulas) {
   Assert (isInitialized());
   if (formulas.size() != d_assertionSet.size())
@@ -115,11 +298,45 @@ bool EagerBitblastSolver::hasAssertions(const std::vector<TNode> &formulas) {
   return true; 
 }
 
+void EagerBitblastSolver::getAssertedAtoms(std::vector<Node>& atoms) {
+  NodeManager* nm = NodeManager::currentNM();
+  for (AssertionSet::const_iterator it = d_assertionSet.begin(); it != d_assertionSet.end(); ++it) {
+    atoms.push_back(nm->mkNode(kind::BITVECTOR_EAGER_ATOM, *it));
+  }
+}
+
 void EagerBitblastSolver::collectModelInfo(TheoryModel* m, bool fullModel) {
-  AlwaysAssert(!d_useAig && d_bitblaster);
+  AlwaysAssert(!d_useAig);
+  if (d_useNativeAig) {
+    d_nativeAigBitblaster->collectModelInfo(m, fullModel);
+    return;
+  }
+  AlwaysAssert(d_bitblaster);
+  if (d_useCones && !d_cones.empty()) {
+    for (unsigned i = 0; i < d_cones.size(); ++i) {
+      d_cones[i]->collectModelInfo(m, fullModel);
+    }
+    return;
+  }
   d_bitblaster->collectModelInfo(m, fullModel); 
 }
 
 void EagerBitblastSolver::setProofLog( BitVectorProof * bvp ) {
   d_bvp = bvp;
 }
+
+EagerBitblastSolver::Statistics::Statistics()
+  : d_numCones("theory::bv::EagerBitblastSolver::NumberOfCones", 0)
+  , d_numGroups("theory::bv::EagerBitblastSolver::NumberOfGroups", 0)
+  , d_numGroupsSkipped("theory::bv::EagerBitblastSolver::NumberOfGroupsSkipped", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numCones);
+  smtStatisticsRegistry()->registerStat(&d_numGroups);
+  smtStatisticsRegistry()->registerStat(&d_numGroupsSkipped);
+}
+
+EagerBitblastSolver::Statistics::~Statistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_numCones);
+  smtStatisticsRegistry()->unregisterStat(&d_numGroups);
+  smtStatisticsRegistry()->unregisterStat(&d_numGroupsSkipped);
+}
@@ -17,7 +17,9 @@
 #include "cvc4_private.h"
 #include "expr/node.h"
 #include "theory/theory_model.h"
+#include "context/cdhashset.h"
 #include "theory/bv/theory_bv.h"
+#include "util/statistics_registry.h"
 #include <vector>
 #pragma once
 
@@ -28,21 +30,48 @@ namespace bv {
 
 class EagerBitblaster;
 class AigBitblaster;
+class NativeAigBitblaster;
 
 /**
  * BitblastSolver
  */
 class EagerBitblastSolver {
-  typedef __gnu_cxx::hash_set<TNode, TNodeHashFunction> AssertionSet;
+  typedef context::CDHashSet<Node, NodeHashFunction> AssertionSet;
+  /** The formulas asserted in the current user context */
   AssertionSet d_assertionSet;
   /** Bitblasters */
   EagerBitblaster* d_bitblaster;
   AigBitblaster* d_aigBitblaster;
+  NativeAigBitblaster* d_nativeAigBitblaster;
   bool d_useAig;
+  bool d_useNativeAig;
 
   TheoryBV* d_bv; 
   BitVectorProof * d_bvp;
 
+  /** Whether the assertions are split into groups (--bv-eager-cones) */
+  bool d_useCones;
+  /** The bit-blaster of each group, d_cones[0] is d_bitblaster */
+  std::vector<EagerBitblaster*> d_cones;
+  /** The assertions of each group, no two groups share a symbol */
+  std::vector< std::vector<Node> > d_coneAssertions;
+  /** Whether the assertions of each group have been bit-blasted */
+  std::vector<bool> d_coneBitblasted;
+  /** The number of assertions the groups were computed for */
+  unsigned d_numPartitioned;
+
+  /** Splits the assertions into groups that share no symbols */
+  void partition(const std::vector<TNode>& assertions);
+
+  struct Statistics {
+    IntStat d_numCones;
+    IntStat d_numGroups;
+    IntStat d_numGroupsSkipped;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+
 public:
   EagerBitblastSolver(theory::bv::TheoryBV* bv);
   ~EagerBitblastSolver();
@@ -50,6 +79,9 @@ public:
   void assertFormula(TNode formula);
   // purely for debugging purposes
   bool hasAssertions(const std::vector<TNode> &formulas);
+  /** The eager atoms of all the formulas asserted in the current user
+   * context, which may span several check-sat calls in incremental mode */
+  void getAssertedAtoms(std::vector<Node>& atoms);
 
   void turnOffAig();
   bool isInitialized();
@@ -16,6 +16,8 @@
 
 #include "theory/bv/bv_quick_check.h"
 
+#include <algorithm>
+
 #include "smt/smt_statistics_registry.h"
 #include "theory/bv/bitblaster_template.h"
 #include "theory/bv/theory_bv_utils.h"
@@ -148,12 +150,14 @@ BVQuickCheck::~BVQuickCheck() {
 QuickXPlain::QuickXPlain(const std::string& name, BVQuickCheck* solver, unsigned long budget)
   : d_solver(solver)
   , d_budget(budget)
+  , d_maxBudget(budget)
   , d_numCalled(0)
   , d_minRatioSum(0)
   , d_numConflicts(0)
-  // , d_period(20)
-  // , d_thresh(0.7)
-  // , d_hardThresh(0.9)
+  , d_period(1)
+  , d_thresh(0.7)
+  , d_hardThresh(0.9)
+  , d_minimized()
   , d_statistics(name)
 {}
 QuickXPlain::~QuickXPlain() {}
@@ -164,9 +168,16 @@ unsigned QuickXPlain::selectUnsatCore(unsigned low, unsigned high,
   Assert(!d_solver->getConflict().isNull() &&
          d_solver->inConflict());
   Node query_confl = d_solver->getConflict();
+  // a core with a single literal is not a conjunction
+  std::vector<TNode> core;
+  if (query_confl.getKind() == kind::AND) {
+    core.insert(core.end(), query_confl.begin(), query_confl.end());
+  } else if (query_confl != utils::mkTrue()) {
+    core.push_back(query_confl);
+  }
 
   // conflict wasn't actually minimized
-  if (query_confl.getNumChildren() == high - low + 1) {
+  if (core.size() == high - low + 1) {
     return high;
   }
 
@@ -176,8 +187,8 @@ unsigned QuickXPlain::selectUnsatCore(unsigned low, unsigned high,
   }
   
   unsigned write = low;
-  for (unsigned i = 0; i < query_confl.getNumChildren(); ++i) {
-    TNode current = query_confl[i];
+  for (unsigned i = 0; i < core.size(); ++i) {
+    TNode current = core[i];
     // the conflict can have nodes in lower decision levels
     if (nodes.find(current) != nodes.end()) {
       conflict[write++] = current;
@@ -288,33 +299,63 @@ void QuickXPlain::minimizeConflictInternal(unsigned low, unsigned high,
 }
 
 
-bool QuickXPlain::useHeuristic() {
-  return true; 
-  // d_statistics.d_finalPeriod.setData(d_period);
-  // // try to minimize conflict periodically 
-  // if (d_numConflicts % d_period == 0)
-  //   return true;
-
-  // if (d_numCalled == 0) {
-  //   return true;
-  // }
-  
-  // if (d_minRatioSum / d_numCalled >= d_thresh &&
-  //     d_numCalled <= 20 ) {
-  //   return false;
-  // }
+bool QuickXPlain::shrinkToUnsatCore(std::vector<TNode>& conflict, unsigned& size) {
+  while (size > 1) {
+    std::vector<Node> assumptions(conflict.begin(), conflict.begin() + size);
+    d_solver->push();
+    SatValue res = d_solver->checkSat(assumptions, d_budget);
+    ++(d_statistics.d_numCoreRounds);
 
-  // if (d_minRatioSum / d_numCalled >= d_hardThresh) {
-  //   return false;
-  // }
+    if (res != SAT_VALUE_FALSE) {
+      // the conflict is valid, so we only get here if we ran out of budget
+      Assert (res == SAT_VALUE_UNKNOWN);
+      ++(d_statistics.d_numUnknown);
+      d_solver->pop();
+      return false;
+    }
+    ++(d_statistics.d_numSolved);
+    unsigned new_size = selectUnsatCore(0, size - 1, conflict) + 1;
+    d_solver->pop();
+    if (new_size == size) {
+      break;
+    }
+    size = new_size;
+  }
+  return true;
+}
 
-  // return true;
+bool QuickXPlain::useHeuristic() {
+  d_statistics.d_finalPeriod.setData(d_period);
+  // try to minimize conflict periodically
+  return d_numConflicts % d_period == 0;
+}
+
+void QuickXPlain::updateHeuristic(double minimization_ratio) {
+  static const unsigned long minBudget = 100;
+  static const unsigned maxPeriod = 64;
+
+  if (minimization_ratio >= d_hardThresh) {
+    // not worth it, minimize less often and spend less when we do
+    d_period = std::min(d_period * 2, maxPeriod);
+    d_budget = std::max(d_budget / 2, std::min(minBudget, d_maxBudget));
+  } else if (minimization_ratio <= d_thresh) {
+    d_period = std::max(d_period / 2, 1u);
+    d_budget = std::min(d_budget * 2, d_maxBudget);
+  }
+  d_statistics.d_finalBudget.setData(d_budget);
 }
 
 Node QuickXPlain::minimizeConflict(TNode confl) {
   ++d_numConflicts;
 
+  ConflictCache::const_iterator it = d_minimized.find(confl);
+  if (it != d_minimized.end()) {
+    ++(d_statistics.d_numCacheHits);
+    return it->second;
+  }
+
   if (!useHeuristic()) {
+    ++(d_statistics.d_numSkipped);
     return confl;
   }
 
@@ -327,26 +368,28 @@ Node QuickXPlain::minimizeConflict(TNode confl) {
     conflict.push_back(confl[i]);
   }
   d_solver->popToZero();
+
+  // the cores of solving with assumptions usually remove most of the
+  // literals with a few SAT calls, the divide and conquer search then
+  // only has to go over what is left
+  unsigned size = conflict.size();
   std::vector<TNode> minimized;
-  minimizeConflictInternal(0, conflict.size() - 1, conflict, minimized);
+  if (!shrinkToUnsatCore(conflict, size) || size <= 2) {
+    // small enough, or out of budget: conflict[0..size) is the last core
+    // found, which is still a conflict
+    minimized.assign(conflict.begin(), conflict.begin() + size);
+  } else {
+    minimizeConflictInternal(0, size - 1, conflict, minimized);
+  }
 
   double minimization_ratio = ((double) minimized.size())/confl.getNumChildren();
   d_minRatioSum+= minimization_ratio;
-  
-
-  // if (minimization_ratio >= d_hardThresh) {
-  //   d_period = d_period * 5; 
-  // }
-
-  // if (minimization_ratio <= d_thresh && d_period >= 40) {
-  //   d_period = d_period *0.5; 
-  // }
-
-  // if (1.5* d_statistics.d_numUnknown.getData() > d_statistics.d_numSolved.getData()) {
-  //   d_period = d_period * 2;
-  // }
+  updateHeuristic(minimization_ratio);
   d_statistics.d_avgMinimizationRatio.addEntry(minimization_ratio);
-  return utils::mkAnd(minimized); 
+
+  Node result = utils::mkAnd(minimized);
+  d_minimized[confl] = result;
+  return result;
 }
 
 QuickXPlain::Statistics::Statistics(const std::string& name)
@@ -356,6 +399,10 @@ QuickXPlain::Statistics::Statistics(const std::string& name)
   , d_numUnknownWasUnsat("theory::bv::"+name+"::QuickXplain::NumUnknownWasUnsat", 0)
   , d_numConflictsMinimized("theory::bv::"+name+"::QuickXplain::NumConflictsMinimized", 0)
   , d_finalPeriod("theory::bv::"+name+"::QuickXplain::FinalPeriod", 0)
+  , d_finalBudget("theory::bv::"+name+"::QuickXplain::FinalBudget", 0)
+  , d_numSkipped("theory::bv::"+name+"::QuickXplain::NumSkipped", 0)
+  , d_numCacheHits("theory::bv::"+name+"::QuickXplain::NumCacheHits", 0)
+  , d_numCoreRounds("theory::bv::"+name+"::QuickXplain::NumCoreRounds", 0)
   , d_avgMinimizationRatio("theory::bv::"+name+"::QuickXplain::AvgMinRatio")
 {
   smtStatisticsRegistry()->registerStat(&d_xplainTime);
@@ -364,6 +411,10 @@ QuickXPlain::Statistics::Statistics(const std::string& name)
   smtStatisticsRegistry()->registerStat(&d_numUnknownWasUnsat);
   smtStatisticsRegistry()->registerStat(&d_numConflictsMinimized);
   smtStatisticsRegistry()->registerStat(&d_finalPeriod);
+  smtStatisticsRegistry()->registerStat(&d_finalBudget);
+  smtStatisticsRegistry()->registerStat(&d_numSkipped);
+  smtStatisticsRegistry()->registerStat(&d_numCacheHits);
+  smtStatisticsRegistry()->registerStat(&d_numCoreRounds);
   smtStatisticsRegistry()->registerStat(&d_avgMinimizationRatio);
 }
 
@@ -374,5 +425,9 @@ QuickXPlain::Statistics::~Statistics() {
   smtStatisticsRegistry()->unregisterStat(&d_numUnknownWasUnsat);
   smtStatisticsRegistry()->unregisterStat(&d_numConflictsMinimized);
   smtStatisticsRegistry()->unregisterStat(&d_finalPeriod);
+  smtStatisticsRegistry()->unregisterStat(&d_finalBudget);
+  smtStatisticsRegistry()->unregisterStat(&d_numSkipped);
+  smtStatisticsRegistry()->unregisterStat(&d_numCacheHits);
+  smtStatisticsRegistry()->unregisterStat(&d_numCoreRounds);
   smtStatisticsRegistry()->unregisterStat(&d_avgMinimizationRatio);  
 }
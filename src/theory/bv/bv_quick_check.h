@@ -116,24 +116,50 @@ class QuickXPlain {
     IntStat d_numUnknownWasUnsat;
     IntStat d_numConflictsMinimized;
     IntStat d_finalPeriod;
+    IntStat d_finalBudget;
+    IntStat d_numSkipped;
+    IntStat d_numCacheHits;
+    IntStat d_numCoreRounds;
     AverageStat d_avgMinimizationRatio;
     Statistics(const std::string&);
     ~Statistics();
   };
+  typedef __gnu_cxx::hash_map<Node, Node, NodeHashFunction> ConflictCache;
+
   BVQuickCheck* d_solver;
-  unsigned long d_budget;
+  unsigned long d_budget; // current budget per SAT call, adapted to the minimization ratio
+  unsigned long d_maxBudget;
 
   // crazy heuristic variables
   unsigned d_numCalled; // number of times called
   double d_minRatioSum; // sum of minimization ratio for computing average min ratio  
   unsigned d_numConflicts; // number of conflicts (including when minimization not applied)
-  // unsigned d_period; // after how many conflicts to try minimizing again
+  unsigned d_period; // after how many conflicts to try minimizing again
 
-  // double d_thresh; // if minimization ratio is less, increase period
-  // double d_hardThresh; // decrease period if minimization ratio is greater than this
-  
+  double d_thresh; // if minimization ratio is less, decrease period and raise budget
+  double d_hardThresh; // increase period and lower budget if minimization ratio is greater than this
+
+  /** conflicts already minimized, they stay valid as the bit-blasting is not context dependent */
+  ConflictCache d_minimized;
   
   Statistics d_statistics;
+  /** 
+   * Repeatedly solves with all the literals in conflict[0..size) as
+   * assumptions and keeps the ones in the unsat core, until the core
+   * stops shrinking. 
+   * 
+   * @param conflict 
+   * @param size number of literals in the conflict, updated to the size of the core
+   * 
+   * @return false if the literals could not be shown unsat within the budget,
+   * conflict[0..size) is then the last core found, which is still a conflict
+   */
+  bool shrinkToUnsatCore(std::vector<TNode>& conflict, unsigned& size);
+  /** 
+   * Adapts the minimization period and budget to the minimization ratio
+   * of the last conflict.
+   */
+  void updateHeuristic(double minimization_ratio);
   /** 
    * Uses solve with assumptions unsat core feature to
    * further minimize a conflict. The minimized conflict
@@ -34,7 +34,8 @@ enum SubTheory {
   SUB_CORE = 1,
   SUB_BITBLAST = 2,
   SUB_INEQUALITY = 3,
-  SUB_ALGEBRAIC = 4
+  SUB_ALGEBRAIC = 4,
+  SUB_PROPAGATION = 5
 };
 
 inline std::ostream& operator << (std::ostream& out, SubTheory subtheory) {
@@ -47,8 +48,13 @@ inline std::ostream& operator << (std::ostream& out, SubTheory subtheory) {
     break;
   case SUB_INEQUALITY:
     out << "BV_INEQUALITY_SUBTHEORY";
+    break;
   case SUB_ALGEBRAIC:
     out << "BV_ALGEBRAIC_SUBTHEORY";
+    break;
+  case SUB_PROPAGATION:
+    out << "BV_PROPAGATION_SUBTHEORY";
+    break;
   default:
     Unreachable();
     break;
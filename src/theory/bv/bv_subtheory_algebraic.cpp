@@ -206,7 +206,7 @@ AlgebraicSolver::AlgebraicSolver(context::Context* c, TheoryBV* bv)
   , d_numSolved(0)
   , d_numCalls(0)
   , d_ctx(new context::Context())
-  , d_quickXplain(options::bitvectorQuickXplain() ? new QuickXPlain("alg", d_quickSolver) : NULL)
+  , d_quickXplain(options::bitvectorQuickXplain() ? new QuickXPlain("alg", d_quickSolver, options::bitvectorQuickXplainBudget()) : NULL)
   , d_statistics()
 {}
 
@@ -812,10 +812,9 @@ void ExtractSkolemizer::skolemize(std::vector<WorklistElement>& facts) {
     unsigned bw = utils::getSize(var);
     // compute decomposition
     std::vector<unsigned> cuts;
-    for (unsigned i = 1; i <= bw; ++i) {
-      if (base.isCutPoint(i)) {
-        cuts.push_back(i);
-      }
+    for (unsigned i = base.nextCutPoint(0); ; i = base.nextCutPoint(i)) {
+      cuts.push_back(i);
+      if (i == bw) break;
     }
     unsigned previous = 0;
     unsigned current = 0;
@@ -45,7 +45,7 @@ BitblastSolver::BitblastSolver(context::Context* c, TheoryBV* bv)
     d_useSatPropagation(options::bitvectorPropagate()),
     d_abstractionModule(NULL),
     d_quickCheck(options::bitvectorQuickXplain() ? new BVQuickCheck("bb", bv) : NULL),
-    d_quickXplain(options::bitvectorQuickXplain() ? new QuickXPlain("bb", d_quickCheck) :  NULL)
+    d_quickXplain(options::bitvectorQuickXplain() ? new QuickXPlain("bb", d_quickCheck, options::bitvectorQuickXplainBudget()) :  NULL)
 {
 }
 
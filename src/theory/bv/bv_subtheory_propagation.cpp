@@ -0,0 +1,1051 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Word-level propagation solver.
+ **
+ ** Word-level propagation solver.
+ **/
+
+#include "theory/bv/bv_subtheory_propagation.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "options/bv_options.h"
+#include "options/smt_options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/bv/theory_bv.h"
+#include "theory/bv/theory_bv_utils.h"
+#include "theory/rewriter.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::bv;
+
+typedef PropagationSolver::Domain Domain;
+
+namespace {
+
+BitVector mkZeroBV(unsigned width) { return BitVector(width); }
+BitVector mkOnesBV(unsigned width) { return ~BitVector(width); }
+
+bool isZero(const BitVector& x) { return x == mkZeroBV(x.getSize()); }
+
+/** The bit-vector of the given width with the low k bits set */
+BitVector lowBits(unsigned width, unsigned k) {
+  if (k >= width) {
+    return mkOnesBV(width);
+  }
+  return BitVector(width, Integer(1).multiplyByPow2(k) - 1);
+}
+
+/** x shifted left by low into a bit-vector of the given width */
+BitVector place(const BitVector& x, unsigned width, unsigned low) {
+  return BitVector(width, x.toInteger().multiplyByPow2(low));
+}
+
+const BitVector& minBV(const BitVector& a, const BitVector& b) {
+  return b < a ? b : a;
+}
+
+const BitVector& maxBV(const BitVector& a, const BitVector& b) {
+  return a < b ? b : a;
+}
+
+/** Number of consecutive known bits starting at bit 0 */
+unsigned trailingKnown(const Domain& d) {
+  unsigned i = 0;
+  while (i < d.d_mask.getSize() && d.d_mask.isBitSet(i)) {
+    ++i;
+  }
+  return i;
+}
+
+/** Number of consecutive bits known to be 0 starting at bit 0 */
+unsigned trailingZeros(const Domain& d) {
+  unsigned i = 0;
+  while (i < d.d_mask.getSize() && d.d_mask.isBitSet(i) && !d.d_bits.isBitSet(i)) {
+    ++i;
+  }
+  return i;
+}
+
+BitVector knownZeros(const Domain& d) { return d.d_mask & ~d.d_bits; }
+
+void mergeReasons(std::vector<Node>& reasons, const std::vector<Node>& other) {
+  if (other.empty()) {
+    return;
+  }
+  std::vector<Node> merged;
+  merged.reserve(reasons.size() + other.size());
+  std::set_union(reasons.begin(), reasons.end(), other.begin(), other.end(),
+                 std::back_inserter(merged));
+  reasons.swap(merged);
+}
+
+void addReason(std::vector<Node>& reasons, TNode literal) {
+  std::vector<Node>::iterator it =
+      std::lower_bound(reasons.begin(), reasons.end(), literal);
+  if (it == reasons.end() || *it != literal) {
+    reasons.insert(it, literal);
+  }
+}
+
+/**
+ * Makes the known bits and the interval of d agree with each other: the
+ * interval is shrunk to the values the known bits allow and the bits shared
+ * by all values of the interval become known. Returns false if d is empty.
+ */
+bool normalize(Domain& d) {
+  unsigned width = d.d_lo.getSize();
+  while (true) {
+    BitVector smallest = d.d_bits;
+    BitVector largest = d.d_bits | ~d.d_mask;
+    if (d.d_lo < smallest) {
+      d.d_lo = smallest;
+    }
+    if (largest < d.d_hi) {
+      d.d_hi = largest;
+    }
+    if (d.d_hi < d.d_lo) {
+      return false;
+    }
+    // all values in [lo, hi] agree on the bits above the highest bit where
+    // lo and hi differ
+    BitVector diff = d.d_lo ^ d.d_hi;
+    unsigned free = isZero(diff) ? 0 : diff.toInteger().length();
+    BitVector prefix = ~lowBits(width, free);
+    if (!isZero(prefix & d.d_mask & (d.d_lo ^ d.d_bits))) {
+      return false;
+    }
+    BitVector mask = d.d_mask | prefix;
+    if (mask == d.d_mask) {
+      return true;
+    }
+    d.d_mask = mask;
+    d.d_bits = d.d_bits | (d.d_lo & prefix);
+  }
+}
+
+/** Intersects d with other, returns false if the result is empty */
+bool meet(Domain& d, const Domain& other) {
+  if (!isZero(d.d_mask & other.d_mask & (d.d_bits ^ other.d_bits))) {
+    return false;
+  }
+  d.d_mask = d.d_mask | other.d_mask;
+  d.d_bits = d.d_bits | other.d_bits;
+  d.d_lo = maxBV(d.d_lo, other.d_lo);
+  d.d_hi = minBV(d.d_hi, other.d_hi);
+  return normalize(d);
+}
+
+/** Returns true if no value is in both a and b */
+bool disjoint(const Domain& a, const Domain& b) {
+  return !isZero(a.d_mask & b.d_mask & (a.d_bits ^ b.d_bits)) ||
+         a.d_hi < b.d_lo || b.d_hi < a.d_lo;
+}
+
+/** The smallest domain containing both a and b */
+Domain join(const Domain& a, const Domain& b) {
+  Domain r(a.d_lo.getSize());
+  r.d_mask = a.d_mask & b.d_mask & ~(a.d_bits ^ b.d_bits);
+  r.d_bits = a.d_bits & r.d_mask;
+  r.d_lo = minBV(a.d_lo, b.d_lo);
+  r.d_hi = maxBV(a.d_hi, b.d_hi);
+  return r;
+}
+
+Domain andDomain(const Domain& a, const Domain& b) {
+  Domain r(a.d_lo.getSize());
+  r.d_bits = a.d_bits & b.d_bits;
+  r.d_mask = knownZeros(a) | knownZeros(b) | r.d_bits;
+  r.d_hi = minBV(a.d_hi, b.d_hi);
+  return r;
+}
+
+Domain orDomain(const Domain& a, const Domain& b) {
+  Domain r(a.d_lo.getSize());
+  r.d_bits = a.d_bits | b.d_bits;
+  r.d_mask = (knownZeros(a) & knownZeros(b)) | r.d_bits;
+  r.d_lo = maxBV(a.d_lo, b.d_lo);
+  return r;
+}
+
+Domain xorDomain(const Domain& a, const Domain& b) {
+  Domain r(a.d_lo.getSize());
+  r.d_mask = a.d_mask & b.d_mask;
+  r.d_bits = (a.d_bits ^ b.d_bits) & r.d_mask;
+  return r;
+}
+
+Domain plusDomain(const Domain& a, const Domain& b) {
+  unsigned width = a.d_lo.getSize();
+  Domain r(width);
+  // the low bits of the sum only depend on the low bits of the summands
+  r.d_mask = lowBits(width, std::min(trailingKnown(a), trailingKnown(b)));
+  r.d_bits = (a.d_bits + b.d_bits) & r.d_mask;
+  // if either no or every sum overflows the interval does not wrap around
+  Integer modulus = Integer(1).multiplyByPow2(width);
+  Integer lo = a.d_lo.toInteger() + b.d_lo.toInteger();
+  Integer hi = a.d_hi.toInteger() + b.d_hi.toInteger();
+  if (hi < modulus || lo >= modulus) {
+    r.d_lo = BitVector(width, lo);
+    r.d_hi = BitVector(width, hi);
+  }
+  return r;
+}
+
+Domain subDomain(const Domain& a, const Domain& b) {
+  unsigned width = a.d_lo.getSize();
+  Domain r(width);
+  r.d_mask = lowBits(width, std::min(trailingKnown(a), trailingKnown(b)));
+  r.d_bits = (a.d_bits - b.d_bits) & r.d_mask;
+  if (b.d_hi <= a.d_lo || a.d_hi < b.d_lo) {
+    r.d_lo = a.d_lo - b.d_hi;
+    r.d_hi = a.d_hi - b.d_lo;
+  }
+  return r;
+}
+
+Domain multDomain(const Domain& a, const Domain& b) {
+  unsigned width = a.d_lo.getSize();
+  Domain r(width);
+  unsigned zeros = trailingZeros(a) + trailingZeros(b);
+  unsigned known = std::min(trailingKnown(a), trailingKnown(b));
+  if (zeros >= known) {
+    r.d_mask = lowBits(width, zeros);
+  } else {
+    r.d_mask = lowBits(width, known);
+    r.d_bits = (a.d_bits * b.d_bits) & r.d_mask;
+  }
+  Integer modulus = Integer(1).multiplyByPow2(width);
+  Integer hi = a.d_hi.toInteger() * b.d_hi.toInteger();
+  if (hi < modulus) {
+    r.d_lo = BitVector(width, a.d_lo.toInteger() * b.d_lo.toInteger());
+    r.d_hi = BitVector(width, hi);
+  }
+  return r;
+}
+
+}/* anonymous namespace */
+
+PropagationSolver::Domain::Domain(unsigned width)
+  : d_mask(width)
+  , d_bits(width)
+  , d_lo(width)
+  , d_hi(mkOnesBV(width))
+  , d_reasons()
+{}
+
+Domain PropagationSolver::Domain::exact(const BitVector& value) {
+  Domain d(value.getSize());
+  d.d_mask = mkOnesBV(value.getSize());
+  d.d_bits = value;
+  d.d_lo = value;
+  d.d_hi = value;
+  return d;
+}
+
+bool PropagationSolver::Domain::isTop() const {
+  return isZero(d_mask) && isZero(d_lo) && d_hi == mkOnesBV(d_hi.getSize());
+}
+
+PropagationSolver::PropagationSolver(context::Context* c, TheoryBV* bv)
+  : SubtheorySolver(c, bv)
+  , d_domains(c)
+  , d_assertedLiterals(c)
+  , d_explanations(c)
+  , d_registered()
+  , d_parents()
+  , d_atoms()
+  , d_queue()
+  , d_inQueue()
+  , d_touched()
+  , d_numUpdates(0)
+  , d_conflict()
+  , d_statistics()
+{}
+
+PropagationSolver::~PropagationSolver() {}
+
+void PropagationSolver::preRegister(TNode node) {
+  Kind kind = node.getKind();
+  if ((kind == kind::EQUAL && node[0].getType().isBitVector()) ||
+      kind == kind::BITVECTOR_ULT ||
+      kind == kind::BITVECTOR_ULE) {
+    if (d_registered.find(node) != d_registered.end()) {
+      return;
+    }
+    d_registered.insert(node);
+    for (unsigned i = 0; i < 2; ++i) {
+      registerTerm(node[i]);
+      d_atoms[node[i]].push_back(node);
+    }
+  } else if (node.getType().isBitVector()) {
+    registerTerm(node);
+  }
+}
+
+void PropagationSolver::registerTerm(TNode term) {
+  std::vector<TNode> toVisit;
+  toVisit.push_back(term);
+  while (!toVisit.empty()) {
+    TNode current = toVisit.back();
+    toVisit.pop_back();
+    if (d_registered.find(current) != d_registered.end()) {
+      continue;
+    }
+    d_registered.insert(current);
+    for (unsigned i = 0; i < current.getNumChildren(); ++i) {
+      TNode child = current[i];
+      if (child.getType().isBitVector()) {
+        d_parents[child].push_back(current);
+        toVisit.push_back(child);
+      }
+    }
+  }
+}
+
+Domain PropagationSolver::getDomain(TNode term) {
+  if (term.getKind() == kind::CONST_BITVECTOR) {
+    return Domain::exact(term.getConst<BitVector>());
+  }
+  DomainMap::const_iterator it = d_domains.find(term);
+  if (it != d_domains.end()) {
+    return (*it).second;
+  }
+  if (term.getNumChildren() == 0 ||
+      d_registered.find(term) == d_registered.end()) {
+    return Domain(utils::getSize(term));
+  }
+
+  // compute the missing domains of the subterms bottom-up
+  std::vector<TNode> toVisit;
+  toVisit.push_back(term);
+  while (!toVisit.empty()) {
+    TNode current = toVisit.back();
+    bool childrenDone = true;
+    for (unsigned i = 0; i < current.getNumChildren(); ++i) {
+      TNode child = current[i];
+      if (child.getNumChildren() > 0 &&
+          child.getType().isBitVector() &&
+          d_domains.find(child) == d_domains.end()) {
+        toVisit.push_back(child);
+        childrenDone = false;
+      }
+    }
+    if (!childrenDone) {
+      continue;
+    }
+    toVisit.pop_back();
+    if (d_domains.find(current) != d_domains.end()) {
+      continue;
+    }
+    Domain d(utils::getSize(current));
+    if (!computeFromChildren(current, d)) {
+      // the children are consistent so this cannot happen, but forgetting
+      // about the term is always sound
+      d = Domain(utils::getSize(current));
+    }
+    d_domains.insert(current, d);
+  }
+  return (*d_domains.find(term)).second;
+}
+
+bool PropagationSolver::computeFromChildren(TNode term, Domain& result) {
+  unsigned width = utils::getSize(term);
+  Kind kind = term.getKind();
+
+  std::vector<Domain> children;
+  std::vector<Node> reasons;
+  bool allExact = true;
+  for (unsigned i = 0; i < term.getNumChildren(); ++i) {
+    if (!term[i].getType().isBitVector()) {
+      allExact = false;
+      continue;
+    }
+    children.push_back(getDomain(term[i]));
+    mergeReasons(reasons, children.back().d_reasons);
+    allExact = allExact && children.back().isExact();
+  }
+
+  Domain r(width);
+  if (allExact && !children.empty()) {
+    // every operator can be evaluated on constants
+    NodeBuilder<> nb(kind);
+    if (term.getMetaKind() == kind::metakind::PARAMETERIZED) {
+      nb << term.getOperator();
+    }
+    for (unsigned i = 0; i < children.size(); ++i) {
+      nb << utils::mkConst(children[i].d_lo);
+    }
+    Node value = Rewriter::rewrite(Node(nb));
+    if (value.getKind() == kind::CONST_BITVECTOR) {
+      r = Domain::exact(value.getConst<BitVector>());
+      r.d_reasons.swap(reasons);
+      result = r;
+      return true;
+    }
+  }
+
+  switch (kind) {
+  case kind::BITVECTOR_NOT:
+    r.d_mask = children[0].d_mask;
+    r.d_bits = ~children[0].d_bits & r.d_mask;
+    r.d_lo = ~children[0].d_hi;
+    r.d_hi = ~children[0].d_lo;
+    break;
+  case kind::BITVECTOR_AND:
+    r = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      r = andDomain(r, children[i]);
+    }
+    break;
+  case kind::BITVECTOR_OR:
+    r = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      r = orDomain(r, children[i]);
+    }
+    break;
+  case kind::BITVECTOR_XOR:
+    r = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      r = xorDomain(r, children[i]);
+    }
+    break;
+  case kind::BITVECTOR_PLUS:
+    r = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      r = plusDomain(r, children[i]);
+    }
+    break;
+  case kind::BITVECTOR_SUB:
+    r = subDomain(children[0], children[1]);
+    break;
+  case kind::BITVECTOR_NEG:
+    r = subDomain(Domain::exact(mkZeroBV(width)), children[0]);
+    break;
+  case kind::BITVECTOR_MULT:
+    r = children[0];
+    for (unsigned i = 1; i < children.size(); ++i) {
+      r = multDomain(r, children[i]);
+    }
+    break;
+  case kind::BITVECTOR_CONCAT:
+    {
+      r.d_mask = children[0].d_mask;
+      r.d_bits = children[0].d_bits;
+      for (unsigned i = 1; i < children.size(); ++i) {
+        r.d_mask = r.d_mask.concat(children[i].d_mask);
+        r.d_bits = r.d_bits.concat(children[i].d_bits);
+      }
+      // the most significant child bounds the whole value
+      unsigned rest = width - children[0].d_lo.getSize();
+      r.d_lo = place(children[0].d_lo, width, rest);
+      r.d_hi = place(children[0].d_hi, width, rest) | lowBits(width, rest);
+      break;
+    }
+  case kind::BITVECTOR_EXTRACT:
+    {
+      unsigned high = utils::getExtractHigh(term);
+      unsigned low = utils::getExtractLow(term);
+      r.d_mask = children[0].d_mask.extract(high, low);
+      r.d_bits = children[0].d_bits.extract(high, low);
+      if (low == 0 &&
+          children[0].d_hi.toInteger() < Integer(1).multiplyByPow2(width)) {
+        r.d_lo = children[0].d_lo.extract(high, low);
+        r.d_hi = children[0].d_hi.extract(high, low);
+      }
+      break;
+    }
+  case kind::BITVECTOR_ZERO_EXTEND:
+    {
+      unsigned amount = term.getOperator().getConst<BitVectorZeroExtend>().zeroExtendAmount;
+      r.d_mask = children[0].d_mask.zeroExtend(amount) |
+                 ~lowBits(width, width - amount);
+      r.d_bits = children[0].d_bits.zeroExtend(amount);
+      r.d_lo = children[0].d_lo.zeroExtend(amount);
+      r.d_hi = children[0].d_hi.zeroExtend(amount);
+      break;
+    }
+  case kind::BITVECTOR_SIGN_EXTEND:
+    {
+      // a known sign bit is copied into known bits, an unknown one into
+      // unknown bits
+      unsigned amount = term.getOperator().getConst<BitVectorSignExtend>().signExtendAmount;
+      r.d_mask = children[0].d_mask.signExtend(amount);
+      r.d_bits = children[0].d_bits.signExtend(amount);
+      break;
+    }
+  case kind::BITVECTOR_SHL:
+  case kind::BITVECTOR_LSHR:
+  case kind::BITVECTOR_ASHR:
+    {
+      const Domain& a = children[0];
+      const Domain& s = children[1];
+      if (!s.isExact()) {
+        if (kind == kind::BITVECTOR_SHL) {
+          r.d_mask = lowBits(width, trailingZeros(a));
+        } else if (kind == kind::BITVECTOR_LSHR) {
+          r.d_hi = a.d_hi;
+        }
+        break;
+      }
+      Integer amount = s.d_lo.toInteger();
+      unsigned n = amount < Integer(width) ? amount.toUnsignedInt() : width;
+      if (kind == kind::BITVECTOR_SHL) {
+        r.d_mask = a.d_mask.leftShift(s.d_lo) | lowBits(width, n);
+        r.d_bits = a.d_bits.leftShift(s.d_lo);
+        if (n < width &&
+            a.d_hi.toInteger() < Integer(1).multiplyByPow2(width - n)) {
+          r.d_lo = a.d_lo.leftShift(s.d_lo);
+          r.d_hi = a.d_hi.leftShift(s.d_lo);
+        }
+      } else if (kind == kind::BITVECTOR_LSHR) {
+        r.d_mask = a.d_mask.logicalRightShift(s.d_lo) | ~lowBits(width, width - n);
+        r.d_bits = a.d_bits.logicalRightShift(s.d_lo);
+        r.d_lo = a.d_lo.logicalRightShift(s.d_lo);
+        r.d_hi = a.d_hi.logicalRightShift(s.d_lo);
+      } else if (n < width) {
+        // as for sign extension the shifted in bits are known iff the sign
+        // bit is
+        r.d_mask = a.d_mask.arithRightShift(s.d_lo);
+        r.d_bits = a.d_bits.arithRightShift(s.d_lo);
+      }
+      break;
+    }
+  case kind::BITVECTOR_UDIV_TOTAL:
+    {
+      const Domain& a = children[0];
+      const Domain& b = children[1];
+      if (!isZero(b.d_lo)) {
+        r.d_lo = a.d_lo.unsignedDivTotal(b.d_hi);
+        r.d_hi = a.d_hi.unsignedDivTotal(b.d_lo);
+      } else if (!isZero(b.d_hi)) {
+        // division by zero gives all ones, which is the largest value
+        r.d_lo = a.d_lo.unsignedDivTotal(b.d_hi);
+      }
+      break;
+    }
+  case kind::BITVECTOR_UREM_TOTAL:
+    {
+      const Domain& a = children[0];
+      const Domain& b = children[1];
+      // the remainder is never larger than the dividend, and smaller than
+      // the divisor unless the divisor is zero
+      r.d_hi = isZero(b.d_lo) ? a.d_hi : minBV(a.d_hi, b.d_hi - BitVector(width, 1u));
+      break;
+    }
+  case kind::BITVECTOR_COMP:
+    if (disjoint(children[0], children[1])) {
+      r = Domain::exact(mkZeroBV(1));
+    }
+    break;
+  case kind::ITE:
+    r = join(children[0], children[1]);
+    break;
+  default:
+    // the remaining operators and the uninterpreted terms are unconstrained
+    break;
+  }
+
+  r.d_reasons.swap(reasons);
+  result = r;
+  return normalize(result);
+}
+
+bool PropagationSolver::updateDomain(TNode term, const Domain& d) {
+  if (d.isTop()) {
+    return true;
+  }
+  Domain current = getDomain(term);
+  Domain updated = current;
+  if (!meet(updated, d)) {
+    Debug("bv-propagation") << "PropagationSolver::updateDomain conflict on "
+                            << term << "\n";
+    std::vector<Node> reasons = current.d_reasons;
+    mergeReasons(reasons, d.d_reasons);
+    setConflict(reasons);
+    return false;
+  }
+  if (updated.d_mask == current.d_mask &&
+      updated.d_lo == current.d_lo &&
+      updated.d_hi == current.d_hi) {
+    return true;
+  }
+  mergeReasons(updated.d_reasons, d.d_reasons);
+  Debug("bv-propagation") << "PropagationSolver::updateDomain " << term
+                          << " bits " << updated.d_bits << "/" << updated.d_mask
+                          << " in [" << updated.d_lo << ", " << updated.d_hi
+                          << "]\n";
+  d_domains.insert(term, updated);
+  ++d_numUpdates;
+  ++(d_statistics.d_numUpdates);
+  d_touched.insert(term);
+  if (d_inQueue.find(term) == d_inQueue.end()) {
+    d_inQueue.insert(term);
+    d_queue.push_back(term);
+  }
+  return true;
+}
+
+bool PropagationSolver::propagateToChildren(TNode term) {
+  if (term.getNumChildren() == 0 || term.getKind() == kind::CONST_BITVECTOR) {
+    return true;
+  }
+  Domain t = getDomain(term);
+  if (t.isTop()) {
+    return true;
+  }
+  unsigned width = utils::getSize(term);
+  unsigned numChildren = term.getNumChildren();
+  Kind kind = term.getKind();
+
+  switch (kind) {
+  case kind::BITVECTOR_NOT:
+    {
+      Domain c(width);
+      c.d_mask = t.d_mask;
+      c.d_bits = ~t.d_bits & t.d_mask;
+      c.d_lo = ~t.d_hi;
+      c.d_hi = ~t.d_lo;
+      c.d_reasons = t.d_reasons;
+      return updateDomain(term[0], c);
+    }
+  case kind::BITVECTOR_CONCAT:
+    {
+      unsigned low = width;
+      for (unsigned i = 0; i < numChildren; ++i) {
+        unsigned size = utils::getSize(term[i]);
+        low -= size;
+        Domain c(size);
+        c.d_mask = t.d_mask.extract(low + size - 1, low);
+        c.d_bits = t.d_bits.extract(low + size - 1, low);
+        if (i == 0) {
+          c.d_lo = t.d_lo.extract(width - 1, low);
+          c.d_hi = t.d_hi.extract(width - 1, low);
+        }
+        c.d_reasons = t.d_reasons;
+        if (!updateDomain(term[i], c)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  case kind::BITVECTOR_EXTRACT:
+    {
+      unsigned size = utils::getSize(term[0]);
+      unsigned low = utils::getExtractLow(term);
+      Domain c(size);
+      c.d_mask = place(t.d_mask, size, low);
+      c.d_bits = place(t.d_bits, size, low);
+      c.d_reasons = t.d_reasons;
+      return updateDomain(term[0], c);
+    }
+  case kind::BITVECTOR_ZERO_EXTEND:
+  case kind::BITVECTOR_SIGN_EXTEND:
+    {
+      unsigned size = utils::getSize(term[0]);
+      Domain c(size);
+      c.d_mask = t.d_mask.extract(size - 1, 0);
+      c.d_bits = t.d_bits.extract(size - 1, 0);
+      if (kind == kind::BITVECTOR_ZERO_EXTEND) {
+        Integer modulus = Integer(1).multiplyByPow2(size);
+        if (t.d_lo.toInteger() < modulus) {
+          c.d_lo = t.d_lo.extract(size - 1, 0);
+        }
+        if (t.d_hi.toInteger() < modulus) {
+          c.d_hi = t.d_hi.extract(size - 1, 0);
+        }
+      }
+      c.d_reasons = t.d_reasons;
+      return updateDomain(term[0], c);
+    }
+  case kind::BITVECTOR_AND:
+  case kind::BITVECTOR_OR:
+  case kind::BITVECTOR_XOR:
+  case kind::BITVECTOR_PLUS:
+    {
+      std::vector<Domain> children;
+      for (unsigned i = 0; i < numChildren; ++i) {
+        children.push_back(getDomain(term[i]));
+      }
+      for (unsigned i = 0; i < numChildren; ++i) {
+        // summarize the other children
+        Domain others = kind == kind::BITVECTOR_AND ?
+            Domain::exact(mkOnesBV(width)) : Domain::exact(mkZeroBV(width));
+        for (unsigned j = 0; j < numChildren; ++j) {
+          if (j == i) continue;
+          switch (kind) {
+          case kind::BITVECTOR_AND: others = andDomain(others, children[j]); break;
+          case kind::BITVECTOR_OR: others = orDomain(others, children[j]); break;
+          case kind::BITVECTOR_XOR: others = xorDomain(others, children[j]); break;
+          default: others = plusDomain(others, children[j]); break;
+          }
+          mergeReasons(others.d_reasons, children[j].d_reasons);
+        }
+        Domain c(width);
+        if (kind == kind::BITVECTOR_AND) {
+          // a 1 in the result is a 1 in every child, a 0 in the result where
+          // all other children are 1 is a 0 in this one
+          c.d_bits = t.d_bits;
+          c.d_mask = t.d_bits | (knownZeros(t) & others.d_bits);
+        } else if (kind == kind::BITVECTOR_OR) {
+          c.d_mask = knownZeros(t) | (t.d_bits & knownZeros(others));
+          c.d_bits = t.d_bits & knownZeros(others);
+        } else if (kind == kind::BITVECTOR_XOR) {
+          c.d_mask = t.d_mask & others.d_mask;
+          c.d_bits = (t.d_bits ^ others.d_bits) & c.d_mask;
+        } else {
+          c.d_mask = lowBits(width, std::min(trailingKnown(t), trailingKnown(others)));
+          c.d_bits = (t.d_bits - others.d_bits) & c.d_mask;
+        }
+        c.d_reasons = t.d_reasons;
+        mergeReasons(c.d_reasons, others.d_reasons);
+        if (!updateDomain(term[i], c)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  case kind::BITVECTOR_SUB:
+    {
+      // a - b = t gives a = t + b and b = a - t
+      Domain a = getDomain(term[0]);
+      Domain b = getDomain(term[1]);
+      Domain ca(width);
+      ca.d_mask = lowBits(width, std::min(trailingKnown(t), trailingKnown(b)));
+      ca.d_bits = (t.d_bits + b.d_bits) & ca.d_mask;
+      ca.d_reasons = t.d_reasons;
+      mergeReasons(ca.d_reasons, b.d_reasons);
+      Domain cb(width);
+      cb.d_mask = lowBits(width, std::min(trailingKnown(t), trailingKnown(a)));
+      cb.d_bits = (a.d_bits - t.d_bits) & cb.d_mask;
+      cb.d_reasons = t.d_reasons;
+      mergeReasons(cb.d_reasons, a.d_reasons);
+      return updateDomain(term[0], ca) && updateDomain(term[1], cb);
+    }
+  case kind::BITVECTOR_NEG:
+    {
+      Domain c(width);
+      c.d_mask = lowBits(width, trailingKnown(t));
+      c.d_bits = (-t.d_bits) & c.d_mask;
+      c.d_reasons = t.d_reasons;
+      return updateDomain(term[0], c);
+    }
+  default:
+    return true;
+  }
+}
+
+bool PropagationSolver::applyLiteral(TNode literal) {
+  bool polarity = literal.getKind() != kind::NOT;
+  TNode atom = polarity ? literal : literal[0];
+  TNode a = atom[0];
+  TNode b = atom[1];
+
+  switch (atom.getKind()) {
+  case kind::EQUAL:
+    if (polarity) {
+      Domain da = getDomain(a);
+      Domain db = getDomain(b);
+      addReason(da.d_reasons, literal);
+      addReason(db.d_reasons, literal);
+      return updateDomain(a, db) && updateDomain(b, da);
+    }
+    return applyDisequality(a, b, literal);
+  case kind::BITVECTOR_ULT:
+    return polarity ? applyLessThan(a, b, true, literal)
+                    : applyLessThan(b, a, false, literal);
+  case kind::BITVECTOR_ULE:
+    return polarity ? applyLessThan(a, b, false, literal)
+                    : applyLessThan(b, a, true, literal);
+  default:
+    Unreachable();
+    return true;
+  }
+}
+
+bool PropagationSolver::applyLessThan(TNode a, TNode b, bool strict, TNode literal) {
+  Domain da = getDomain(a);
+  Domain db = getDomain(b);
+  unsigned width = utils::getSize(a);
+  BitVector one(width, 1u);
+
+  // a is at most the largest value of b
+  if (strict && isZero(db.d_hi)) {
+    addReason(db.d_reasons, literal);
+    setConflict(db.d_reasons);
+    return false;
+  }
+  Domain upper(width);
+  upper.d_hi = strict ? db.d_hi - one : db.d_hi;
+  upper.d_reasons = db.d_reasons;
+  addReason(upper.d_reasons, literal);
+  if (!updateDomain(a, upper)) {
+    return false;
+  }
+
+  // b is at least the smallest value of a
+  if (strict && da.d_lo == mkOnesBV(width)) {
+    addReason(da.d_reasons, literal);
+    setConflict(da.d_reasons);
+    return false;
+  }
+  Domain lower(width);
+  lower.d_lo = strict ? da.d_lo + one : da.d_lo;
+  lower.d_reasons = da.d_reasons;
+  addReason(lower.d_reasons, literal);
+  return updateDomain(b, lower);
+}
+
+bool PropagationSolver::applyDisequality(TNode a, TNode b, TNode literal) {
+  Domain da = getDomain(a);
+  Domain db = getDomain(b);
+  if (da.isExact() && db.isExact() && da.d_lo == db.d_lo) {
+    mergeReasons(da.d_reasons, db.d_reasons);
+    addReason(da.d_reasons, literal);
+    setConflict(da.d_reasons);
+    return false;
+  }
+  // a constant at the end of the other side's interval excludes that end
+  for (unsigned i = 0; i < 2; ++i) {
+    const Domain& c = i == 0 ? da : db;
+    const Domain& d = i == 0 ? db : da;
+    if (!c.isExact() || d.isExact()) continue;
+    unsigned width = c.d_lo.getSize();
+    Domain shrunk(width);
+    if (d.d_lo == c.d_lo) {
+      shrunk.d_lo = c.d_lo + BitVector(width, 1u);
+    } else if (d.d_hi == c.d_lo) {
+      shrunk.d_hi = c.d_lo - BitVector(width, 1u);
+    } else {
+      continue;
+    }
+    shrunk.d_reasons = c.d_reasons;
+    addReason(shrunk.d_reasons, literal);
+    if (!updateDomain(i == 0 ? b : a, shrunk)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PropagationSolver::processQueue() {
+  while (!d_queue.empty()) {
+    if (d_numUpdates > options::bitvectorPropagationBudget()) {
+      // stopping early only loses propagations
+      Debug("bv-propagation") << "PropagationSolver::processQueue budget exhausted\n";
+      ++(d_statistics.d_numBudgetExhausted);
+      break;
+    }
+    Node term = d_queue.back();
+    d_queue.pop_back();
+    d_inQueue.erase(term);
+
+    NodeListMap::const_iterator parents = d_parents.find(term);
+    if (parents != d_parents.end()) {
+      for (unsigned i = 0; i < parents->second.size(); ++i) {
+        TNode parent = parents->second[i];
+        Domain d(utils::getSize(parent));
+        if (!computeFromChildren(parent, d)) {
+          // the children are jointly inconsistent
+          if (d.d_reasons.empty()) {
+            continue;
+          }
+          setConflict(d.d_reasons);
+          return false;
+        }
+        if (!updateDomain(parent, d)) {
+          return false;
+        }
+      }
+    }
+
+    if (!propagateToChildren(term)) {
+      return false;
+    }
+
+    NodeListMap::const_iterator atoms = d_atoms.find(term);
+    if (atoms != d_atoms.end()) {
+      for (unsigned i = 0; i < atoms->second.size(); ++i) {
+        LiteralMap::const_iterator it = d_assertedLiterals.find(atoms->second[i]);
+        if (it != d_assertedLiterals.end() && !applyLiteral((*it).second)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+int PropagationSolver::evaluateAtom(TNode atom, std::vector<Node>& reasons) {
+  Domain a = getDomain(atom[0]);
+  Domain b = getDomain(atom[1]);
+  int value = -1;
+  switch (atom.getKind()) {
+  case kind::EQUAL:
+    if (a.isExact() && b.isExact() && a.d_lo == b.d_lo) {
+      value = 1;
+    } else if (disjoint(a, b)) {
+      value = 0;
+    }
+    break;
+  case kind::BITVECTOR_ULT:
+    if (a.d_hi < b.d_lo) {
+      value = 1;
+    } else if (b.d_hi <= a.d_lo) {
+      value = 0;
+    }
+    break;
+  case kind::BITVECTOR_ULE:
+    if (a.d_hi <= b.d_lo) {
+      value = 1;
+    } else if (b.d_hi < a.d_lo) {
+      value = 0;
+    }
+    break;
+  default:
+    Unreachable();
+  }
+  if (value != -1) {
+    reasons.swap(a.d_reasons);
+    mergeReasons(reasons, b.d_reasons);
+  }
+  return value;
+}
+
+void PropagationSolver::propagateAtoms() {
+  for (NodeSet::const_iterator it = d_touched.begin(); it != d_touched.end(); ++it) {
+    NodeListMap::const_iterator atoms = d_atoms.find(*it);
+    if (atoms == d_atoms.end()) {
+      continue;
+    }
+    for (unsigned i = 0; i < atoms->second.size(); ++i) {
+      TNode atom = atoms->second[i];
+      if (d_assertedLiterals.find(atom) != d_assertedLiterals.end() ||
+          d_explanations.find(atom) != d_explanations.end() ||
+          d_explanations.find(atom.notNode()) != d_explanations.end()) {
+        continue;
+      }
+      std::vector<Node> reasons;
+      int value = evaluateAtom(atom, reasons);
+      if (value == -1) {
+        continue;
+      }
+      Node literal = value == 1 ? (Node) atom : atom.notNode();
+      Node explanation = reasons.empty() ? Node::null() : utils::mkAnd(reasons);
+      Debug("bv-propagation") << "PropagationSolver::propagateAtoms " << literal
+                              << " because " << explanation << "\n";
+      d_explanations.insert(literal, explanation);
+      d_bv->storePropagation(literal, SUB_PROPAGATION);
+      ++(d_statistics.d_numPropagations);
+    }
+  }
+}
+
+void PropagationSolver::setConflict(const std::vector<Node>& reasons) {
+  Assert (!reasons.empty());
+  d_conflict = reasons;
+}
+
+bool PropagationSolver::check(Theory::Effort e) {
+  Debug("bv-propagation") << "PropagationSolver::check(" << e << ")\n";
+  ++(d_statistics.d_numCallsToCheck);
+  d_bv->spendResource(options::theoryCheckStep());
+
+  d_numUpdates = 0;
+  bool ok = true;
+  while (!done() && ok) {
+    TNode fact = get();
+    TNode atom = fact.getKind() == kind::NOT ? fact[0] : fact;
+    // only the atoms registered in preRegister() are handled
+    if (d_registered.find(atom) == d_registered.end()) {
+      continue;
+    }
+    Debug("bv-propagation") << "  " << fact << "\n";
+    d_assertedLiterals.insert(atom, fact);
+    ok = applyLiteral(fact) && processQueue();
+  }
+
+  if (ok) {
+    propagateAtoms();
+  }
+  d_queue.clear();
+  d_inQueue.clear();
+  d_touched.clear();
+
+  if (!ok) {
+    ++(d_statistics.d_numConflicts);
+    Node conflict = utils::mkAnd(d_conflict);
+    d_conflict.clear();
+    Debug("bv-propagation") << "PropagationSolver::check conflict " << conflict << "\n";
+    d_bv->setConflict(conflict);
+    return false;
+  }
+  return true;
+}
+
+void PropagationSolver::explain(TNode literal, std::vector<TNode>& assumptions) {
+  LiteralMap::const_iterator it = d_explanations.find(literal);
+  Assert (it != d_explanations.end());
+  TNode explanation = (*it).second;
+  Debug("bv-propagation") << "PropagationSolver::explain " << literal
+                          << " with " << explanation << "\n";
+  if (explanation.isNull()) {
+    return;
+  }
+  if (explanation.getKind() == kind::AND) {
+    for (unsigned i = 0; i < explanation.getNumChildren(); ++i) {
+      assumptions.push_back(explanation[i]);
+    }
+  } else {
+    assumptions.push_back(explanation);
+  }
+}
+
+EqualityStatus PropagationSolver::getEqualityStatus(TNode a, TNode b) {
+  if ((d_domains.find(a) == d_domains.end() && !a.isConst()) ||
+      (d_domains.find(b) == d_domains.end() && !b.isConst())) {
+    return EQUALITY_UNKNOWN;
+  }
+  Domain da = getDomain(a);
+  Domain db = getDomain(b);
+  if (da.isExact() && db.isExact() && da.d_lo == db.d_lo) {
+    return EQUALITY_TRUE;
+  }
+  if (disjoint(da, db)) {
+    return EQUALITY_FALSE;
+  }
+  return EQUALITY_UNKNOWN;
+}
+
+PropagationSolver::Statistics::Statistics()
+  : d_numCallsToCheck("theory::bv::PropagationSolver::NumCallsToCheck", 0)
+  , d_numUpdates("theory::bv::PropagationSolver::NumDomainUpdates", 0)
+  , d_numConflicts("theory::bv::PropagationSolver::NumConflicts", 0)
+  , d_numPropagations("theory::bv::PropagationSolver::NumPropagations", 0)
+  , d_numBudgetExhausted("theory::bv::PropagationSolver::NumBudgetExhausted", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->registerStat(&d_numUpdates);
+  smtStatisticsRegistry()->registerStat(&d_numConflicts);
+  smtStatisticsRegistry()->registerStat(&d_numPropagations);
+  smtStatisticsRegistry()->registerStat(&d_numBudgetExhausted);
+}
+
+PropagationSolver::Statistics::~Statistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->unregisterStat(&d_numUpdates);
+  smtStatisticsRegistry()->unregisterStat(&d_numConflicts);
+  smtStatisticsRegistry()->unregisterStat(&d_numPropagations);
+  smtStatisticsRegistry()->unregisterStat(&d_numBudgetExhausted);
+}
@@ -0,0 +1,138 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Word-level propagation solver.
+ **
+ ** Word-level propagation solver. Keeps the known bits and an unsigned
+ ** interval for every bit-vector term, propagates them through the
+ ** bit-vector operators and the asserted (in)equalities, and reports
+ ** conflicts and implied atoms before the bit-blaster is invoked.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H
+#define __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H
+
+#include <ext/hash_map>
+#include <ext/hash_set>
+#include <vector>
+
+#include "context/cdhashmap.h"
+#include "theory/bv/bv_subtheory.h"
+#include "util/bitvector.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+class PropagationSolver : public SubtheorySolver {
+public:
+  /** What is known about the value of a bit-vector term */
+  struct Domain {
+    /** bit i is set iff bit i of the term is known */
+    BitVector d_mask;
+    /** the values of the known bits, the unknown bits are 0 */
+    BitVector d_bits;
+    /** the term lies in the unsigned interval [d_lo, d_hi] */
+    BitVector d_lo;
+    BitVector d_hi;
+    /** the asserted literals the domain follows from, sorted */
+    std::vector<Node> d_reasons;
+
+    Domain() {}
+    Domain(unsigned width);
+    static Domain exact(const BitVector& value);
+    bool isExact() const { return d_lo == d_hi; }
+    bool isTop() const;
+  };
+
+private:
+  struct Statistics {
+    IntStat d_numCallsToCheck;
+    IntStat d_numUpdates;
+    IntStat d_numConflicts;
+    IntStat d_numPropagations;
+    IntStat d_numBudgetExhausted;
+    Statistics();
+    ~Statistics();
+  };
+
+  typedef context::CDHashMap<Node, Domain, NodeHashFunction> DomainMap;
+  typedef context::CDHashMap<Node, Node, NodeHashFunction> LiteralMap;
+  typedef __gnu_cxx::hash_map<Node, std::vector<Node>, NodeHashFunction> NodeListMap;
+  typedef __gnu_cxx::hash_set<Node, NodeHashFunction> NodeSet;
+
+  /** The current domains, terms without an entry are unconstrained */
+  DomainMap d_domains;
+  /** Maps the asserted atoms to the asserted literal */
+  LiteralMap d_assertedLiterals;
+  /** Maps the propagated literals to their explanation */
+  LiteralMap d_explanations;
+
+  /** The registered bit-vector terms and atoms */
+  NodeSet d_registered;
+  /** The registered terms each term is a direct child of */
+  NodeListMap d_parents;
+  /** The registered atoms each term is an argument of */
+  NodeListMap d_atoms;
+
+  /** Terms whose domain changed and still has to be propagated */
+  std::vector<Node> d_queue;
+  NodeSet d_inQueue;
+  /** Terms whose domain changed during the current check */
+  NodeSet d_touched;
+  /** Number of domain updates during the current check */
+  unsigned d_numUpdates;
+  /** The asserted literals of the conflict, if any */
+  std::vector<Node> d_conflict;
+
+  void registerTerm(TNode term);
+
+  /** Returns the current domain of term, computing it from its children the
+   * first time it is asked for */
+  Domain getDomain(TNode term);
+  /** Computes the domain of term from the domains of its children */
+  bool computeFromChildren(TNode term, Domain& result);
+  /** Meets the domain of term with d, returns false on conflict */
+  bool updateDomain(TNode term, const Domain& d);
+  /** Pushes the domain of term down to its children */
+  bool propagateToChildren(TNode term);
+  /** Applies the constraint of an asserted literal */
+  bool applyLiteral(TNode literal);
+  bool applyLessThan(TNode a, TNode b, bool strict, TNode literal);
+  bool applyDisequality(TNode a, TNode b, TNode literal);
+  bool processQueue();
+  /** Propagates the registered atoms that follow from the domains */
+  void propagateAtoms();
+  /** Returns 1 if atom is implied, 0 if its negation is, -1 otherwise */
+  int evaluateAtom(TNode atom, std::vector<Node>& reasons);
+  void setConflict(const std::vector<Node>& reasons);
+
+  Statistics d_statistics;
+
+public:
+  PropagationSolver(context::Context* c, TheoryBV* bv);
+  ~PropagationSolver();
+
+  void preRegister(TNode node);
+  bool check(Theory::Effort e);
+  void explain(TNode literal, std::vector<TNode>& assumptions);
+  void propagate(Theory::Effort e) {}
+  void collectModelInfo(TheoryModel* m, bool fullModel) {}
+  Node getModelValue(TNode var) { return Node::null(); }
+  bool isComplete() { return false; }
+  EqualityStatus getEqualityStatus(TNode a, TNode b);
+};/* class PropagationSolver */
+
+}/* CVC4::theory::bv namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H */
@@ -31,7 +31,7 @@ namespace bv {
 
 void BitblastingRegistrar::preRegister(Node n) { d_bitblaster->bbAtom(n); }
 
-EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
+EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv, const std::string& name)
     : TBitblaster<Node>(),
       d_satSolver(NULL),
       d_bitblastingRegistrar(NULL),
@@ -40,7 +40,13 @@ EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
       d_bv(theory_bv),
       d_bbAtoms(),
       d_variables(),
-      d_notify(NULL) {
+      d_notify(NULL),
+      d_incremental(options::incrementalSolving()),
+      d_userContext(NULL),
+      d_userNotify(NULL),
+      d_bvSatSolver(NULL),
+      d_activationLits(),
+      d_assumptionsAsserted(false) {
   d_bitblastingRegistrar = new BitblastingRegistrar(this);
   d_nullContext = new context::Context();
 
@@ -48,15 +54,16 @@ EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
     case SAT_SOLVER_MINISAT: {
       prop::BVSatSolverInterface* minisat =
           prop::SatSolverFactory::createMinisat(
-              d_nullContext, smtStatisticsRegistry(), "EagerBitblaster");
+              d_nullContext, smtStatisticsRegistry(), name);
       d_notify = new MinisatEmptyNotify();
       minisat->setNotify(d_notify);
       d_satSolver = minisat;
+      d_bvSatSolver = minisat;
       break;
     }
     case SAT_SOLVER_CRYPTOMINISAT:
       d_satSolver = prop::SatSolverFactory::createCryptoMinisat(
-          smtStatisticsRegistry(), "EagerBitblaster");
+          smtStatisticsRegistry(), name);
       break;
     default:
       Unreachable("Unknown SAT solver type");
@@ -64,12 +71,20 @@ EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
 
   d_cnfStream = new prop::TseitinCnfStream(d_satSolver, d_bitblastingRegistrar,
                                            d_nullContext, options::proof(),
-                                           "EagerBitblaster");
+                                           name);
+
+  if (d_incremental) {
+    // activation literals are assumptions, which only MiniSat supports
+    AlwaysAssert(d_bvSatSolver != NULL);
+    d_userContext = d_bv->getUserContext();
+    d_userNotify = new UserContextNotify(d_userContext, this);
+  }
 
   d_bvp = NULL;
 }
 
 EagerBitblaster::~EagerBitblaster() {
+  delete d_userNotify;
   delete d_cnfStream;
   delete d_satSolver;
   delete d_notify;
@@ -78,8 +93,54 @@ EagerBitblaster::~EagerBitblaster() {
 }
 
 void EagerBitblaster::bbFormula(TNode node) {
-  d_cnfStream->convertAndAssert(node, false, false, RULE_INVALID,
-                                TNode::null());
+  unsigned level = d_incremental ? d_userContext->getLevel() : 0;
+  if (level == 0) {
+    d_cnfStream->convertAndAssert(node, false, false, RULE_INVALID,
+                                  TNode::null());
+    return;
+  }
+
+  // the clauses can only be added once the assumptions are retracted
+  clearAssumptions();
+  d_cnfStream->ensureLiteral(node);
+  prop::SatClause clause;
+  clause.push_back(~getActivationLiteral(level));
+  clause.push_back(d_cnfStream->getLiteral(node));
+  d_satSolver->addClause(clause, false);
+  Debug("bitvector-eager") << "EagerBitblaster::bbFormula " << node
+                           << " at user level " << level << "\n";
+}
+
+prop::SatLiteral EagerBitblaster::getActivationLiteral(unsigned level) {
+  Assert (d_incremental && level > 0);
+  while (d_activationLits.size() < level) {
+    prop::SatLiteral lit(d_satSolver->newVar(false, false, false));
+    d_bvSatSolver->markUnremovable(lit);
+    d_bvSatSolver->addMarkerLiteral(lit);
+    d_activationLits.push_back(lit);
+  }
+  return d_activationLits[level - 1];
+}
+
+void EagerBitblaster::clearAssumptions() {
+  if (d_assumptionsAsserted) {
+    // popping the context retracts the assumptions
+    d_nullContext->pop();
+    d_assumptionsAsserted = false;
+  }
+}
+
+void EagerBitblaster::userContextPopped() {
+  clearAssumptions();
+  unsigned level = d_userContext->getLevel();
+  while (d_activationLits.size() > level) {
+    Debug("bitvector-eager") << "EagerBitblaster::userContextPopped disabling level "
+                             << d_activationLits.size() << "\n";
+    prop::SatClause clause;
+    clause.push_back(~d_activationLits.back());
+    d_satSolver->addClause(clause, false);
+    d_activationLits.pop_back();
+  }
 }
 
 /**
@@ -174,6 +235,18 @@ bool EagerBitblaster::solve() {
     Trace("bitvector") << "EagerBitblaster::solve(). \n";
   }
   Debug("bitvector") << "EagerBitblaster::solve(). \n";
+  if (d_incremental) {
+    // the assumptions stay in place until the next assertion or pop, so
+    // that the model can still be read off the SAT solver
+    clearAssumptions();
+    if (!d_activationLits.empty()) {
+      d_nullContext->push();
+      d_assumptionsAsserted = true;
+      for (unsigned i = 0; i < d_activationLits.size(); ++i) {
+        d_bvSatSolver->assertAssumption(d_activationLits[i], false);
+      }
+    }
+  }
   // TODO: clear some memory
   // if (something) {
   //   NodeManager* nm= NodeManager::currentNM();
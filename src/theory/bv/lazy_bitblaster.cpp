@@ -46,6 +46,9 @@ TLazyBitblaster::TLazyBitblaster(context::Context* c, bv::TheoryBV* bv,
   , d_abstraction(NULL)
   , d_emptyNotify(emptyNotify)
   , d_satSolverFullModel(c, false)
+  , d_cegar(options::bvCegar() && !emptyNotify && !options::proof())
+  , d_abstractedTerms()
+  , d_refinedTerms()
   , d_name(name)
   , d_statistics(name) {
 
@@ -92,6 +95,7 @@ void TLazyBitblaster::bbAtom(TNode node) {
   node = node.getKind() == kind::NOT?  node[0] : node;
 
   if (hasBBAtom(node)) {
+    ++d_statistics.d_numAtomCacheHits;
     return;
   }
   
@@ -192,6 +196,7 @@ void TLazyBitblaster::bbTerm(TNode node, Bits& bits) {
 
   if (hasBBTerm(node)) {
     getBBTerm(node, bits);
+    ++d_statistics.d_numTermCacheHits;
     return;
   }
   Assert( node.getType().isBitVector() );
@@ -200,12 +205,137 @@ void TLazyBitblaster::bbTerm(TNode node, Bits& bits) {
   Debug("bitvector-bitblast") << "Bitblasting term " << node <<"\n";
   ++d_statistics.d_numTerms;
 
-  d_termBBStrategies[node.getKind()] (node, bits,this);
+  if (d_cegar && isAbstractable(node)) {
+    abstractTerm(node, bits);
+  } else {
+    d_termBBStrategies[node.getKind()] (node, bits,this);
+  }
 
   Assert (bits.size() == utils::getSize(node));
 
   storeBBTerm(node, bits);
 }
+
+bool TLazyBitblaster::isAbstractable(TNode node) const {
+  if (utils::getSize(node) < options::bvCegarWidth()) {
+    return false;
+  }
+  switch (node.getKind()) {
+  case kind::BITVECTOR_MULT:
+    // multiplication by a constant is linear, there is nothing to gain
+    for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+      if (node[i].isConst()) {
+        return false;
+      }
+    }
+    return true;
+  case kind::BITVECTOR_UDIV_TOTAL:
+  case kind::BITVECTOR_UREM_TOTAL:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static Node mkIsZero(const std::vector<Node>& bits) {
+  std::vector<Node> negated;
+  for (unsigned i = 0; i < bits.size(); ++i) {
+    negated.push_back(utils::mkNot(bits[i]));
+  }
+  return utils::mkAnd(negated);
+}
+
+void TLazyBitblaster::abstractTerm(TNode node, Bits& bits) {
+  Debug("bitvector-cegar") << "TLazyBitblaster::abstractTerm " << node << "\n";
+  ++d_statistics.d_numAbstractedTerms;
+
+  std::vector<Bits> children(node.getNumChildren());
+  for (unsigned i = 0; i < node.getNumChildren(); ++i) {
+    bbTerm(node[i], children[i]);
+  }
+  for (unsigned i = 0; i < utils::getSize(node); ++i) {
+    bits.push_back(utils::mkBitOf(node, i));
+  }
+
+  // lemmas that hold for the operator and cost a linear number of clauses,
+  // so that the easy models are ruled out without building the circuit
+  std::vector<Node> lemmas;
+  switch (node.getKind()) {
+  case kind::BITVECTOR_MULT: {
+    std::vector<Node> lowBits;
+    std::vector<Node> zeroChildren;
+    for (unsigned i = 0; i < children.size(); ++i) {
+      lowBits.push_back(children[i][0]);
+      zeroChildren.push_back(mkIsZero(children[i]));
+    }
+    lemmas.push_back(utils::mkNode(kind::EQUAL, bits[0], utils::mkAnd(lowBits)));
+    lemmas.push_back(utils::mkNode(kind::IMPLIES, utils::mkOr(zeroChildren),
+                                   mkIsZero(bits)));
+    break;
+  }
+  case kind::BITVECTOR_UDIV_TOTAL: {
+    Node divByZero = mkIsZero(children[1]);
+    lemmas.push_back(utils::mkNode(kind::IMPLIES, divByZero, utils::mkAnd(bits)));
+    lemmas.push_back(utils::mkNode(kind::OR, divByZero,
+                                   uLessThanBB(bits, children[0], true)));
+    break;
+  }
+  case kind::BITVECTOR_UREM_TOTAL: {
+    Node divByZero = mkIsZero(children[1]);
+    lemmas.push_back(utils::mkNode(kind::OR, divByZero,
+                                   uLessThanBB(bits, children[1], false)));
+    lemmas.push_back(uLessThanBB(bits, children[0], true));
+    break;
+  }
+  default:
+    Unreachable();
+  }
+
+  for (unsigned i = 0; i < lemmas.size(); ++i) {
+    d_cnfStream->convertAndAssert(lemmas[i], false, false, RULE_INVALID, TNode::null());
+  }
+  d_abstractedTerms.push_back(node);
+}
+
+bool TLazyBitblaster::refineAbstraction() {
+  bool refined = false;
+  for (unsigned i = 0; i < d_abstractedTerms.size(); ++i) {
+    TNode term = d_abstractedTerms[i];
+    if (d_refinedTerms.find(term) != d_refinedTerms.end()) {
+      continue;
+    }
+
+    BitVector value = getModelFromSatSolver(term, true).getConst<BitVector>();
+    BitVector expected = getModelFromSatSolver(term[0], true).getConst<BitVector>();
+    for (unsigned j = 1; j < term.getNumChildren(); ++j) {
+      BitVector child = getModelFromSatSolver(term[j], true).getConst<BitVector>();
+      switch (term.getKind()) {
+      case kind::BITVECTOR_MULT: expected = expected * child; break;
+      case kind::BITVECTOR_UDIV_TOTAL: expected = expected.unsignedDivTotal(child); break;
+      case kind::BITVECTOR_UREM_TOTAL: expected = expected.unsignedRemTotal(child); break;
+      default: Unreachable();
+      }
+    }
+    if (value == expected) {
+      continue;
+    }
+
+    Debug("bitvector-cegar") << "TLazyBitblaster::refineAbstraction " << term
+                             << " is " << value << " in the model instead of "
+                             << expected << "\n";
+    ++d_statistics.d_numRefinedTerms;
+    Bits bits, circuit;
+    getBBTerm(term, bits);
+    d_termBBStrategies[term.getKind()] (term, circuit, this);
+    for (unsigned j = 0; j < bits.size(); ++j) {
+      Node lemma = utils::mkNode(kind::EQUAL, bits[j], circuit[j]);
+      d_cnfStream->convertAndAssert(lemma, false, false, RULE_INVALID, TNode::null());
+    }
+    d_refinedTerms.insert(term);
+    refined = true;
+  }
+  return refined;
+}
 /// Public methods
 
 void TLazyBitblaster::addAtom(TNode atom) {
@@ -291,7 +421,16 @@ bool TLazyBitblaster::solve() {
   }
   Debug("bitvector") << "TLazyBitblaster::solve() asserted atoms " << d_assertedAtoms->size() <<"\n";
   d_satSolverFullModel.set(true);
-  return prop::SAT_VALUE_TRUE == d_satSolver->solve();
+  while (prop::SAT_VALUE_TRUE == d_satSolver->solve()) {
+    // the model is a model of the formula if it agrees with the abstracted
+    // operators, otherwise add the circuits it violates and solve again
+    if (!d_cegar || !refineAbstraction()) {
+      return true;
+    }
+    ++d_statistics.d_numRefinements;
+    invalidateModelCache();
+  }
+  return false;
 }
 
 prop::SatValue TLazyBitblaster::solveWithBudget(unsigned long budget) {
@@ -329,16 +468,26 @@ TLazyBitblaster::Statistics::Statistics(const std::string& prefix) :
   d_numAtomClauses("theory::bv::"+prefix+"::NumberOfAtomSatClauses", 0),
   d_numTerms("theory::bv::"+prefix+"::NumberOfBitblastedTerms", 0),
   d_numAtoms("theory::bv::"+prefix+"::NumberOfBitblastedAtoms", 0),
+  d_numTermCacheHits("theory::bv::"+prefix+"::NumberOfTermCacheHits", 0),
+  d_numAtomCacheHits("theory::bv::"+prefix+"::NumberOfAtomCacheHits", 0),
   d_numExplainedPropagations("theory::bv::"+prefix+"::NumberOfExplainedPropagations", 0),
   d_numBitblastingPropagations("theory::bv::"+prefix+"::NumberOfBitblastingPropagations", 0),
+  d_numAbstractedTerms("theory::bv::"+prefix+"::NumberOfAbstractedTerms", 0),
+  d_numRefinedTerms("theory::bv::"+prefix+"::NumberOfRefinedTerms", 0),
+  d_numRefinements("theory::bv::"+prefix+"::NumberOfRefinementRounds", 0),
   d_bitblastTimer("theory::bv::"+prefix+"::BitblastTimer")
 {
   smtStatisticsRegistry()->registerStat(&d_numTermClauses);
   smtStatisticsRegistry()->registerStat(&d_numAtomClauses);
   smtStatisticsRegistry()->registerStat(&d_numTerms);
   smtStatisticsRegistry()->registerStat(&d_numAtoms);
+  smtStatisticsRegistry()->registerStat(&d_numTermCacheHits);
+  smtStatisticsRegistry()->registerStat(&d_numAtomCacheHits);
   smtStatisticsRegistry()->registerStat(&d_numExplainedPropagations);
   smtStatisticsRegistry()->registerStat(&d_numBitblastingPropagations);
+  smtStatisticsRegistry()->registerStat(&d_numAbstractedTerms);
+  smtStatisticsRegistry()->registerStat(&d_numRefinedTerms);
+  smtStatisticsRegistry()->registerStat(&d_numRefinements);
   smtStatisticsRegistry()->registerStat(&d_bitblastTimer);
 }
 
@@ -348,8 +497,13 @@ TLazyBitblaster::Statistics::~Statistics() {
   smtStatisticsRegistry()->unregisterStat(&d_numAtomClauses);
   smtStatisticsRegistry()->unregisterStat(&d_numTerms);
   smtStatisticsRegistry()->unregisterStat(&d_numAtoms);
+  smtStatisticsRegistry()->unregisterStat(&d_numTermCacheHits);
+  smtStatisticsRegistry()->unregisterStat(&d_numAtomCacheHits);
   smtStatisticsRegistry()->unregisterStat(&d_numExplainedPropagations);
   smtStatisticsRegistry()->unregisterStat(&d_numBitblastingPropagations);
+  smtStatisticsRegistry()->unregisterStat(&d_numAbstractedTerms);
+  smtStatisticsRegistry()->unregisterStat(&d_numRefinedTerms);
+  smtStatisticsRegistry()->unregisterStat(&d_numRefinements);
   smtStatisticsRegistry()->unregisterStat(&d_bitblastTimer);
 }
 
@@ -525,6 +679,8 @@ void TLazyBitblaster::clearSolver() {
   d_bbAtoms.clear();
   d_variables.clear();
   d_termCache.clear();
+  d_abstractedTerms.clear();
+  d_refinedTerms.clear();
 
   invalidateModelCache();
   // recreate sat solver
@@ -0,0 +1,283 @@
+/*********************                                                        */
+/*! \file native_aig_bitblaster.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Eager bit-blaster targeting the in-tree AIG.
+ **
+ ** Eager bit-blaster targeting the in-tree AIG.
+ **/
+
+#include "cvc4_private.h"
+
+#include "options/bv_options.h"
+#include "prop/sat_solver_factory.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/bv/bitblaster_template.h"
+#include "theory/bv/theory_bv.h"
+#include "theory/theory_model.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+NativeAigBitblaster::NativeAigBitblaster(TheoryBV* theory_bv)
+  : TBitblaster<AigEdge>()
+  , d_aigM(NULL)
+  , d_nullContext(NULL)
+  , d_satSolver(NULL)
+  , d_notify(NULL)
+  , d_cnfEmitter(NULL)
+  , d_bv(theory_bv)
+  , d_aigCache()
+  , d_bbAtoms()
+  , d_nodeToAigInput()
+  , d_variables()
+{
+  d_aigM = new AigManager();
+  d_nullContext = new context::Context();
+
+  switch (options::bvSatSolver()) {
+    case SAT_SOLVER_MINISAT: {
+      prop::BVSatSolverInterface* minisat =
+          prop::SatSolverFactory::createMinisat(
+              d_nullContext, smtStatisticsRegistry(), "NativeAigBitblaster");
+      d_notify = new MinisatEmptyNotify();
+      minisat->setNotify(d_notify);
+      d_satSolver = minisat;
+      break;
+    }
+    case SAT_SOLVER_CRYPTOMINISAT:
+      d_satSolver = prop::SatSolverFactory::createCryptoMinisat(
+          smtStatisticsRegistry(), "NativeAigBitblaster");
+      break;
+    default:
+      Unreachable("Unknown SAT solver type");
+  }
+
+  d_cnfEmitter = new AigCnfEmitter(d_aigM, d_satSolver);
+}
+
+NativeAigBitblaster::~NativeAigBitblaster() {
+  delete d_cnfEmitter;
+  delete d_satSolver;
+  delete d_notify;
+  delete d_nullContext;
+  delete d_aigM;
+}
+
+AigEdge NativeAigBitblaster::bbFormula(TNode node) {
+  Assert (node.getType().isBoolean());
+  NodeAigMap::const_iterator it = d_aigCache.find(node);
+  if (it != d_aigCache.end()) {
+    return it->second;
+  }
+
+  Debug("bitvector-aig") << "NativeAigBitblaster::bbFormula " << node << "\n";
+  AigEdge result;
+  switch (node.getKind()) {
+  case kind::AND:
+    {
+      result = bbFormula(node[0]);
+      for (unsigned i = 1; i < node.getNumChildren(); ++i) {
+        result = mkAnd(result, bbFormula(node[i]));
+      }
+      break;
+    }
+  case kind::OR:
+    {
+      result = bbFormula(node[0]);
+      for (unsigned i = 1; i < node.getNumChildren(); ++i) {
+        result = mkOr(result, bbFormula(node[i]));
+      }
+      break;
+    }
+  case kind::XOR:
+    {
+      result = bbFormula(node[0]);
+      for (unsigned i = 1; i < node.getNumChildren(); ++i) {
+        result = mkXor(result, bbFormula(node[i]));
+      }
+      break;
+    }
+  case kind::IMPLIES:
+    {
+      Assert (node.getNumChildren() == 2);
+      result = mkOr(mkNot(bbFormula(node[0])), bbFormula(node[1]));
+      break;
+    }
+  case kind::ITE:
+    {
+      Assert (node.getNumChildren() == 3);
+      AigEdge a = bbFormula(node[0]);
+      AigEdge b = bbFormula(node[1]);
+      AigEdge c = bbFormula(node[2]);
+      result = mkIte(a, b, c);
+      break;
+    }
+  case kind::NOT:
+    {
+      result = mkNot(bbFormula(node[0]));
+      break;
+    }
+  case kind::CONST_BOOLEAN:
+    {
+      result = node.getConst<bool>() ? mkTrue<AigEdge>() : mkFalse<AigEdge>();
+      break;
+    }
+  case kind::VARIABLE:
+  case kind::SKOLEM:
+    {
+      result = mkInput(node);
+      break;
+    }
+  case kind::EQUAL:
+    {
+      if( node[0].getType().isBoolean() ){
+        Assert (node.getNumChildren() == 2);
+        result = mkIff(bbFormula(node[0]), bbFormula(node[1]));
+        break;
+      }
+      //else, continue...
+    }
+  default:
+    bbAtom(node);
+    result = getBBAtom(node);
+  }
+
+  d_aigCache.insert(std::make_pair(node, result));
+  Debug("bitvector-aig") << "NativeAigBitblaster::bbFormula done " << node << " => " << result << "\n";
+  return result;
+}
+
+void NativeAigBitblaster::assertFormula(TNode formula) {
+  d_cnfEmitter->assertEdge(bbFormula(formula));
+}
+
+void NativeAigBitblaster::bbAtom(TNode node) {
+  if (hasBBAtom(node)) {
+    return;
+  }
+
+  Debug("bitvector-bitblast") << "Bitblasting atom " << node <<"\n";
+
+  // the bitblasted definition of the atom
+  Node normalized = Rewriter::rewrite(node);
+  AigEdge atom_bb;
+  if (normalized.getKind() == kind::CONST_BOOLEAN) {
+    atom_bb = normalized.getConst<bool>() ? mkTrue<AigEdge>() : mkFalse<AigEdge>();
+  } else {
+    atom_bb = (d_atomBBStrategies[normalized.getKind()])(normalized, this);
+  }
+  storeBBAtom(node, atom_bb);
+  Debug("bitvector-bitblast") << "Done bitblasting atom " << node <<"\n";
+}
+
+void NativeAigBitblaster::bbTerm(TNode node, Bits& bits) {
+  if (hasBBTerm(node)) {
+    getBBTerm(node, bits);
+    return;
+  }
+  Assert( node.getType().isBitVector() );
+
+  d_bv->spendResource(options::bitblastStep());
+  Debug("bitvector-bitblast") << "Bitblasting term " << node <<"\n";
+  d_termBBStrategies[node.getKind()] (node, bits, this);
+
+  Assert (bits.size() == utils::getSize(node));
+  storeBBTerm(node, bits);
+}
+
+void NativeAigBitblaster::makeVariable(TNode node, Bits& bits) {
+  for (unsigned i = 0; i < utils::getSize(node); ++i) {
+    Node bit = utils::mkBitOf(node, i);
+    bits.push_back(mkInput(bit));
+  }
+  d_variables.insert(node);
+}
+
+AigEdge NativeAigBitblaster::mkInput(TNode input) {
+  Assert (d_nodeToAigInput.find(input) == d_nodeToAigInput.end());
+  Assert(input.getKind() == kind::BITVECTOR_BITOF ||
+         (input.getType().isBoolean() &&
+          (input.getKind() == kind::VARIABLE ||
+           input.getKind() == kind::SKOLEM)));
+  AigEdge aig_input = d_aigM->mkInput();
+  d_nodeToAigInput.insert(std::make_pair(input, aig_input));
+  Debug("bitvector-aig") << "NativeAigBitblaster::mkInput " << input << " " << aig_input <<"\n";
+  return aig_input;
+}
+
+bool NativeAigBitblaster::hasBBAtom(TNode atom) const {
+  return d_bbAtoms.find(atom) != d_bbAtoms.end();
+}
+
+void NativeAigBitblaster::storeBBAtom(TNode atom, AigEdge atom_bb) {
+  d_bbAtoms.insert(std::make_pair(atom, atom_bb));
+}
+
+AigEdge NativeAigBitblaster::getBBAtom(TNode atom) const {
+  Assert (hasBBAtom(atom));
+  return d_bbAtoms.find(atom)->second;
+}
+
+bool NativeAigBitblaster::solve() {
+  Debug("bitvector") << "NativeAigBitblaster::solve(). \n";
+  return prop::SAT_VALUE_TRUE == d_satSolver->solve();
+}
+
+Node NativeAigBitblaster::getModelFromSatSolver(TNode a, bool fullModel) {
+  if (!hasBBTerm(a)) {
+    return fullModel ? utils::mkConst(utils::getSize(a), 0u) : Node();
+  }
+
+  Bits bits;
+  getBBTerm(a, bits);
+  Integer value(0);
+  for (int i = bits.size() - 1; i >= 0; --i) {
+    prop::SatValue bit_value;
+    if (d_cnfEmitter->hasLiteral(bits[i])) {
+      prop::SatLiteral bit = d_cnfEmitter->getLiteral(bits[i]);
+      bit_value = d_satSolver->value(bit);
+      Assert(bit_value != prop::SAT_VALUE_UNKNOWN);
+    } else {
+      if (!fullModel) return Node();
+      // only leaves are asked for a full model and their bits are inputs,
+      // unconstrained ones default to false
+      Assert (d_aigM->isInput(bits[i].getId()));
+      bit_value = prop::SAT_VALUE_FALSE;
+    }
+    Integer bit_int =
+        bit_value == prop::SAT_VALUE_TRUE ? Integer(1) : Integer(0);
+    value = value * 2 + bit_int;
+  }
+  return utils::mkConst(BitVector(bits.size(), value));
+}
+
+void NativeAigBitblaster::collectModelInfo(TheoryModel* m, bool fullModel) {
+  TNodeSet::iterator it = d_variables.begin();
+  for (; it != d_variables.end(); ++it) {
+    TNode var = *it;
+    if (d_bv->isLeaf(var) || isSharedTerm(var)) {
+      Node const_value = getModelFromSatSolver(var, true);
+      if (const_value != Node()) {
+        Debug("bitvector-model")
+            << "NativeAigBitblaster::collectModelInfo (assert (= " << var << " "
+            << const_value << "))\n";
+        m->assertEquality(var, const_value, true);
+      }
+    }
+  }
+}
+
+bool NativeAigBitblaster::isSharedTerm(TNode node) {
+  return d_bv->d_sharedTermsSet.find(node) != d_bv->d_sharedTermsSet.end();
+}
+
+} /* namespace CVC4::theory::bv; */
+} /* namespace CVC4::theory; */
+} /* namespace CVC4; */
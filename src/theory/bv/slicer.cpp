@@ -70,6 +70,20 @@ bool Base::isCutPoint (Index index) const {
   return (bit_mask & d_repr[vector_index]) != 0; 
 }
 
+Index Base::nextCutPoint(Index index) const {
+  Index i = index + 1;
+  while (i < d_size) {
+    Index vector_index = i / 32;
+    uint32_t word = d_repr[vector_index] >> (i % 32);
+    if (word != 0) {
+      Index next = i + __builtin_ctz(word);
+      return next < d_size ? next : d_size;
+    }
+    i = (vector_index + 1) * 32;
+  }
+  return d_size;
+}
+
 void Base::diffCutPoints(const Base& other, Base& res) const {
   Assert (d_size == other.d_size && res.d_size == d_size);
   for (unsigned i = 0; i < d_repr.size(); ++i) {
@@ -217,19 +231,32 @@ void UnionFind::merge(TermId t1, TermId t2) {
     return;
 
   Assert (! hasChildren(t1) && ! hasChildren(t2));
+  // union by rank keeps the find paths logarithmic in the class size
+  if (d_nodes[t1].getRank() > d_nodes[t2].getRank()) {
+    std::swap(t1, t2);
+  } else if (d_nodes[t1].getRank() == d_nodes[t2].getRank()) {
+    d_nodes[t2].incrementRank();
+  }
   setRepr(t1, t2); 
   d_representatives.erase(t1);
   d_statistics.d_numRepresentatives += -1; 
 }
 
 TermId UnionFind::find(TermId id) {
-  TermId repr = getRepr(id); 
-  if (repr != UndefinedId) {
-    TermId find_id =  find(repr);
-    setRepr(id, find_id);
-    return find_id; 
+  TermId root = id;
+  unsigned depth = 0;
+  while (getRepr(root) != UndefinedId) {
+    root = getRepr(root);
+    ++depth;
   }
-  return id; 
+  // path compression
+  while (id != root) {
+    TermId next = getRepr(id);
+    setRepr(id, root);
+    id = next;
+  }
+  d_statistics.d_avgFindDepth.addEntry(depth);
+  return root; 
 }
 /** 
  * Splits the representative of the term between i-1 and i
@@ -376,34 +403,48 @@ void UnionFind::alignSlicings(const ExtractTerm& term1, const ExtractTerm& term2
   }
   // propagate cuts to a fixpoint 
   bool changed;
-  Base cuts(term1.getBitwidth()); 
   do {
-    changed = false; 
     // we need to update the normal form which may have changed 
     getNormalForm(term1, nf1);
     getNormalForm(term2, nf2); 
 
-    // align the cuts points of the two slicings
-    // FIXME: this can be done more efficiently
-    cuts.sliceWith(nf1.base);
-    cuts.sliceWith(nf2.base); 
-
-    for (unsigned i = 0; i < cuts.getBitwidth(); ++i) {
-      if (cuts.isCutPoint(i)) {
-        if (!nf1.base.isCutPoint(i)) {
-          pair<TermId, Index> pair1 = nf1.getTerm(i, *this);
-          split(pair1.first, i - pair1.second);
-          changed = true; 
-        }
-        if (!nf2.base.isCutPoint(i)) {
-          pair<TermId, Index> pair2 = nf2.getTerm(i, *this);
-          split(pair2.first, i - pair2.second);
-          changed = true; 
-        }
-      }
-    }
+    changed = splitAtCutPoints(nf1, nf2);
+    changed = splitAtCutPoints(nf2, nf1) || changed;
   } while (changed); 
 }
+
+/** 
+ * Splits the slices of nf at the cut points of other it does not have,
+ * walking the two decompositions side by side so the cost is linear in
+ * the number of slices rather than in the bitwidth.
+ * 
+ * @param nf 
+ * @param other 
+ * 
+ * @return true if some slice was split
+ */
+bool UnionFind::splitAtCutPoints(const NormalForm& nf, const NormalForm& other) {
+  Assert (nf.base.getBitwidth() == other.base.getBitwidth());
+  bool changed = false;
+  unsigned current = 0;
+  Index start = 0; // start index of nf.decomp[current]
+  Index cut = 0;
+  for (unsigned i = 0; i + 1 < other.decomp.size(); ++i) {
+    cut += getBitwidth(other.decomp[i]);
+    while (start + getBitwidth(nf.decomp[current]) <= cut) {
+      start += getBitwidth(nf.decomp[current]);
+      ++current;
+      Assert (current < nf.decomp.size());
+    }
+    if (start != cut) {
+      // the slices in the normal form are not split further while we walk,
+      // split goes down to the right sub-slice
+      split(nf.decomp[current], cut - start);
+      changed = true;
+    }
+  }
+  return changed;
+}
 /** 
  * Given an extract term a[i:j] makes sure a is sliced
  * at indices i and j. 
@@ -557,15 +598,14 @@ void Slicer::splitEqualities(TNode node, std::vector<Node>& equalities) {
   base1.sliceWith(base2); 
   if (!base1.isEmpty()) {
     // we split the equalities according to the base
-    int last = 0; 
-    for (unsigned i = 1; i <= utils::getSize(t1); ++i) {
-      if (base1.isCutPoint(i)) {
-        Node extract1 = utils::mkExtract(t1, i-1, last);
-        Node extract2 = utils::mkExtract(t2, i-1, last);
-        last = i;
-        Assert (utils::getSize(extract1) == utils::getSize(extract2)); 
-        equalities.push_back(utils::mkNode(kind::EQUAL, extract1, extract2)); 
-      }
+    unsigned last = 0; 
+    while (last < width) {
+      unsigned i = base1.nextCutPoint(last);
+      Node extract1 = utils::mkExtract(t1, i-1, last);
+      Node extract2 = utils::mkExtract(t2, i-1, last);
+      last = i;
+      Assert (utils::getSize(extract1) == utils::getSize(extract2)); 
+      equalities.push_back(utils::mkNode(kind::EQUAL, extract1, extract2)); 
     }
   } else {
     // just return same equality
@@ -599,6 +639,7 @@ UnionFind::Statistics::Statistics():
   d_avgFindDepth("theory::bv::slicer::AverageFindDepth"),
   d_numAddedEqualities("theory::bv::slicer::NumberOfEqualitiesAdded", Slicer::d_numAddedEqualities)
 {
+  smtStatisticsRegistry()->registerStat(&d_numNodes);
   smtStatisticsRegistry()->registerStat(&d_numRepresentatives);
   smtStatisticsRegistry()->registerStat(&d_numSplits);
   smtStatisticsRegistry()->registerStat(&d_numMerges);
@@ -607,6 +648,7 @@ UnionFind::Statistics::Statistics():
 }
 
 UnionFind::Statistics::~Statistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_numNodes);
   smtStatisticsRegistry()->unregisterStat(&d_numRepresentatives);
   smtStatisticsRegistry()->unregisterStat(&d_numSplits);
   smtStatisticsRegistry()->unregisterStat(&d_numMerges);
@@ -55,6 +55,12 @@ public:
   void sliceAt(Index index); 
   void sliceWith(const Base& other);
   bool isCutPoint(Index index) const;
+  /** 
+   * Returns the smallest cut point greater than index, or the bitwidth
+   * if there is none. Skips over the words without cut points, so
+   * walking all the cut points does not cost the whole bitwidth. 
+   */
+  Index nextCutPoint(Index index) const;
   void diffCutPoints(const Base& other, Base& res) const;
   bool isEmpty() const;
   std::string debugPrint() const;
@@ -125,15 +131,19 @@ class UnionFind {
     Index d_bitwidth;
     TermId d_ch1, d_ch0;
     TermId d_repr;
+    unsigned d_rank;
   public:
     Node(Index b)
   : d_bitwidth(b),
     d_ch1(UndefinedId),
     d_ch0(UndefinedId), 
-    d_repr(UndefinedId)
+    d_repr(UndefinedId),
+    d_rank(0)
     {}
     
     TermId getRepr() const { return d_repr; }
+    unsigned getRank() const { return d_rank; }
+    void incrementRank() { ++d_rank; }
     Index getBitwidth() const { return d_bitwidth; }
     bool hasChildren() const { return d_ch1 != UndefinedId && d_ch0 != UndefinedId; }
 
@@ -159,6 +169,7 @@ class UnionFind {
   TermSet d_representatives;
   
   void getDecomposition(const ExtractTerm& term, Decomposition& decomp);
+  bool splitAtCutPoints(const NormalForm& nf, const NormalForm& other);
   void handleCommonSlice(const Decomposition& d1, const Decomposition& d2, TermId common);
   /// getter methods for the internal nodes
   TermId getRepr(TermId id)  const {
@@ -24,6 +24,7 @@
 #include "theory/bv/bv_subtheory_bitblast.h"
 #include "theory/bv/bv_subtheory_core.h"
 #include "theory/bv/bv_subtheory_inequality.h"
+#include "theory/bv/bv_subtheory_propagation.h"
 #include "theory/bv/slicer.h"
 #include "theory/bv/theory_bv_rewrite_rules_normalization.h"
 #include "theory/bv/theory_bv_rewrite_rules_simplification.h"
@@ -55,7 +56,7 @@ TheoryBV::TheoryBV(context::Context* c, context::UserContext* u,
     d_staticLearnCache(),
     d_BVDivByZero(),
     d_BVRemByZero(),
-    d_funcToArgs(),
+    d_funcApps(u),
     d_funcToSkolem(u),
     d_lemmasAdded(c, false),
     d_conflict(c, false),
@@ -86,6 +87,12 @@ TheoryBV::TheoryBV(context::Context* c, context::UserContext* u,
     d_subtheoryMap[SUB_CORE] = core_solver;
   }
 
+  if (options::bitvectorPropagationSolver()) {
+    SubtheorySolver* prop_solver = new PropagationSolver(c, this);
+    d_subtheories.push_back(prop_solver);
+    d_subtheoryMap[SUB_PROPAGATION] = prop_solver;
+  }
+
   if (options::bitvectorInequalitySolver()) {
     SubtheorySolver* ineq_solver = new InequalitySolver(c, u, this);
     d_subtheories.push_back(ineq_solver);
@@ -207,12 +214,8 @@ void TheoryBV::collectFunctionSymbols(TNode term, TNodeSet& seen) {
 }
 
 void TheoryBV::storeFunction(TNode func, TNode term) {
-  if (d_funcToArgs.find(func) == d_funcToArgs.end()) {
-    d_funcToArgs.insert(make_pair(func, NodeSet()));
-  }
-  NodeSet& set = d_funcToArgs[func];
-  if (set.find(term) == set.end()) {
-    set.insert(term);
+  if (!d_funcToSkolem.hasSubstitution(term)) {
+    d_funcApps.push_back(term);
     Node skolem = utils::mkVar(utils::getSize(term));
     d_funcToSkolem.addSubstitution(term, skolem);
   }
@@ -222,15 +225,24 @@ void TheoryBV::mkAckermanizationAsssertions(std::vector<Node>& assertions) {
   Debug("bv-ackermanize") << "TheoryBV::mkAckermanizationAsssertions\n";
 
   Assert(options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER);
-  AlwaysAssert(!options::incrementalSolving());
+  // in incremental mode, d_funcApps also holds the applications of earlier
+  // check-sat calls that were not popped, and the lemmas relating them are
+  // recreated at the current user level
   TNodeSet seen;
   for (unsigned i = 0; i < assertions.size(); ++i) {
     collectFunctionSymbols(assertions[i], seen);
   }
 
-  FunctionToArgs::const_iterator it = d_funcToArgs.begin();
+  FunctionToArgs funcToArgs;
+  for (unsigned i = 0; i < d_funcApps.size(); ++i) {
+    Node term = d_funcApps[i];
+    Node func = term.getKind() == kind::APPLY_UF ? term.getOperator() : term[0];
+    funcToArgs[func].insert(term);
+  }
+
+  FunctionToArgs::const_iterator it = funcToArgs.begin();
   NodeManager* nm = NodeManager::currentNM();
-  for (; it!= d_funcToArgs.end(); ++it) {
+  for (; it!= funcToArgs.end(); ++it) {
     TNode func = it->first;
     const NodeSet& args = it->second;
     NodeSet::const_iterator it1 = args.begin();
@@ -424,10 +436,19 @@ void TheoryBV::check(Effort e)
       Assert (fact.getKind() == kind::BITVECTOR_EAGER_ATOM);
       assertions.push_back(fact);
     }
-    Assert (d_eagerSolver->hasAssertions(assertions));
+    Assert (options::incrementalSolving() ||
+            d_eagerSolver->hasAssertions(assertions));
 
     bool ok = d_eagerSolver->checkSat();
     if (!ok) {
+      if (options::incrementalSolving()) {
+        // formulas asserted for earlier check-sat calls are part of the
+        // conflict as well
+        std::vector<Node> atoms;
+        d_eagerSolver->getAssertedAtoms(atoms);
+        d_out->conflict(utils::mkAnd(atoms));
+        return;
+      }
       if (assertions.size() == 1) {
         d_out->conflict(assertions[0]);
         return;
@@ -995,7 +1016,7 @@ bool TheoryBV::applyAbstraction(const std::vector<Node>& assertions, std::vector
   bool changed = d_abstractionModule->applyAbstraction(assertions, new_assertions);
   if (changed &&
       options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER &&
-      options::bitvectorAig()) {
+      (options::bitvectorAig() || options::bitvectorNativeAig())) {
     // disable AIG mode
     AlwaysAssert (!d_eagerSolver->isInitialized());
     d_eagerSolver->turnOffAig();
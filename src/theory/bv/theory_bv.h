@@ -145,8 +145,9 @@ private:
 
   typedef __gnu_cxx::hash_map<Node, NodeSet, NodeHashFunction>  FunctionToArgs;
   typedef __gnu_cxx::hash_map<Node, Node, NodeHashFunction>  NodeToNode;
-  // for ackermanization
-  FunctionToArgs d_funcToArgs;
+  // for ackermanization, the applications of functions and arrays and their
+  // skolems, both in the user context
+  context::CDList<Node> d_funcApps;
   CVC4::theory::SubstitutionMap d_funcToSkolem;
 
   context::CDO<bool> d_lemmasAdded;
@@ -232,10 +233,12 @@ private:
   friend class LazyBitblaster;
   friend class TLazyBitblaster;
   friend class EagerBitblaster;
+  friend class NativeAigBitblaster;
   friend class BitblastSolver;
   friend class EqualitySolver;
   friend class CoreSolver;
   friend class InequalitySolver;
+  friend class PropagationSolver;
   friend class AlgebraicSolver;
   friend class EagerBitblastSolver;
 };/* class TheoryBV */
@@ -711,7 +711,7 @@ Node BoundedIntegers::getSetRangeValue( Node q, Node v, RepSetIterator * rsi ) {
       TermArgTrie * ta = d_quantEngine->getTermDatabase()->getTermArgTrie( f );
       if( ta ){
         Trace("bound-int-rsi-debug") << "Got term index for " << f << std::endl;
-        for( std::map< TNode, TermArgTrie >::iterator it = ta->d_data.begin(); it != ta->d_data.end(); ++it ){
+        for( TermArgTrie::iterator it = ta->d_data.begin(); it != ta->d_data.end(); ++it ){
 
         }
 
@@ -812,8 +812,14 @@ bool BoundedIntegers::getBoundElements( RepSetIterator * rsi, bool initial, Node
           long rr = range.getConst<Rational>().getNumerator().getLong()+1;
           Trace("bound-int-rsi")  << "Actual bound range is " << rr << std::endl;
           for( unsigned k=0; k<rr; k++ ){
-            Node t = NodeManager::currentNM()->mkNode(PLUS, tl, NodeManager::currentNM()->mkConst( Rational(k) ) );
-            t = Rewriter::rewrite( t );
+            Node t;
+            if( tl.isConst() ){
+              //avoid rewriting for the common case of a constant lower bound
+              t = NodeManager::currentNM()->mkConst( tl.getConst<Rational>() + Rational(k) );
+            }else{
+              t = NodeManager::currentNM()->mkNode(PLUS, tl, NodeManager::currentNM()->mkConst( Rational(k) ) );
+              t = Rewriter::rewrite( t );
+            }
             elements.push_back( t );
           }
           return true;
@@ -17,16 +17,13 @@
 #ifndef __CVC4__THEORY__QUANTIFIERS__CANDIDATE_GENERATOR_H
 #define __CVC4__THEORY__QUANTIFIERS__CANDIDATE_GENERATOR_H
 
+#include "theory/quantifiers/term_database.h"
 #include "theory/theory.h"
 #include "theory/uf/equality_engine.h"
 
 namespace CVC4 {
 namespace theory {
 
-namespace quantifiers {
-  class TermArgTrie;
-}
-
 class QuantifiersEngine;
 
 namespace inst {
@@ -85,7 +82,7 @@ private:
   //the equality class iterator
   unsigned d_op_arity;
   std::vector< quantifiers::TermArgTrie* > d_tindex;
-  std::vector< std::map< TNode, quantifiers::TermArgTrie >::iterator > d_tindex_iter;
+  std::vector< quantifiers::TermArgTrie::iterator > d_tindex_iter;
   eq::EqClassIterator d_eqc_iter;
   //std::vector< Node > d_eqc;
   int d_term_iter;
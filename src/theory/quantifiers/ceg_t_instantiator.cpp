@@ -779,7 +779,7 @@ void EprInstantiator::computeMatchScore( CegInstantiator * ci, Node pv, Node cat
       }
     }
   }else{
-    std::map< TNode, TermArgTrie >::iterator it = tat->d_data.find( arg_reps[index] );
+    TermArgTrie::iterator it = tat->d_data.find( arg_reps[index] );
     if( it!=tat->d_data.end() ){
       computeMatchScore( ci, pv, catom, arg_reps, &it->second, index+1, match_score );
     }
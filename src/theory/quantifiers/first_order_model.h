@@ -34,6 +34,7 @@ class FirstOrderModelIG;
 
 namespace fmcheck {
   class FirstOrderModelFmc;
+  class ModelEvalCode;
 }/* CVC4::theory::quantifiers::fmcheck namespace */
 
 class FirstOrderModelQInt;
@@ -172,6 +173,7 @@ class Def;
 class FirstOrderModelFmc : public FirstOrderModel
 {
   friend class FullModelChecker;
+  friend class ModelEvalCode;
 private:
   /** models for UF */
   std::map<Node, Def * > d_models;
@@ -15,6 +15,7 @@
 #include "options/quantifiers_options.h"
 #include "theory/quantifiers/first_order_model.h"
 #include "theory/quantifiers/full_model_check.h"
+#include "theory/quantifiers/model_eval_code.h"
 #include "theory/quantifiers/term_database.h"
 
 using namespace std;
@@ -325,6 +326,12 @@ QModelBuilder( c, qe ){
   d_false = NodeManager::currentNM()->mkConst(false);
 }
 
+FullModelChecker::~FullModelChecker() throw() {
+  for( std::map< Node, ModelEvalCode * >::iterator it = d_eval_code.begin(); it != d_eval_code.end(); ++it ){
+    delete it->second;
+  }
+}
+
 void FullModelChecker::preProcessBuildModel(TheoryModel* m, bool fullModel) {
   //standard pre-process
   preProcessBuildModelStd( m, fullModel );
@@ -367,7 +374,9 @@ void FullModelChecker::processBuildModel(TheoryModel* m, bool fullModel){
   FirstOrderModelFmc * fm = ((FirstOrderModelFmc*)m)->asFirstOrderModelFmc();
   if( !fullModel ){
     Trace("fmc") << "---Full Model Check reset() " << std::endl;
-    d_quant_models.clear();
+    if( !options::fmfFmcIncremental() ){
+      d_quant_models.clear();
+    }
     d_rep_ids.clear();
     d_star_insts.clear();
     //process representatives
@@ -497,21 +506,51 @@ void FullModelChecker::processBuildModel(TheoryModel* m, bool fullModel){
       }
       std::sort( indices.begin(), indices.end(), mbas );
 
-      for (int i=0; i<(int)indices.size(); i++) {
-        fm->d_models[op]->addEntry(fm, entry_conds[indices[i]], values[indices[i]]);
+      //the definition only depends on its entries and the domains of the types of op
+      bool reuse = false;
+      if( options::fmfFmcIncremental() ){
+        std::vector< Node > sig;
+        TypeNode tno = op.getType();
+        for( unsigned i=0; i<tno.getNumChildren(); i++ ){
+          getTypeSignature( fm, tno[i], sig );
+        }
+        for (int i=0; i<(int)indices.size(); i++) {
+          sig.push_back( entry_conds[indices[i]] );
+          sig.push_back( values[indices[i]] );
+        }
+        std::map< Node, std::vector< Node > >::iterator its = d_def_sig.find( op );
+        if( its!=d_def_sig.end() && its->second==sig ){
+          reuse = true;
+        }else{
+          d_def_sig[op] = sig;
+          d_def_version[op]++;
+        }
       }
 
+      if( reuse ){
+        Trace("fmc-incremental") << "Reuse the definition of " << op << " from the previous round." << std::endl;
+        *fm->d_models[op] = d_def_cache[op];
+        ++(d_qe->d_statistics.d_fmc_defs_reused);
+      }else{
+        for (int i=0; i<(int)indices.size(); i++) {
+          fm->d_models[op]->addEntry(fm, entry_conds[indices[i]], values[indices[i]]);
+        }
 
-      if( options::mbqiMode()==quantifiers::MBQI_FMC_INTERVAL ){
-        convertIntervalModel( fm, op );
-      }
 
-      Trace("fmc-model-simplify") << "Before simplification : " << std::endl;
-      fm->d_models[op]->debugPrint("fmc-model-simplify", op, this);
-      Trace("fmc-model-simplify") << std::endl;
+        if( options::mbqiMode()==quantifiers::MBQI_FMC_INTERVAL ){
+          convertIntervalModel( fm, op );
+        }
+
+        Trace("fmc-model-simplify") << "Before simplification : " << std::endl;
+        fm->d_models[op]->debugPrint("fmc-model-simplify", op, this);
+        Trace("fmc-model-simplify") << std::endl;
 
-      Trace("fmc-model-simplify") << "Simplifying " << op << "..." << std::endl;
-      fm->d_models[op]->simplify( this, fm );
+        Trace("fmc-model-simplify") << "Simplifying " << op << "..." << std::endl;
+        fm->d_models[op]->simplify( this, fm );
+        if( options::fmfFmcIncremental() ){
+          d_def_cache[op] = *fm->d_models[op];
+        }
+      }
 
       fm->d_models[op]->debugPrint("fmc-model", op, this);
       Trace("fmc-model") << std::endl;
@@ -611,11 +650,29 @@ int FullModelChecker::doExhaustiveInstantiation( FirstOrderModel * fm, Node f, i
       if( options::mbqiMode()==MBQI_NONE ){
         //just exhaustive instantiate
         Node c = mkCondDefault( fmfmc, f );
+        d_quant_models[f].reset();
         d_quant_models[f].addEntry( fmfmc, c, d_false );
         return exhaustiveInstantiate( fmfmc, f, c, -1);
       }else{
-        //model check the quantifier
-        doCheck(fmfmc, f, d_quant_models[f], f[1]);
+        //model check the quantifier, unless nothing it depends on changed since it was last checked
+        bool reuse = false;
+        if( options::fmfFmcIncremental() ){
+          std::vector< Node > sig;
+          getQuantifierSignature( fmfmc, f, sig );
+          std::map< Node, std::vector< Node > >::iterator its = d_quant_sig.find( f );
+          if( its!=d_quant_sig.end() && its->second==sig && d_quant_models.find( f )!=d_quant_models.end() ){
+            reuse = true;
+          }else{
+            d_quant_sig[f] = sig;
+          }
+        }
+        if( reuse ){
+          Trace("fmc-incremental") << "Reuse the definition of " << f << " from the previous round." << std::endl;
+          ++(d_qe->d_statistics.d_fmc_quants_reused);
+        }else{
+          d_quant_models[f].reset();
+          doCheck(fmfmc, f, d_quant_models[f], f[1]);
+        }
         Trace("fmc") << "Definition for quantifier " << f << " is : " << std::endl;
         d_quant_models[f].debugPrint("fmc", Node::null(), this);
         Trace("fmc") << std::endl;
@@ -769,8 +826,12 @@ bool FullModelChecker::exhaustiveInstantiate(FirstOrderModelFmc * fm, Node f, No
   if( riter.setQuantifier( f, &rbfe ) ){
     Trace("fmc-exh-debug") << "Set element domains..." << std::endl;
     int addedLemmas = 0;
+    ModelEvalCode * mec = options::fmfEvalCode() ? getEvalCode( f ) : NULL;
+    if( mec ){
+      addedLemmas = exhaustiveInstantiateEval( fm, f, riter, mec );
+    }
     //now do full iteration
-    while( !riter.isFinished() ){
+    while( !mec && !riter.isFinished() ){
       d_triedLemmas++;
       Trace("fmc-exh-debug") << "Inst : ";
       std::vector< Node > ev_inst;
@@ -825,6 +886,97 @@ bool FullModelChecker::exhaustiveInstantiate(FirstOrderModelFmc * fm, Node f, No
   }
 }
 
+ModelEvalCode * FullModelChecker::getEvalCode( Node f ) {
+  std::map< Node, ModelEvalCode * >::iterator it = d_eval_code.find( f );
+  if( it==d_eval_code.end() ){
+    ModelEvalCode * mec = new ModelEvalCode( f );
+    if( !mec->initialize() ){
+      delete mec;
+      mec = NULL;
+    }
+    d_eval_code[f] = mec;
+    return mec;
+  }
+  return it->second;
+}
+
+int FullModelChecker::exhaustiveInstantiateEval( FirstOrderModelFmc * fm, Node f, RepSetIterator& riter, ModelEvalCode * mec ) {
+  mec->reset( fm, this );
+  unsigned nvars = riter.getNumTerms();
+  unsigned chunk = options::fmfEvalChunk()==0 ? 1 : options::fmfEvalChunk();
+  int addedLemmas = 0;
+  //innermost range of bounded integers of each tuple, and of the last instantiation
+  unsigned curr_range = 0;
+  unsigned last_range = 0;
+  std::vector< std::vector< Node > > insts;
+  std::vector< unsigned > ranges;
+  std::vector< int64_t > vals;
+  std::vector< char > known;
+  std::vector< int > res;
+  while( !riter.isFinished() ){
+    //collect the values of a chunk of tuples
+    insts.clear();
+    ranges.clear();
+    vals.clear();
+    known.clear();
+    while( !riter.isFinished() && insts.size()<chunk ){
+      d_triedLemmas++;
+      insts.push_back( std::vector< Node >() );
+      for( unsigned i=0; i<nvars; i++ ){
+        Node rr = riter.getCurrentTerm( i );
+        int64_t v = 0;
+        known.push_back( mec->getVariableValue( fm, i, rr, v ) ? 1 : 0 );
+        vals.push_back( v );
+        insts.back().push_back( rr );
+      }
+      ranges.push_back( curr_range );
+      int index = riter.increment();
+      if( !riter.isFinished() ){
+        if( index>=0 && riter.d_index[index]>0 && addedLemmas>0 && riter.d_enum_type[index]==RepSetIterator::ENUM_BOUND_INT ){
+          //as in exhaustiveInstantiate, skip the rest of a range enumeration once an instantiation was added
+          Trace("fmc-exh-debug") << "Since this is a range enumeration, skip to the next..." << std::endl;
+          riter.increment2( index-1 );
+          curr_range++;
+        }else if( index!=(int)nvars-1 ||
+                  riter.d_enum_type[riter.getVariableOrder( index )]!=RepSetIterator::ENUM_BOUND_INT ){
+          curr_range++;
+        }
+      }
+    }
+    //evaluate the chunk, and instantiate only for tuples that are not true
+    mec->evaluate( fm, this, insts.size(), vals, known, res );
+    d_qe->d_statistics.d_fmc_eval_tuples += insts.size();
+    for( unsigned t=0; t<insts.size(); t++ ){
+      if( res[t]==1 ){
+        ++(d_qe->d_statistics.d_fmc_eval_filtered);
+      }else if( addedLemmas>0 && ranges[t]==last_range ){
+        //the rest of the chunk was enumerated before the instantiation was added,
+        //skip its tuples in the same range as the enumeration above would have
+        Trace("fmc-exh-debug") << "Skip falsified tuple in range enumeration." << std::endl;
+      }else if( d_qe->addInstantiation( f, insts[t], true ) ){
+        Trace("fmc-exh-debug") << "Added instantiation for tuple with value " << res[t] << std::endl;
+        addedLemmas++;
+        last_range = ranges[t];
+        if( d_qe->inConflict() || options::fmfOneInstPerRound() ){
+          return addedLemmas;
+        }
+      }
+    }
+  }
+  return addedLemmas;
+}
+
+Node FullModelChecker::evaluateUf( FirstOrderModelFmc * fm, Node op, std::vector< Node >& args ) {
+  std::map< Node, Def * >::iterator it = fm->d_models.find( op );
+  if( it==fm->d_models.end() ){
+    return Node::null();
+  }
+  for( unsigned i=0; i<args.size(); i++ ){
+    args[i] = fm->getUsedRepresentative( args[i] );
+  }
+  return it->second->evaluate( fm, args );
+}
+
 void FullModelChecker::doCheck(FirstOrderModelFmc * fm, Node f, Def & d, Node n ) {
   Trace("fmc-debug") << "Check " << n << " " << n.getKind() << std::endl;
   //first check if it is a bounding literal
@@ -921,6 +1073,67 @@ void FullModelChecker::doCheck(FirstOrderModelFmc * fm, Node f, Def & d, Node n
   Trace("fmc-debug") << std::endl;
 }
 
+void FullModelChecker::getTypeSignature( FirstOrderModelFmc * fm, TypeNode tn, std::vector< Node >& sig ) {
+  std::map< TypeNode, std::vector< Node > >::iterator it = fm->d_rep_set.d_type_reps.find( tn );
+  if( it==fm->d_rep_set.d_type_reps.end() ){
+    sig.push_back( NodeManager::currentNM()->mkConst( Rational(0) ) );
+  }else{
+    sig.push_back( NodeManager::currentNM()->mkConst( Rational(it->second.size()) ) );
+    sig.insert( sig.end(), it->second.begin(), it->second.end() );
+  }
+}
+
+void FullModelChecker::collectDependencies( Node n, std::vector< Node >& deps, std::map< Node, bool >& visited ) {
+  if( visited.find( n )==visited.end() ){
+    visited[n] = true;
+    //mirrors the cases of doCheck
+    if( n.hasAttribute(BoundIntLitAttribute()) || n.getKind()==kind::BOUND_VARIABLE ||
+        n.getKind()==kind::FORALL || n.getType().isArray() ){
+      //does not depend on the model
+    }else if( n.getNumChildren()==0 ){
+      if( !n.isConst() ){
+        deps.push_back( n );
+      }
+    }else{
+      if( n.getKind()==APPLY_UF ){
+        Node op = n.getOperator();
+        if( visited.find( op )==visited.end() ){
+          visited[op] = true;
+          deps.push_back( op );
+        }
+      }
+      for( unsigned i=0; i<n.getNumChildren(); i++ ){
+        collectDependencies( n[i], deps, visited );
+      }
+    }
+  }
+}
+
+void FullModelChecker::getQuantifierSignature( FirstOrderModelFmc * fm, Node f, std::vector< Node >& sig ) {
+  for( unsigned i=0; i<f[0].getNumChildren(); i++ ){
+    getTypeSignature( fm, f[0][i].getType(), sig );
+  }
+  std::map< Node, std::vector< Node > >::iterator it = d_quant_deps.find( f );
+  if( it==d_quant_deps.end() ){
+    std::map< Node, bool > visited;
+    collectDependencies( f[1], d_quant_deps[f], visited );
+    it = d_quant_deps.find( f );
+  }
+  for( unsigned i=0; i<it->second.size(); i++ ){
+    Node n = it->second[i];
+    if( n.getType().isFunction() ){
+      sig.push_back( NodeManager::currentNM()->mkConst( Rational(d_def_version[n]) ) );
+    }else{
+      //the value of a ground term, as computed by doCheck
+      Node r = n;
+      if( !fm->hasTerm( n ) ){
+        r = getSomeDomainElement( fm, n.getType() );
+      }
+      sig.push_back( fm->getUsedRepresentative( r ) );
+    }
+  }
+}
+
 void FullModelChecker::doNegate( Def & dc ) {
   for (unsigned i=0; i<dc.d_cond.size(); i++) {
     if (!dc.d_value[i].isNull()) {
@@ -28,6 +28,7 @@ namespace fmcheck {
 
 class FirstOrderModelFmc;
 class FullModelChecker;
+class ModelEvalCode;
 
 class EntryTrie
 {
@@ -84,6 +85,7 @@ public:
 
 class FullModelChecker : public QModelBuilder
 {
+  friend class ModelEvalCode;
 protected:
   Node d_true;
   Node d_false;
@@ -94,6 +96,23 @@ protected:
   std::map< Node, Node > d_array_term_cond;
   std::map< Node, std::vector< int > > d_star_insts;
   std::map< TypeNode, bool > d_preinitialized_types;
+  /** for each function, the inputs its definition was last built from, and the definition */
+  std::map< Node, std::vector< Node > > d_def_sig;
+  std::map< Node, Def > d_def_cache;
+  /** for each function, the number of times its definition changed */
+  std::map< Node, unsigned > d_def_version;
+  /** for each quantified formula, the functions and ground terms its definition depends on */
+  std::map< Node, std::vector< Node > > d_quant_deps;
+  /** for each quantified formula, the inputs d_quant_models was last computed from */
+  std::map< Node, std::vector< Node > > d_quant_sig;
+  void getTypeSignature( FirstOrderModelFmc * fm, TypeNode tn, std::vector< Node >& sig );
+  void collectDependencies( Node n, std::vector< Node >& deps, std::map< Node, bool >& visited );
+  void getQuantifierSignature( FirstOrderModelFmc * fm, Node f, std::vector< Node >& sig );
+  /** compiled bodies of quantified formulas, NULL if they cannot be compiled */
+  std::map< Node, ModelEvalCode * > d_eval_code;
+  ModelEvalCode * getEvalCode( Node f );
+  /** exhaustive instantiation of f on the tuples of riter that are not true according to mec */
+  int exhaustiveInstantiateEval( FirstOrderModelFmc * fm, Node f, RepSetIterator& riter, ModelEvalCode * mec );
   void preInitializeType( FirstOrderModelFmc * fm, TypeNode tn );
   Node normalizeArgReps(FirstOrderModelFmc * fm, Node op, Node n);
   bool exhaustiveInstantiate(FirstOrderModelFmc * fm, Node f, Node c, int c_index);
@@ -134,7 +153,7 @@ private:
   Node getSomeDomainElement( FirstOrderModelFmc * fm, TypeNode tn );
 public:
   FullModelChecker( context::Context* c, QuantifiersEngine* qe );
-  ~FullModelChecker() throw() {}
+  ~FullModelChecker() throw();
 
   void debugPrintCond(const char * tr, Node n, bool dispStar = false);
   void debugPrint(const char * tr, Node n, bool dispStar = false);
@@ -142,6 +161,8 @@ public:
   int doExhaustiveInstantiation( FirstOrderModel * fm, Node f, int effort );
 
   Node getFunctionValue(FirstOrderModelFmc * fm, Node op, const char* argPrefix );
+  /** evaluate op applied to the values args, returns null if op has no definition */
+  Node evaluateUf( FirstOrderModelFmc * fm, Node op, std::vector< Node >& args );
 
   /** process build model */  
   void preProcessBuildModel(TheoryModel* m, bool fullModel); 
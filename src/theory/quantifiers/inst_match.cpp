@@ -476,6 +476,107 @@ void CDInstMatchTrie::getExplanationForInstLemmas( Node q, std::vector< Node >&
   }
 }
 
+size_t InstMatchHashFunction::operator()( const std::vector< Node >& m ) const {
+  size_t h = 0;
+  for( unsigned i=0; i<m.size(); i++ ){
+    h = h*31 + NodeHashFunction()( m[i] );
+  }
+  return h;
+}
+
+void InstMatchBloomFilter::getPositions( size_t h, size_t& p1, size_t& p2 ) const {
+  uint64_t x = uint64_t( h ) * 0x9E3779B97F4A7C15ULL;
+  size_t nbits = d_bits.size()*64;
+  p1 = size_t( x % nbits );
+  p2 = size_t( ( x >> 32 ) % nbits );
+}
+
+bool InstMatchBloomFilter::mayContain( size_t h ) const {
+  size_t p1, p2;
+  getPositions( h, p1, p2 );
+  return ( d_bits[p1/64] & ( uint64_t( 1 ) << ( p1%64 ) ) )!=0 &&
+         ( d_bits[p2/64] & ( uint64_t( 1 ) << ( p2%64 ) ) )!=0;
+}
+
+void InstMatchBloomFilter::add( size_t h ) {
+  size_t p1, p2;
+  getPositions( h, p1, p2 );
+  d_bits[p1/64] |= uint64_t( 1 ) << ( p1%64 );
+  d_bits[p2/64] |= uint64_t( 1 ) << ( p2%64 );
+  d_size++;
+}
+
+void InstMatchBloomFilter::reset( bool grow ) {
+  unsigned nwords = grow ? d_bits.size()*2 : d_bits.size();
+  d_bits.clear();
+  d_bits.resize( nwords, 0 );
+  d_size = 0;
+}
+
+bool InstMatchHashSet::contains( std::vector< Node >& m, size_t h, bool& filtered ) const {
+  if( !d_filter.mayContain( h ) ){
+    filtered = true;
+    return false;
+  }
+  filtered = false;
+  return d_data.find( m )!=d_data.end();
+}
+
+void InstMatchHashSet::add( std::vector< Node >& m, size_t h ) {
+  if( d_data.insert( m ).second ){
+    d_filter.add( h );
+    if( d_filter.needsResize() ){
+      d_filter.reset( true );
+      InstMatchHashFunction imhf;
+      for( NodeVecSet::const_iterator it = d_data.begin(); it != d_data.end(); ++it ){
+        d_filter.add( imhf( *it ) );
+      }
+    }
+  }
+}
+
+bool InstMatchHashSet::remove( std::vector< Node >& m ) {
+  return d_data.erase( m )>0;
+}
+
+void InstMatchHashSet::clear() {
+  d_data.clear();
+  d_filter.reset( false );
+}
+
+bool CDInstMatchHashSet::contains( std::vector< Node >& m, size_t h, bool& filtered ) const {
+  if( !d_filter.mayContain( h ) ){
+    filtered = true;
+    return false;
+  }
+  filtered = false;
+  NodeVecBoolMap::const_iterator it = d_data.find( m );
+  return it!=d_data.end() && (*it).second;
+}
+
+void CDInstMatchHashSet::add( std::vector< Node >& m, size_t h ) {
+  d_data.insert( m, true );
+  d_filter.add( h );
+  if( d_filter.needsResize() ){
+    //the entries of popped contexts are no longer in d_data, and need not be added
+    d_filter.reset( true );
+    InstMatchHashFunction imhf;
+    for( NodeVecBoolMap::const_iterator it = d_data.begin(); it != d_data.end(); ++it ){
+      d_filter.add( imhf( (*it).first ) );
+    }
+  }
+}
+
+bool CDInstMatchHashSet::remove( std::vector< Node >& m ) {
+  NodeVecBoolMap::const_iterator it = d_data.find( m );
+  if( it!=d_data.end() && (*it).second ){
+    d_data.insert( m, false );
+    return true;
+  }else{
+    return false;
+  }
+}
+
 }/* CVC4::theory::inst namespace */
 }/* CVC4::theory namespace */
 }/* CVC4 namespace */
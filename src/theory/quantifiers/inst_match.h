@@ -18,9 +18,11 @@
 #define __CVC4__THEORY__QUANTIFIERS__INST_MATCH_H
 
 #include "util/hash.h"
+#include "context/cdhashmap.h"
 #include "context/cdo.h"
 
 #include <ext/hash_set>
+#include <stdint.h>
 #include <map>
 
 #include "context/cdlist.h"
@@ -212,6 +214,72 @@ public:
   }  
 };/* class CDInstMatchTrie */
 
+/** hash function for term vectors */
+struct InstMatchHashFunction {
+  size_t operator()( const std::vector< Node >& m ) const;
+};/* struct InstMatchHashFunction */
+
+/** Bloom filter for term vectors
+ * Answers that a term vector was never added without probing a hash set.
+ * Bits are never removed, so removed term vectors are only false positives.
+ */
+class InstMatchBloomFilter {
+private:
+  std::vector< uint64_t > d_bits;
+  /** number of term vectors added since the last resize */
+  unsigned d_size;
+  /** the two bit positions for hash h */
+  void getPositions( size_t h, size_t& p1, size_t& p2 ) const;
+public:
+  InstMatchBloomFilter() : d_bits( 16, 0 ), d_size( 0 ) {}
+  /** is the term vector with hash h possibly added */
+  bool mayContain( size_t h ) const;
+  /** add the term vector with hash h */
+  void add( size_t h );
+  /** whether there are too many term vectors for the number of bits */
+  bool needsResize() const { return d_size*8>d_bits.size()*64; }
+  /** clear, with at least twice as many bits if grow is true */
+  void reset( bool grow );
+};/* class InstMatchBloomFilter */
+
+/** set of term vectors added for a quantified formula
+ * This answers the common queries for exact duplicates in expected constant time,
+ * without traversing the InstMatchTrie that stores the same term vectors.
+ */
+class InstMatchHashSet {
+  typedef std::hash_set< std::vector< Node >, InstMatchHashFunction > NodeVecSet;
+private:
+  NodeVecSet d_data;
+  InstMatchBloomFilter d_filter;
+public:
+  InstMatchHashSet(){}
+  ~InstMatchHashSet(){}
+  /** is m in this set, h is the hash of m */
+  bool contains( std::vector< Node >& m, size_t h, bool& filtered ) const;
+  /** add m to this set, h is the hash of m */
+  void add( std::vector< Node >& m, size_t h );
+  /** remove m from this set */
+  bool remove( std::vector< Node >& m );
+  void clear();
+};/* class InstMatchHashSet */
+
+/** context-dependent set of term vectors added for a quantified formula */
+class CDInstMatchHashSet {
+  typedef context::CDHashMap< std::vector< Node >, bool, InstMatchHashFunction > NodeVecBoolMap;
+private:
+  NodeVecBoolMap d_data;
+  InstMatchBloomFilter d_filter;
+public:
+  CDInstMatchHashSet( context::Context* c ) : d_data( c ){}
+  ~CDInstMatchHashSet(){}
+  /** is m in this set, h is the hash of m */
+  bool contains( std::vector< Node >& m, size_t h, bool& filtered ) const;
+  /** add m to this set in the current context, h is the hash of m */
+  void add( std::vector< Node >& m, size_t h );
+  /** remove m from this set in the current context */
+  bool remove( std::vector< Node >& m );
+};/* class CDInstMatchHashSet */
+
 
 class InstMatchTrieOrdered{
 private:
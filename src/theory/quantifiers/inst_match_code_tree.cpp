@@ -0,0 +1,455 @@
+/*********************                                                        */
+/*! \file inst_match_code_tree.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the code tree for E-matching single triggers
+ **/
+
+#include "theory/quantifiers/inst_match_code_tree.h"
+
+#include <algorithm>
+
+#include "options/quantifiers_options.h"
+#include "theory/quantifiers/term_database.h"
+#include "theory/quantifiers/trigger.h"
+#include "theory/quantifiers_engine.h"
+#include "theory/uf/equality_engine.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+
+namespace CVC4 {
+namespace theory {
+namespace inst {
+
+CodeTreeNode::~CodeTreeNode() {
+  for( unsigned i=0; i<d_children.size(); i++ ){
+    delete d_children[i];
+  }
+}
+
+InstMatchCodeTree::InstMatchCodeTree( context::Context* c, QuantifiersEngine* qe ) :
+  d_qe( qe ), d_merges_base( 0 ), d_context( c ), d_stamp_count( 0 ) {
+
+}
+
+InstMatchCodeTree::~InstMatchCodeTree() {
+  for( std::map< Node, CodeTreeRoot* >::iterator it = d_roots.begin(); it != d_roots.end(); ++it ){
+    for( unsigned i=0; i<it->second->d_yields.size(); i++ ){
+      delete it->second->d_yields[i];
+    }
+    delete it->second;
+  }
+}
+
+bool InstMatchCodeTree::compile( Node q, Node pat, unsigned base, std::vector< CodeTreeInstruction >& code,
+                                 std::map< Node, unsigned >& var_reg, unsigned& num_regs, unsigned& depth ) {
+  //first check the arguments that are variables or ground terms, then match the nested terms
+  std::vector< unsigned > nested;
+  for( unsigned i=0; i<pat.getNumChildren(); i++ ){
+    Node c = pat[i];
+    unsigned reg = base + i;
+    if( c.getKind()==INST_CONSTANT && quantifiers::TermDb::getInstConstAttr( c )==q ){
+      std::map< Node, unsigned >::iterator it = var_reg.find( c );
+      if( it==var_reg.end() ){
+        var_reg[c] = reg;
+      }else{
+        code.push_back( CodeTreeInstruction( CodeTreeInstruction::COMPARE, it->second, reg, Node::null() ) );
+      }
+    }else if( c.getKind()==INST_CONSTANT || !quantifiers::TermDb::hasInstConstAttr( c ) ){
+      code.push_back( CodeTreeInstruction( CodeTreeInstruction::CHECK, reg, 0, c ) );
+    }else if( Trigger::isAtomicTrigger( c ) && !Trigger::isBooleanTermTrigger( c ) &&
+              ( !options::purifyTriggers() || Trigger::getInversionVariable( c ).isNull() ) &&
+              ( c.getKind()!=APPLY_SELECTOR_TOTAL || !options::purifyDtTriggers() ) ){
+      nested.push_back( i );
+    }else{
+      Trace("inst-code-tree") << "...cannot compile " << c << std::endl;
+      return false;
+    }
+  }
+  depth = 1;
+  for( unsigned j=0; j<nested.size(); j++ ){
+    Node c = pat[nested[j]];
+    Node op = d_qe->getTermDatabase()->getMatchOperator( c );
+    if( op.isNull() ){
+      return false;
+    }
+    unsigned cbase = num_regs;
+    num_regs += c.getNumChildren();
+    code.push_back( CodeTreeInstruction( CodeTreeInstruction::BIND, base + nested[j], cbase, op ) );
+    unsigned cdepth = 0;
+    if( !compile( q, c, cbase, code, var_reg, num_regs, cdepth ) ){
+      return false;
+    }
+    depth = cdepth + 1 > depth ? cdepth + 1 : depth;
+  }
+  return true;
+}
+
+CodeTreeYield* InstMatchCodeTree::registerTrigger( Node q, Node pat ) {
+  //single triggers whose arguments are variables or ground terms are handled by InstMatchGeneratorSimple
+  if( !Trigger::isAtomicTrigger( pat ) || Trigger::isSimpleTrigger( pat ) ||
+      ( pat.getKind()==APPLY_SELECTOR_TOTAL && options::purifyDtTriggers() ) ){
+    return NULL;
+  }
+  Node op = d_qe->getTermDatabase()->getMatchOperator( pat );
+  if( op.isNull() ){
+    return NULL;
+  }
+  std::vector< CodeTreeInstruction > code;
+  std::map< Node, unsigned > var_reg;
+  unsigned num_regs = pat.getNumChildren();
+  unsigned depth = 0;
+  if( !compile( q, pat, 0, code, var_reg, num_regs, depth ) ){
+    return NULL;
+  }
+  CodeTreeRoot* root;
+  std::map< Node, CodeTreeRoot* >::iterator itr = d_roots.find( op );
+  if( itr==d_roots.end() ){
+    root = new CodeTreeRoot;
+    root->d_arity = pat.getNumChildren();
+    d_roots[op] = root;
+  }else{
+    root = itr->second;
+  }
+  root->d_depth = depth > root->d_depth ? depth : root->d_depth;
+  root->d_num_regs = num_regs > root->d_num_regs ? num_regs : root->d_num_regs;
+  //insert the code into the tree, sharing the longest prefix with the code of other triggers
+  CodeTreeNode* n = &root->d_node;
+  for( unsigned i=0; i<code.size(); i++ ){
+    CodeTreeNode* next = NULL;
+    for( unsigned j=0; j<n->d_children.size(); j++ ){
+      if( n->d_children[j]->d_inst==code[i] ){
+        next = n->d_children[j];
+        break;
+      }
+    }
+    if( next ){
+      ++(d_qe->d_statistics.d_code_tree_shared);
+    }else{
+      next = new CodeTreeNode( code[i] );
+      n->d_children.push_back( next );
+      ++(d_qe->d_statistics.d_code_tree_instructions);
+    }
+    n = next;
+  }
+  CodeTreeYield* y = new CodeTreeYield( d_context, q, op );
+  y->d_node = n;
+  for( std::map< Node, unsigned >::iterator it = var_reg.begin(); it != var_reg.end(); ++it ){
+    y->d_vars.push_back( std::pair< int, unsigned >( it->first.getAttribute(InstVarNumAttribute()), it->second ) );
+  }
+  n->d_yields.push_back( y );
+  root->d_yields.push_back( y );
+  Trace("inst-code-tree") << "Registered trigger " << pat << " for " << q << ", " << code.size() << " instructions." << std::endl;
+  return y;
+}
+
+void InstMatchCodeTree::unregisterTrigger( CodeTreeYield* y ) {
+  std::vector< CodeTreeYield* >& ny = y->d_node->d_yields;
+  ny.erase( std::find( ny.begin(), ny.end(), y ) );
+  std::vector< CodeTreeYield* >& ry = d_roots[y->d_op]->d_yields;
+  ry.erase( std::find( ry.begin(), ry.end(), y ) );
+  delete y;
+}
+
+void InstMatchCodeTree::resetInstantiationRound( CodeTreeYield* y ) {
+  if( !y->d_matches.empty() ){
+    //the matches of the last round were not all added, they will be found again
+    y->d_matches.clear();
+    y->d_synced = false;
+  }
+  unsigned throttled = d_qe->getNumThrottledInstantiations();
+  if( throttled!=y->d_throttled_count ){
+    //matches handed out since the last reset may have been throttled, they are not
+    // recorded as instantiations and must be found again
+    y->d_throttled_count = throttled;
+    y->d_synced = false;
+  }
+  y->d_needs_run = true;
+}
+
+bool InstMatchCodeTree::isLegalCandidate( Node t, bool top ) {
+  quantifiers::TermDb* tdb = d_qe->getTermDatabase();
+  if( !tdb->isTermActive( t ) || ( options::cbqi() && quantifiers::TermDb::hasInstConstAttr( t ) ) ){
+    return false;
+  }
+  return !top || tdb->hasTermCurrent( t );
+}
+
+bool InstMatchCodeTree::isSynced( CodeTreeYield* y ) {
+  //terms that are not current or not eligible may become so without new terms or merges
+  if( options::termDbMode()!=quantifiers::TERM_DB_ALL || options::lteRestrictInstClosure() ){
+    return false;
+  }
+  //if the context was popped below the last execution, inactive terms may have become active again
+  return y->d_synced && y->d_valid_stamp.get()==y->d_stamp && y->d_merge_pos>=d_merges_base;
+}
+
+bool InstMatchCodeTree::getNextMatch( CodeTreeYield* y, InstMatch& m ) {
+  if( y->d_needs_run ){
+    run( y->d_op, d_roots[y->d_op], y );
+  }
+  if( y->d_matches.empty() ){
+    return false;
+  }else{
+    m.clear();
+    m.add( y->d_matches.back() );
+    y->d_matches.pop_back();
+    return true;
+  }
+}
+
+int InstMatchCodeTree::addInstantiations( CodeTreeYield* y ) {
+  if( y->d_needs_run ){
+    run( y->d_op, d_roots[y->d_op], y );
+  }
+  int addedLemmas = 0;
+  unsigned i = 0;
+  while( i<y->d_matches.size() ){
+    InstMatch& m = y->d_matches[i];
+    i++;
+    if( d_qe->addInstantiation( y->d_q, m ) ){
+      addedLemmas++;
+      if( d_qe->inConflict() ){
+        break;
+      }
+    }
+  }
+  y->d_matches.erase( y->d_matches.begin(), y->d_matches.begin() + i );
+  return addedLemmas;
+}
+
+void InstMatchCodeTree::run( Node op, CodeTreeRoot* root, CodeTreeYield* y ) {
+  quantifiers::TermDb* tdb = d_qe->getTermDatabase();
+  unsigned num_terms = tdb->getNumGroundTerms( op );
+  unsigned merge_end = d_merges_base + d_merges.size();
+  bool incremental = isSynced( y );
+  if( incremental && merge_end - y->d_merge_pos > num_terms ){
+    //matching all terms again is cheaper than finding the terms above the merged classes
+    incremental = false;
+    y->d_synced = false;
+  }
+  //execute the code of all triggers in the same state as y
+  for( unsigned i=0; i<root->d_yields.size(); i++ ){
+    CodeTreeYield* z = root->d_yields[i];
+    if( !z->d_needs_run ){
+      z->d_running = false;
+    }else if( incremental ){
+      z->d_running = isSynced( z ) && z->d_num_terms==y->d_num_terms && z->d_merge_pos==y->d_merge_pos;
+    }else{
+      z->d_running = !isSynced( z );
+    }
+  }
+  markActive( &root->d_node );
+  std::vector< Node > cands;
+  if( incremental ){
+    NodeSet visited;
+    for( unsigned i=y->d_num_terms; i<num_terms; i++ ){
+      Node t = tdb->getGroundTerm( op, i );
+      visited.insert( t );
+      cands.push_back( t );
+    }
+    if( y->d_merge_pos<merge_end ){
+      getMergeCandidates( op, root->d_depth, y->d_merge_pos, cands, visited );
+    }
+    ++(d_qe->d_statistics.d_code_tree_incremental_runs);
+  }else{
+    for( unsigned i=0; i<num_terms; i++ ){
+      cands.push_back( tdb->getGroundTerm( op, i ) );
+    }
+    ++(d_qe->d_statistics.d_code_tree_full_runs);
+  }
+  Trace("inst-code-tree") << "Run code tree for " << op << ( incremental ? " (incremental)" : "" )
+                          << ", " << cands.size() << " candidates." << std::endl;
+  std::vector< TNode > regs( root->d_num_regs );
+  for( unsigned i=0; i<cands.size(); i++ ){
+    Node t = cands[i];
+    if( t.getNumChildren()==root->d_arity && isLegalCandidate( t, true ) ){
+      ++(d_qe->d_statistics.d_code_tree_candidates);
+      for( unsigned j=0; j<root->d_arity; j++ ){
+        regs[j] = t[j];
+      }
+      execute( &root->d_node, regs );
+    }
+  }
+  //the matches of the running triggers are now complete for the current state
+  unsigned stamp = ++d_stamp_count;
+  for( unsigned i=0; i<root->d_yields.size(); i++ ){
+    CodeTreeYield* z = root->d_yields[i];
+    if( z->d_running ){
+      z->d_running = false;
+      z->d_needs_run = false;
+      z->d_synced = true;
+      z->d_num_terms = num_terms;
+      z->d_merge_pos = merge_end;
+      z->d_stamp = stamp;
+      z->d_valid_stamp = stamp;
+    }
+  }
+  if( d_merges.size()>s_max_merges ){
+    d_merges_base += d_merges.size();
+    d_merges.clear();
+  }
+}
+
+bool InstMatchCodeTree::markActive( CodeTreeNode* n ) {
+  n->d_active = false;
+  for( unsigned i=0; i<n->d_yields.size(); i++ ){
+    if( n->d_yields[i]->d_running ){
+      n->d_active = true;
+      break;
+    }
+  }
+  for( unsigned i=0; i<n->d_children.size(); i++ ){
+    if( markActive( n->d_children[i] ) ){
+      n->d_active = true;
+    }
+  }
+  return n->d_active;
+}
+
+void InstMatchCodeTree::execute( CodeTreeNode* n, std::vector< TNode >& regs ) {
+  for( unsigned i=0; i<n->d_yields.size(); i++ ){
+    CodeTreeYield* y = n->d_yields[i];
+    if( y->d_running ){
+      InstMatch m( y->d_q );
+      for( unsigned j=0; j<y->d_vars.size(); j++ ){
+        m.setValue( y->d_vars[j].first, regs[y->d_vars[j].second] );
+      }
+      Debug("inst-code-tree-debug") << "...match " << m << " for " << y->d_q << std::endl;
+      y->d_matches.push_back( m );
+    }
+  }
+  EqualityQuery* eq = d_qe->getEqualityQuery();
+  for( unsigned i=0; i<n->d_children.size(); i++ ){
+    CodeTreeNode* c = n->d_children[i];
+    if( !c->d_active ){
+      continue;
+    }
+    const CodeTreeInstruction& inst = c->d_inst;
+    if( inst.d_op==CodeTreeInstruction::CHECK ){
+      if( eq->areEqual( regs[inst.d_reg], inst.d_term ) ){
+        execute( c, regs );
+      }
+    }else if( inst.d_op==CodeTreeInstruction::COMPARE ){
+      if( eq->areEqual( regs[inst.d_reg], regs[inst.d_arg] ) ){
+        execute( c, regs );
+      }
+    }else{
+      Assert( inst.d_op==CodeTreeInstruction::BIND );
+      //the terms with the operator of the nested pattern in the equivalence class of the register
+      std::vector< TNode > terms;
+      TNode t = regs[inst.d_reg];
+      eq::EqualityEngine* ee = eq->getEngine();
+      if( ee->hasTerm( t ) ){
+        eq::EqClassIterator eqc_i( ee->getRepresentative( t ), ee );
+        while( !eqc_i.isFinished() ){
+          terms.push_back( *eqc_i );
+          ++eqc_i;
+        }
+      }else{
+        terms.push_back( t );
+      }
+      for( unsigned j=0; j<terms.size(); j++ ){
+        TNode s = terms[j];
+        if( s.hasOperator() && isLegalCandidate( s, false ) &&
+            d_qe->getTermDatabase()->getMatchOperator( s )==inst.d_term ){
+          for( unsigned k=0; k<s.getNumChildren(); k++ ){
+            regs[inst.d_arg + k] = s[k];
+          }
+          execute( c, regs );
+        }
+      }
+    }
+  }
+}
+
+void InstMatchCodeTree::getMergeCandidates( Node op, unsigned depth, unsigned pos,
+                                            std::vector< Node >& cands, NodeSet& visited ) {
+  updateParents();
+  eq::EqualityEngine* ee = d_qe->getEqualityQuery()->getEngine();
+  std::vector< Node > reps;
+  NodeSet reps_visited;
+  for( unsigned i=pos-d_merges_base; i<d_merges.size(); i++ ){
+    Node t[2] = { d_merges[i].first, d_merges[i].second };
+    for( unsigned j=0; j<2; j++ ){
+      if( ee->hasTerm( t[j] ) ){
+        Node r = ee->getRepresentative( t[j] );
+        if( reps_visited.insert( r ).second ){
+          reps.push_back( r );
+        }
+      }
+    }
+  }
+  //a merge may give new matches for the terms at most depth levels above it
+  for( unsigned d=0; d<depth && !reps.empty(); d++ ){
+    std::vector< Node > next;
+    for( unsigned i=0; i<reps.size(); i++ ){
+      eq::EqClassIterator eqc_i( reps[i], ee );
+      while( !eqc_i.isFinished() ){
+        std::map< Node, std::vector< std::pair< Node, Node > > >::iterator it = d_parents.find( *eqc_i );
+        ++eqc_i;
+        if( it==d_parents.end() ){
+          continue;
+        }
+        for( unsigned j=0; j<it->second.size(); j++ ){
+          Node p = it->second[j].first;
+          if( it->second[j].second==op && visited.insert( p ).second ){
+            cands.push_back( p );
+          }
+          if( d+1<depth && ee->hasTerm( p ) ){
+            Node pr = ee->getRepresentative( p );
+            if( reps_visited.insert( pr ).second ){
+              next.push_back( pr );
+            }
+          }
+        }
+      }
+    }
+    reps.swap( next );
+  }
+}
+
+void InstMatchCodeTree::updateParents() {
+  quantifiers::TermDb* tdb = d_qe->getTermDatabase();
+  for( std::map< Node, std::vector< Node > >::iterator it = tdb->d_op_map.begin(); it != tdb->d_op_map.end(); ++it ){
+    unsigned& count = d_parents_count[it->first];
+    for( ; count<it->second.size(); count++ ){
+      Node p = it->second[count];
+      for( unsigned j=0; j<p.getNumChildren(); j++ ){
+        d_parents[p[j]].push_back( std::pair< Node, Node >( p, it->first ) );
+      }
+    }
+  }
+}
+
+void InstMatchCodeTree::presolve() {
+  //the operator map of the term database may have been cleared
+  d_parents.clear();
+  d_parents_count.clear();
+  d_merges_base += d_merges.size();
+  d_merges.clear();
+  for( std::map< Node, CodeTreeRoot* >::iterator it = d_roots.begin(); it != d_roots.end(); ++it ){
+    for( unsigned i=0; i<it->second->d_yields.size(); i++ ){
+      it->second->d_yields[i]->d_synced = false;
+    }
+  }
+}
+
+void InstMatchCodeTree::eqNotifyPreMerge( TNode t1, TNode t2 ) {
+  if( !d_roots.empty() ){
+    d_merges.push_back( std::pair< Node, Node >( t1, t2 ) );
+  }
+}
+
+}/* CVC4::theory::inst namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,194 @@
+/*********************                                                        */
+/*! \file inst_match_code_tree.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief code tree for E-matching single triggers
+ **
+ ** Triggers are compiled into sequences of instructions over a set of
+ ** registers holding ground terms, in the style of the code trees of
+ ** Simplify and Z3.  The sequences of all triggers with the same top-level
+ ** operator are stored in a tree, so that instructions they have in common
+ ** are executed once per candidate term.  Between instantiation rounds, only
+ ** the candidate terms that are new, or that are above an equivalence class
+ ** that was merged, are matched again.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__QUANTIFIERS__INST_MATCH_CODE_TREE_H
+#define __CVC4__THEORY__QUANTIFIERS__INST_MATCH_CODE_TREE_H
+
+#include <ext/hash_set>
+#include <map>
+#include <vector>
+
+#include "context/cdo.h"
+#include "expr/node.h"
+#include "theory/quantifiers/inst_match.h"
+
+namespace CVC4 {
+namespace theory {
+
+class QuantifiersEngine;
+
+namespace inst {
+
+/** an instruction of the code tree */
+class CodeTreeInstruction {
+public:
+  enum {
+    /** continue if register d_reg is equal to the ground term d_term */
+    CHECK,
+    /** continue if registers d_reg and d_arg are equal (repeated variable) */
+    COMPARE,
+    /** for each term with match operator d_term in the equivalence class of
+     * register d_reg, load its arguments into the registers starting at d_arg */
+    BIND,
+  };
+  CodeTreeInstruction( int op, unsigned reg, unsigned arg, Node t ) :
+    d_op( op ), d_reg( reg ), d_arg( arg ), d_term( t ) {}
+  int d_op;
+  unsigned d_reg;
+  unsigned d_arg;
+  Node d_term;
+  bool operator==( const CodeTreeInstruction& i ) const {
+    return d_op==i.d_op && d_reg==i.d_reg && d_arg==i.d_arg && d_term==i.d_term;
+  }
+};/* class CodeTreeInstruction */
+
+class CodeTreeNode;
+
+/** a trigger registered in the code tree, and its pending matches */
+class CodeTreeYield {
+public:
+  CodeTreeYield( context::Context* c, Node q, Node op ) : d_q( q ), d_op( op ), d_node( NULL ),
+    d_needs_run( false ), d_running( false ), d_synced( false ),
+    d_num_terms( 0 ), d_merge_pos( 0 ), d_stamp( 0 ), d_valid_stamp( c, 0 ),
+    d_throttled_count( 0 ) {}
+  /** the quantified formula */
+  Node d_q;
+  /** the top-level operator of the trigger */
+  Node d_op;
+  /** the node of the code tree that yields matches for this trigger */
+  CodeTreeNode* d_node;
+  /** variable number and register for each variable of the trigger */
+  std::vector< std::pair< int, unsigned > > d_vars;
+  /** matches produced but not yet added as instantiations */
+  std::vector< InstMatch > d_matches;
+  /** whether the trigger was reset this round and has not been matched yet */
+  bool d_needs_run;
+  /** whether the trigger takes part in the current execution */
+  bool d_running;
+  /** whether the matches of the trigger are complete up to the state below */
+  bool d_synced;
+  /** number of ground terms of d_op matched so far */
+  unsigned d_num_terms;
+  /** position in the merge log matched so far */
+  unsigned d_merge_pos;
+  /** stamp of the last execution of the trigger */
+  unsigned d_stamp;
+  /** d_stamp as of the current context, differs from d_stamp if the context
+   * was popped below the last execution */
+  context::CDO< unsigned > d_valid_stamp;
+  /** number of instantiations rejected by throttling at the last reset */
+  unsigned d_throttled_count;
+};/* class CodeTreeYield */
+
+/** a node of the code tree */
+class CodeTreeNode {
+public:
+  CodeTreeNode( const CodeTreeInstruction& i ) : d_inst( i ), d_active( false ) {}
+  ~CodeTreeNode();
+  /** the instruction executed on entering this node */
+  CodeTreeInstruction d_inst;
+  /** the nodes executed after this one */
+  std::vector< CodeTreeNode* > d_children;
+  /** the triggers whose code ends at this node */
+  std::vector< CodeTreeYield* > d_yields;
+  /** whether a trigger below this node takes part in the current execution */
+  bool d_active;
+};/* class CodeTreeNode */
+
+/** the code tree of all triggers with a given top-level operator */
+class CodeTreeRoot {
+public:
+  CodeTreeRoot() : d_node( CodeTreeInstruction( -1, 0, 0, Node::null() ) ),
+    d_arity( 0 ), d_depth( 0 ), d_num_regs( 0 ) {}
+  CodeTreeNode d_node;
+  /** arity of the operator */
+  unsigned d_arity;
+  /** maximum nesting depth of the triggers */
+  unsigned d_depth;
+  /** number of registers used by the triggers */
+  unsigned d_num_regs;
+  /** the triggers registered in this tree */
+  std::vector< CodeTreeYield* > d_yields;
+};/* class CodeTreeRoot */
+
+class InstMatchCodeTree {
+  typedef std::hash_set< Node, NodeHashFunction > NodeSet;
+private:
+  /** reference to the quantifiers engine */
+  QuantifiersEngine* d_qe;
+  /** the code trees, for each top-level operator */
+  std::map< Node, CodeTreeRoot* > d_roots;
+  /** merges of the master equality engine, from position d_merges_base */
+  std::vector< std::pair< Node, Node > > d_merges;
+  unsigned d_merges_base;
+  /** number of merges after which the log is cleared */
+  static const unsigned s_max_merges = 4096;
+  /** the SAT context */
+  context::Context* d_context;
+  /** number of executions, each gets its own stamp */
+  unsigned d_stamp_count;
+  /** for each ground term, the atomic terms it is an argument of, and their match operators */
+  std::map< Node, std::vector< std::pair< Node, Node > > > d_parents;
+  /** number of ground terms of each operator added to d_parents */
+  std::map< Node, unsigned > d_parents_count;
+  /** compile the matching of the arguments of pat, stored starting at register base */
+  bool compile( Node q, Node pat, unsigned base, std::vector< CodeTreeInstruction >& code,
+                std::map< Node, unsigned >& var_reg, unsigned& num_regs, unsigned& depth );
+  /** is t a legal candidate for matching (as a top-level term if top is true) */
+  bool isLegalCandidate( Node t, bool top );
+  /** can the matches of y be extended from its last execution */
+  bool isSynced( CodeTreeYield* y );
+  /** execute the code tree of operator op for the triggers in the same state as y */
+  void run( Node op, CodeTreeRoot* root, CodeTreeYield* y );
+  /** mark the nodes that have a running trigger below them */
+  bool markActive( CodeTreeNode* n );
+  /** execute the code at node n */
+  void execute( CodeTreeNode* n, std::vector< TNode >& regs );
+  /** add the terms of op above the equivalence classes merged since position pos */
+  void getMergeCandidates( Node op, unsigned depth, unsigned pos,
+                           std::vector< Node >& cands, NodeSet& visited );
+  /** update d_parents with the ground terms added to the term database */
+  void updateParents();
+public:
+  InstMatchCodeTree( context::Context* c, QuantifiersEngine* qe );
+  ~InstMatchCodeTree();
+  /** register the single trigger pat for q, returns NULL if it cannot be compiled */
+  CodeTreeYield* registerTrigger( Node q, Node pat );
+  /** unregister a trigger */
+  void unregisterTrigger( CodeTreeYield* y );
+  /** reset instantiation round for trigger y */
+  void resetInstantiationRound( CodeTreeYield* y );
+  /** get the next match for y, matching it if it has not been matched this round */
+  bool getNextMatch( CodeTreeYield* y, InstMatch& m );
+  /** add the instantiations for the matches of y, returns the number added */
+  int addInstantiations( CodeTreeYield* y );
+  /** presolve (called once per user check-sat) */
+  void presolve();
+  /** notification when two equivalence classes of the master equality engine are merged */
+  void eqNotifyPreMerge( TNode t1, TNode t2 );
+};/* class InstMatchCodeTree */
+
+}/* CVC4::theory::inst namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__QUANTIFIERS__INST_MATCH_CODE_TREE_H */
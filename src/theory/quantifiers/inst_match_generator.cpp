@@ -17,6 +17,7 @@
 #include "expr/datatype.h"
 #include "options/quantifiers_options.h"
 #include "theory/quantifiers/candidate_generator.h"
+#include "theory/quantifiers/inst_match_code_tree.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers/trigger.h"
 #include "theory/quantifiers_engine.h"
@@ -744,7 +745,7 @@ int InstMatchGeneratorSimple::addInstantiations( Node q, InstMatch& baseMatch, Q
       //iterate over all classes except r
       tat = qe->getTermDatabase()->getTermArgTrie( Node::null(), d_op );
       if( tat ){
-        for( std::map< TNode, quantifiers::TermArgTrie >::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
+        for( quantifiers::TermArgTrie::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
           if( it->first!=r ){
             InstMatch m( q );
             m.add( baseMatch );
@@ -786,7 +787,7 @@ void InstMatchGeneratorSimple::addInstantiations( InstMatch& m, QuantifiersEngin
     if( d_match_pattern[argIndex].getKind()==INST_CONSTANT ){
       int v = d_var_num[argIndex];
       if( v!=-1 ){
-        for( std::map< TNode, quantifiers::TermArgTrie >::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
+        for( quantifiers::TermArgTrie::iterator it = tat->d_data.begin(); it != tat->d_data.end(); ++it ){
           Node t = it->first;
           Node prev = m.get( v );
           //using representatives, just check if equal
@@ -805,7 +806,7 @@ void InstMatchGeneratorSimple::addInstantiations( InstMatch& m, QuantifiersEngin
       //inst constant from another quantified formula, treat as ground term  TODO: remove this?
     }
     Node r = qe->getEqualityQuery()->getRepresentative( d_match_pattern[argIndex] );
-    std::map< TNode, quantifiers::TermArgTrie >::iterator it = tat->d_data.find( r );
+    quantifiers::TermArgTrie::iterator it = tat->d_data.find( r );
     if( it!=tat->d_data.end() ){
       addInstantiations( m, qe, addedLemmas, argIndex+1, &(it->second) );
     }
@@ -819,6 +820,43 @@ int InstMatchGeneratorSimple::getActiveScore( QuantifiersEngine * qe ) {
   return ngt;   
 }
 
+InstMatchGeneratorCodeTree::InstMatchGeneratorCodeTree( InstMatchCodeTree* ct, CodeTreeYield* y, Node op ) :
+  d_ct( ct ), d_yield( y ), d_op( op ){
+
+}
+
+InstMatchGeneratorCodeTree::~InstMatchGeneratorCodeTree() throw() {
+  d_ct->unregisterTrigger( d_yield );
+}
+
+InstMatchGeneratorCodeTree* InstMatchGeneratorCodeTree::mkInstMatchGeneratorCodeTree( Node q, Node pat, QuantifiersEngine* qe ) {
+  InstMatchCodeTree* ct = qe->getInstMatchCodeTree();
+  Assert( ct!=NULL );
+  CodeTreeYield* y = ct->registerTrigger( q, pat );
+  if( y ){
+    return new InstMatchGeneratorCodeTree( ct, y, qe->getTermDatabase()->getMatchOperator( pat ) );
+  }else{
+    return NULL;
+  }
+}
+
+void InstMatchGeneratorCodeTree::resetInstantiationRound( QuantifiersEngine* qe ) {
+  d_ct->resetInstantiationRound( d_yield );
+}
+
+bool InstMatchGeneratorCodeTree::getNextMatch( Node q, InstMatch& m, QuantifiersEngine* qe ) {
+  return d_ct->getNextMatch( d_yield, m );
+}
+
+int InstMatchGeneratorCodeTree::addInstantiations( Node q, InstMatch& baseMatch, QuantifiersEngine* qe ) {
+  return d_ct->addInstantiations( d_yield );
+}
+
+int InstMatchGeneratorCodeTree::getActiveScore( QuantifiersEngine * qe ) {
+  unsigned ngt = qe->getTermDatabase()->getNumGroundTerms( d_op );
+  Trace("trigger-active-sel-debug") << "Number of ground terms for (code tree) " << d_op << " is " << ngt << std::endl;
+  return ngt;
+}
 
 }/* CVC4::theory::inst namespace */
 }/* CVC4::theory namespace */
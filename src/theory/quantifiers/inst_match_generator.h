@@ -30,6 +30,9 @@ namespace quantifiers{
 
 namespace inst {
 
+class InstMatchCodeTree;
+class CodeTreeYield;
+
 /** base class for producing InstMatch objects */
 class IMGenerator {
 public:
@@ -238,6 +241,33 @@ public:
   int getActiveScore( QuantifiersEngine * qe );
 };/* class InstMatchGeneratorSimple */
 
+/** (single)-trigger implementation using the shared code tree */
+class InstMatchGeneratorCodeTree : public IMGenerator {
+private:
+  /** the code tree */
+  InstMatchCodeTree* d_ct;
+  /** the trigger in the code tree */
+  CodeTreeYield* d_yield;
+  /** match operator */
+  Node d_op;
+  InstMatchGeneratorCodeTree( InstMatchCodeTree* ct, CodeTreeYield* y, Node op );
+public:
+  /** destructor */
+  ~InstMatchGeneratorCodeTree() throw();
+  /** reset instantiation round (call this whenever equivalence classes have changed) */
+  void resetInstantiationRound( QuantifiersEngine* qe );
+  /** reset, eqc is the equivalence class to search in (any if eqc=null) */
+  void reset( Node eqc, QuantifiersEngine* qe ) {}
+  /** get the next match.  must call reset( eqc ) before this function. */
+  bool getNextMatch( Node q, InstMatch& m, QuantifiersEngine* qe );
+  /** add instantiations */
+  int addInstantiations( Node q, InstMatch& baseMatch, QuantifiersEngine* qe );
+  /** get active score */
+  int getActiveScore( QuantifiersEngine * qe );
+  /** make a generator for trigger pat of q, returns NULL if pat cannot be compiled into the code tree */
+  static InstMatchGeneratorCodeTree* mkInstMatchGeneratorCodeTree( Node q, Node pat, QuantifiersEngine* qe );
+};/* class InstMatchGeneratorCodeTree */
+
 }
 }
 }
@@ -0,0 +1,77 @@
+/*********************                                                        */
+/*! \file inst_profile.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of the instantiation profile statistic
+ **/
+
+#include "theory/quantifiers/inst_profile.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::quantifiers;
+
+namespace {
+
+/** a (:name value) pair; nested keywords are printed as is, so the colon is
+ * part of the keyword, as for the ones read by the smt2 parser */
+SExpr mkField( const char* name, SExpr value ) {
+  std::vector< SExpr > v;
+  v.push_back( SExpr( SExpr::Keyword( std::string( ":" ) + name ) ) );
+  v.push_back( value );
+  return SExpr( v );
+}
+
+SExpr mkTimeValue( double t ) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(6) << t;
+  return SExpr( Rational::fromDecimal( ss.str() ) );
+}
+
+}/* anonymous namespace */
+
+void InstProfileStat::flushInformation( std::ostream& out ) const {
+  out << getValue() << std::endl;
+}
+
+SExpr InstProfileStat::getValue() const {
+  std::vector< SExpr > profiles;
+  for( std::map< Node, InstProfile >::const_iterator it = d_profiles.begin(); it != d_profiles.end(); ++it ){
+    const InstProfile& ip = it->second;
+    std::vector< SExpr > v;
+    std::stringstream ss;
+    ss << it->first;
+    v.push_back( SExpr( ss.str() ) );
+    v.push_back( mkField( "instantiations", SExpr( ip.d_insts ) ) );
+    v.push_back( mkField( "duplicates", SExpr( ip.d_duplicates ) ) );
+    v.push_back( mkField( "conflicts", SExpr( ip.d_conflicts ) ) );
+    v.push_back( mkField( "throttled", SExpr( ip.d_throttled ) ) );
+    v.push_back( mkField( "max-generation", SExpr( (unsigned long int)ip.d_max_gen ) ) );
+    v.push_back( mkField( "match-time", mkTimeValue( ip.d_match_time ) ) );
+    v.push_back( mkField( "qcf-time", mkTimeValue( ip.d_qcf_time ) ) );
+    v.push_back( mkField( "mbqi-time", mkTimeValue( ip.d_mbqi_time ) ) );
+    std::vector< SExpr > triggers;
+    for( std::map< Node, TriggerProfile >::const_iterator itt = ip.d_triggers.begin(); itt != ip.d_triggers.end(); ++itt ){
+      std::vector< SExpr > vt;
+      std::stringstream sst;
+      sst << itt->first;
+      vt.push_back( SExpr( sst.str() ) );
+      vt.push_back( mkField( "calls", SExpr( itt->second.d_calls ) ) );
+      vt.push_back( mkField( "instantiations", SExpr( itt->second.d_insts ) ) );
+      vt.push_back( mkField( "time", mkTimeValue( itt->second.d_time ) ) );
+      triggers.push_back( SExpr( vt ) );
+    }
+    v.push_back( mkField( "triggers", SExpr( triggers ) ) );
+    profiles.push_back( SExpr( v ) );
+  }
+  return SExpr( profiles );
+}
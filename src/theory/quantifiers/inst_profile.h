@@ -0,0 +1,80 @@
+/*********************                                                        */
+/*! \file inst_profile.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief instantiation profile of quantified formulas and triggers
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__QUANTIFIERS__INST_PROFILE_H
+#define __CVC4__THEORY__QUANTIFIERS__INST_PROFILE_H
+
+#include <ctime>
+#include <map>
+
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace quantifiers {
+
+/** counters of a trigger */
+class TriggerProfile {
+public:
+  TriggerProfile() : d_calls( 0 ), d_insts( 0 ), d_time( 0 ) {}
+  /** number of times the trigger was matched */
+  unsigned d_calls;
+  /** number of instantiations added by matching the trigger */
+  unsigned d_insts;
+  /** time spent matching the trigger (in seconds) */
+  double d_time;
+};/* class TriggerProfile */
+
+/** counters of a quantified formula */
+class InstProfile {
+public:
+  InstProfile() : d_insts( 0 ), d_max_gen( 0 ), d_throttled( 0 ), d_duplicates( 0 ),
+    d_conflicts( 0 ), d_match_time( 0 ), d_qcf_time( 0 ), d_mbqi_time( 0 ) {}
+  /** number of instantiation lemmas */
+  unsigned d_insts;
+  /** maximum generation of its instantiations */
+  uint64_t d_max_gen;
+  /** number of instantiations rejected by throttling */
+  unsigned d_throttled;
+  /** number of instantiations rejected as duplicates */
+  unsigned d_duplicates;
+  /** number of conflicts found by its instantiations */
+  unsigned d_conflicts;
+  /** time spent in E-matching, conflict-based instantiation and model-based instantiation */
+  double d_match_time;
+  double d_qcf_time;
+  double d_mbqi_time;
+  /** the counters of its triggers */
+  std::map< Node, TriggerProfile > d_triggers;
+  /** get the current time (in seconds) */
+  static double getTime() { return double(clock())/double(CLOCKS_PER_SEC); }
+};/* class InstProfile */
+
+/** statistic that reports the profiles of all quantified formulas as a SExpr */
+class InstProfileStat : public Stat {
+private:
+  const std::map< Node, InstProfile >& d_profiles;
+public:
+  InstProfileStat( const std::string& name, const std::map< Node, InstProfile >& profiles ) :
+    Stat( name ), d_profiles( profiles ) {}
+  void flushInformation( std::ostream& out ) const;
+  SExpr getValue() const;
+};/* class InstProfileStat */
+
+}/* CVC4::theory::quantifiers namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__QUANTIFIERS__INST_PROFILE_H */
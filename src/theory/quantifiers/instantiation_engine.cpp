@@ -70,8 +70,13 @@ void InstantiationEngine::doInstantiationRound( Theory::Effort effort ){
   while( !finished && e<=eLimit ){
     Debug("inst-engine") << "IE: Prepare instantiation (" << e << ")." << std::endl;
     finished = true;
+    if( options::instRoundBatch() ){
+      //match all quantified formulas before constructing any instantiation lemma
+      d_quantEngine->beginInstantiationBatch();
+    }
     //instantiate each quantifier
-    for( unsigned i=0; i<d_quants.size(); i++ ){
+    bool conflict = false;
+    for( unsigned i=0; i<d_quants.size() && !conflict; i++ ){
       Node q = d_quants[i];
       Debug("inst-engine-debug") << "IE: Instantiate " << q << "..." << std::endl;
       //int e_use = d_quantEngine->getRelevance( q )==-1 ? e - 1 : e;
@@ -85,13 +90,20 @@ void InstantiationEngine::doInstantiationRound( Theory::Effort effort ){
           int quantStatus = is->process( q, effort, e_use );
           Trace("inst-engine-debug") << " -> status is " << quantStatus << ", conflict=" << d_quantEngine->inConflict() << std::endl;
           if( d_quantEngine->inConflict() ){
-            return;
+            conflict = true;
+            break;
           }else if( quantStatus==InstStrategy::STATUS_UNFINISHED ){
             finished = false;
           }
         }
       }
     }
+    if( options::instRoundBatch() ){
+      d_quantEngine->flushInstantiationBatch();
+    }
+    if( d_quantEngine->inConflict() ){
+      return;
+    }
     //do not consider another level if already added lemma at this level
     if( d_quantEngine->getNumLemmasWaiting()>lastWaiting ){
       finished = true;
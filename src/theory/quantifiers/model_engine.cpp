@@ -206,7 +206,12 @@ int ModelEngine::checkModel(){
       Trace("fmf-exh-inst") << "-> Exhaustive instantiate " << q << ", effort = " << e << "..." << std::endl;
       //determine if we should check this quantifier
       if( d_quantEngine->getModel()->isQuantifierActive( q ) && d_quantEngine->hasOwnership( q, this ) ){
+        quantifiers::InstProfile* ip = d_quantEngine->getInstProfile( q );
+        double clSet = ip ? quantifiers::InstProfile::getTime() : 0;
         exhaustiveInstantiate( q, e );
+        if( ip ){
+          ip->d_mbqi_time += quantifiers::InstProfile::getTime() - clSet;
+        }
         if( d_quantEngine->inConflict() || ( optOneQuantPerRound() && d_addedLemmas>0 ) ){
           break;
         }
@@ -0,0 +1,386 @@
+/*********************                                                        */
+/*! \file model_eval_code.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Implementation of compiled evaluation of quantified formulas in the current model
+ **/
+
+#include "theory/quantifiers/model_eval_code.h"
+
+#include <algorithm>
+
+#include "theory/quantifiers/first_order_model.h"
+#include "theory/quantifiers/full_model_check.h"
+#include "theory/quantifiers/term_database.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::quantifiers;
+using namespace CVC4::theory::quantifiers::fmcheck;
+
+ModelEvalCode::ModelEvalCode( Node q ) : d_q( q ), d_num_const_terms( 0 ) {
+  d_true = NodeManager::currentNM()->mkConst(true);
+  d_false = NodeManager::currentNM()->mkConst(false);
+}
+
+bool ModelEvalCode::initialize() {
+  if( !compile( d_q[1] ) ){
+    Trace("fmc-eval-code") << "Cannot compile the body of " << d_q << std::endl;
+    d_code.clear();
+    return false;
+  }
+  Trace("fmc-eval-code") << "Compiled the body of " << d_q << " into " << d_code.size() << " instructions." << std::endl;
+  d_num_const_terms = d_terms.size();
+  return true;
+}
+
+unsigned ModelEvalCode::addInstruction( Node n, const ModelEvalInstruction& i ) {
+  unsigned r = d_code.size();
+  d_code.push_back( i );
+  d_reg[n] = r;
+  return r;
+}
+
+bool ModelEvalCode::compile( Node n ) {
+  if( d_reg.find( n )!=d_reg.end() ){
+    return true;
+  }
+  TypeNode tn = n.getType();
+  if( n.hasAttribute(BoundIntLitAttribute()) ){
+    //we only enumerate values within the bounds, as in FullModelChecker::doCheck
+    ModelEvalInstruction i( EVAL_CONST, tn );
+    i.d_imm = n.getAttribute(BoundIntLitAttribute())==1 ? 0 : 1;
+    addInstruction( n, i );
+    return true;
+  }else if( n.getKind()==BOUND_VARIABLE ){
+    for( unsigned j=0; j<d_q[0].getNumChildren(); j++ ){
+      if( d_q[0][j]==n ){
+        ModelEvalInstruction i( EVAL_VAR, tn );
+        i.d_imm = j;
+        addInstruction( n, i );
+        return true;
+      }
+    }
+    return false;
+  }else if( n.getNumChildren()==0 ){
+    if( n.isConst() ){
+      ModelEvalInstruction i( EVAL_CONST, tn );
+      if( !getValue( tn, n, i.d_imm ) ){
+        return false;
+      }
+      addInstruction( n, i );
+    }else{
+      ModelEvalInstruction i( EVAL_GROUND, tn );
+      i.d_imm = d_ground.size();
+      d_ground.push_back( n );
+      addInstruction( n, i );
+    }
+    return true;
+  }
+  int op;
+  bool swap = false;
+  Kind k = n.getKind();
+  if( k==NOT ){
+    op = EVAL_NOT;
+  }else if( k==AND ){
+    op = EVAL_AND;
+  }else if( k==OR ){
+    op = EVAL_OR;
+  }else if( k==IMPLIES ){
+    op = EVAL_IMPLIES;
+  }else if( k==XOR ){
+    op = EVAL_XOR;
+  }else if( k==ITE ){
+    op = EVAL_ITE;
+  }else if( k==EQUAL ){
+    op = EVAL_EQUAL;
+  }else if( k==APPLY_UF ){
+    op = EVAL_APPLY_UF;
+  }else if( n[0].getType().isReal() && ( k==LT || k==LEQ || k==GT || k==GEQ ||
+            k==PLUS || k==MINUS || k==UMINUS || k==MULT ) ){
+    //integer arithmetic, evaluated on machine integers
+    swap = k==GT || k==GEQ;
+    op = ( k==LT || k==GT ) ? EVAL_LT : ( ( k==LEQ || k==GEQ ) ? EVAL_LEQ :
+         ( k==PLUS ? EVAL_PLUS : ( k==MINUS ? EVAL_MINUS : ( k==UMINUS ? EVAL_UMINUS : EVAL_MULT ) ) ) );
+  }else{
+    Trace("fmc-eval-code") << "Cannot compile " << n << " of kind " << k << std::endl;
+    return false;
+  }
+  ModelEvalInstruction i( op, tn );
+  if( op==EVAL_APPLY_UF ){
+    i.d_node = n.getOperator();
+  }
+  for( unsigned j=0; j<n.getNumChildren(); j++ ){
+    if( !compile( n[j] ) ){
+      return false;
+    }
+    i.d_args.push_back( d_reg[n[j]] );
+  }
+  if( swap ){
+    std::reverse( i.d_args.begin(), i.d_args.end() );
+  }
+  addInstruction( n, i );
+  return true;
+}
+
+bool ModelEvalCode::getValue( TypeNode tn, Node n, int64_t& v ) {
+  if( n.isNull() ){
+    return false;
+  }else if( tn.isBoolean() ){
+    if( n==d_true || n==d_false ){
+      v = n==d_true ? 1 : 0;
+      return true;
+    }
+    return false;
+  }else if( tn.isReal() ){
+    if( n.isConst() ){
+      const Rational& r = n.getConst<Rational>();
+      if( r.isIntegral() && r.getNumerator().fitsSignedLong() ){
+        v = r.getNumerator().getLong();
+        return inRange( v );
+      }
+    }
+    return false;
+  }else{
+    std::map< Node, int64_t >::iterator it = d_term_id.find( n );
+    if( it==d_term_id.end() ){
+      v = d_terms.size();
+      d_term_id[n] = v;
+      d_terms.push_back( n );
+    }else{
+      v = it->second;
+    }
+    return true;
+  }
+}
+
+Node ModelEvalCode::getNode( TypeNode tn, int64_t v ) {
+  if( tn.isBoolean() ){
+    return v==1 ? d_true : d_false;
+  }else if( tn.isReal() ){
+    return NodeManager::currentNM()->mkConst( Rational( static_cast<long>(v) ) );
+  }else{
+    return d_terms[v];
+  }
+}
+
+void ModelEvalCode::reset( FirstOrderModelFmc * fm, FullModelChecker * mc ) {
+  //representatives of the last model are not needed anymore
+  for( unsigned j=d_num_const_terms; j<d_terms.size(); j++ ){
+    d_term_id.erase( d_terms[j] );
+  }
+  d_terms.resize( d_num_const_terms );
+  d_ground_val.resize( d_ground.size() );
+  d_ground_known.resize( d_ground.size() );
+  for( unsigned j=0; j<d_ground.size(); j++ ){
+    //same as the value of ground terms in FullModelChecker::doCheck
+    Node r = d_ground[j];
+    if( !fm->hasTerm( r ) ){
+      r = mc->getSomeDomainElement( fm, r.getType() );
+    }
+    r = fm->getUsedRepresentative( r );
+    d_ground_known[j] = getValue( d_ground[j].getType(), r, d_ground_val[j] ) ? 1 : 0;
+  }
+  d_uf_cache.clear();
+}
+
+bool ModelEvalCode::getVariableValue( FirstOrderModelFmc * fm, unsigned i, Node r, int64_t& v ) {
+  TypeNode tn = d_q[0][i].getType();
+  if( !tn.isReal() ){
+    r = fm->getUsedRepresentative( r );
+  }
+  return getValue( tn, r, v );
+}
+
+void ModelEvalCode::execute( FirstOrderModelFmc * fm, FullModelChecker * mc, unsigned i, unsigned n,
+                             std::vector< int64_t >& vals, std::vector< char >& known ) {
+  ModelEvalInstruction& inst = d_code[i];
+  int64_t * out = &d_val[i*n];
+  char * kout = &d_known[i*n];
+  std::vector< int64_t * > a;
+  std::vector< char * > ka;
+  for( unsigned j=0; j<inst.d_args.size(); j++ ){
+    a.push_back( &d_val[inst.d_args[j]*n] );
+    ka.push_back( &d_known[inst.d_args[j]*n] );
+  }
+  unsigned nargs = a.size();
+  switch( inst.d_op ){
+  case EVAL_VAR:{
+    unsigned nvars = d_q[0].getNumChildren();
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = vals[t*nvars + inst.d_imm];
+      kout[t] = known[t*nvars + inst.d_imm];
+    }
+    break;
+  }
+  case EVAL_CONST:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = inst.d_imm;
+      kout[t] = 1;
+    }
+    break;
+  case EVAL_GROUND:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = d_ground_val[inst.d_imm];
+      kout[t] = d_ground_known[inst.d_imm];
+    }
+    break;
+  case EVAL_NOT:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = 1-a[0][t];
+      kout[t] = ka[0][t];
+    }
+    break;
+  case EVAL_AND:
+  case EVAL_OR:{
+    //the value that determines the result
+    int64_t c = inst.d_op==EVAL_AND ? 0 : 1;
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = 1-c;
+      kout[t] = 1;
+      for( unsigned j=0; j<nargs; j++ ){
+        if( ka[j][t] ){
+          if( a[j][t]==c ){
+            out[t] = c;
+            kout[t] = 1;
+            break;
+          }
+        }else{
+          kout[t] = 0;
+        }
+      }
+    }
+    break;
+  }
+  case EVAL_IMPLIES:
+    for( unsigned t=0; t<n; t++ ){
+      if( ( ka[0][t] && a[0][t]==0 ) || ( ka[1][t] && a[1][t]==1 ) ){
+        out[t] = 1;
+        kout[t] = 1;
+      }else{
+        out[t] = 0;
+        kout[t] = ka[0][t] && ka[1][t];
+      }
+    }
+    break;
+  case EVAL_XOR:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = a[0][t]!=a[1][t] ? 1 : 0;
+      kout[t] = ka[0][t] && ka[1][t];
+    }
+    break;
+  case EVAL_ITE:
+    for( unsigned t=0; t<n; t++ ){
+      if( ka[0][t] ){
+        unsigned b = a[0][t]==1 ? 1 : 2;
+        out[t] = a[b][t];
+        kout[t] = ka[b][t];
+      }else{
+        out[t] = a[1][t];
+        kout[t] = ka[1][t] && ka[2][t] && a[1][t]==a[2][t];
+      }
+    }
+    break;
+  case EVAL_EQUAL:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = a[0][t]==a[1][t] ? 1 : 0;
+      kout[t] = ka[0][t] && ka[1][t];
+    }
+    break;
+  case EVAL_LT:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = a[0][t]<a[1][t] ? 1 : 0;
+      kout[t] = ka[0][t] && ka[1][t];
+    }
+    break;
+  case EVAL_LEQ:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = a[0][t]<=a[1][t] ? 1 : 0;
+      kout[t] = ka[0][t] && ka[1][t];
+    }
+    break;
+  case EVAL_UMINUS:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = -a[0][t];
+      kout[t] = ka[0][t];
+    }
+    break;
+  case EVAL_PLUS:
+  case EVAL_MINUS:
+  case EVAL_MULT:
+    for( unsigned t=0; t<n; t++ ){
+      out[t] = a[0][t];
+      kout[t] = ka[0][t];
+      for( unsigned j=1; j<nargs && kout[t]; j++ ){
+        //operands are in range, hence the result of a single operation does not overflow
+        if( inst.d_op==EVAL_PLUS ){
+          out[t] += a[j][t];
+        }else if( inst.d_op==EVAL_MINUS ){
+          out[t] -= a[j][t];
+        }else{
+          out[t] *= a[j][t];
+        }
+        kout[t] = ka[j][t] && inRange( out[t] );
+      }
+    }
+    break;
+  case EVAL_APPLY_UF:{
+    UfCache& cache = d_uf_cache[inst.d_node];
+    std::vector< int64_t > key;
+    key.resize( nargs );
+    for( unsigned t=0; t<n; t++ ){
+      kout[t] = 1;
+      for( unsigned j=0; j<nargs; j++ ){
+        if( !ka[j][t] ){
+          kout[t] = 0;
+          break;
+        }
+        key[j] = a[j][t];
+      }
+      if( kout[t] ){
+        UfCache::iterator it = cache.find( key );
+        if( it==cache.end() ){
+          //not seen in this round, evaluate the application in the model
+          std::vector< Node > args;
+          for( unsigned j=0; j<nargs; j++ ){
+            args.push_back( getNode( d_code[inst.d_args[j]].d_type, key[j] ) );
+          }
+          Node r = mc->evaluateUf( fm, inst.d_node, args );
+          std::pair< int64_t, bool >& e = cache[key];
+          e.second = getValue( inst.d_type, r, e.first );
+          it = cache.find( key );
+        }
+        out[t] = it->second.first;
+        kout[t] = it->second.second ? 1 : 0;
+      }
+    }
+    break;
+  }
+  default:
+    Assert( false );
+    break;
+  }
+}
+
+void ModelEvalCode::evaluate( FirstOrderModelFmc * fm, FullModelChecker * mc, unsigned n,
+                              std::vector< int64_t >& vals, std::vector< char >& known, std::vector< int >& res ) {
+  Assert( !d_code.empty() );
+  d_val.resize( d_code.size()*n );
+  d_known.resize( d_code.size()*n );
+  for( unsigned i=0; i<d_code.size(); i++ ){
+    execute( fm, mc, i, n, vals, known );
+  }
+  unsigned r = d_reg[d_q[1]];
+  res.resize( n );
+  for( unsigned t=0; t<n; t++ ){
+    res[t] = d_known[r*n+t] ? (int)d_val[r*n+t] : -1;
+  }
+}
@@ -0,0 +1,132 @@
+/*********************                                                        */
+/*! \file model_eval_code.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief compiled evaluation of quantified formulas in the current model
+ **
+ ** The body of a quantified formula is compiled once into a sequence of
+ ** instructions over machine integers.  Integer values are stored directly,
+ ** Booleans as 0/1, and values of other types as identifiers of their
+ ** representatives.  A chunk of tuples of the exhaustive instantiation is
+ ** then evaluated one instruction at a time, without constructing Nodes,
+ ** except for applications of uninterpreted functions on arguments that were
+ ** not seen before in the current round.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__QUANTIFIERS__MODEL_EVAL_CODE_H
+#define __CVC4__THEORY__QUANTIFIERS__MODEL_EVAL_CODE_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "expr/node.h"
+
+namespace CVC4 {
+namespace theory {
+namespace quantifiers {
+namespace fmcheck {
+
+class FirstOrderModelFmc;
+class FullModelChecker;
+
+/** an instruction, whose result is stored in the register of its index */
+class ModelEvalInstruction {
+public:
+  ModelEvalInstruction( int op, TypeNode tn ) : d_op( op ), d_type( tn ), d_imm( 0 ) {}
+  int d_op;
+  /** the type of the result */
+  TypeNode d_type;
+  /** the registers of the arguments */
+  std::vector< unsigned > d_args;
+  /** immediate argument: variable number, constant value or index of a ground term */
+  int64_t d_imm;
+  /** the operator of an application of an uninterpreted function */
+  Node d_node;
+};/* class ModelEvalInstruction */
+
+class ModelEvalCode {
+public:
+  enum {
+    EVAL_VAR,
+    EVAL_CONST,
+    EVAL_GROUND,
+    EVAL_NOT,
+    EVAL_AND,
+    EVAL_OR,
+    EVAL_IMPLIES,
+    EVAL_XOR,
+    EVAL_ITE,
+    EVAL_EQUAL,
+    EVAL_LT,
+    EVAL_LEQ,
+    EVAL_PLUS,
+    EVAL_MINUS,
+    EVAL_UMINUS,
+    EVAL_MULT,
+    EVAL_APPLY_UF,
+  };
+private:
+  Node d_true;
+  Node d_false;
+  /** the quantified formula */
+  Node d_q;
+  /** the code */
+  std::vector< ModelEvalInstruction > d_code;
+  /** registers of compiled terms */
+  std::map< Node, unsigned > d_reg;
+  /** ground terms loaded by EVAL_GROUND, and their values in the current round */
+  std::vector< Node > d_ground;
+  std::vector< int64_t > d_ground_val;
+  std::vector< char > d_ground_known;
+  /** identifiers of representatives of types other than Booleans and arithmetic */
+  std::map< Node, int64_t > d_term_id;
+  std::vector< Node > d_terms;
+  /** number of identifiers of constants in the code, the others are dropped at reset */
+  unsigned d_num_const_terms;
+  /** values of applications of uninterpreted functions computed in the current round */
+  typedef std::map< std::vector< int64_t >, std::pair< int64_t, bool > > UfCache;
+  std::map< Node, UfCache > d_uf_cache;
+  /** register values and whether they are known, for each register and tuple of the chunk */
+  std::vector< int64_t > d_val;
+  std::vector< char > d_known;
+  /** compile n, returns false if it contains a term that cannot be evaluated */
+  bool compile( Node n );
+  unsigned addInstruction( Node n, const ModelEvalInstruction& i );
+  /** convert between model values and values of registers */
+  bool getValue( TypeNode tn, Node n, int64_t& v );
+  Node getNode( TypeNode tn, int64_t v );
+  /** execute instruction i for tuples [0,n) */
+  void execute( FirstOrderModelFmc * fm, FullModelChecker * mc, unsigned i, unsigned n,
+                std::vector< int64_t >& vals, std::vector< char >& known );
+  /** is v small enough that arithmetic on it cannot overflow */
+  static bool inRange( int64_t v ) { return v>=-s_max_value && v<=s_max_value; }
+  static const int64_t s_max_value = 0x7fffffff;
+public:
+  ModelEvalCode( Node q );
+  ~ModelEvalCode(){}
+  /** initialize, returns false if the body of the quantified formula cannot be compiled */
+  bool initialize();
+  /** reset the values of ground terms and applications for the current model */
+  void reset( FirstOrderModelFmc * fm, FullModelChecker * mc );
+  /** get the value of term r for variable i, as it is passed to evaluate */
+  bool getVariableValue( FirstOrderModelFmc * fm, unsigned i, Node r, int64_t& v );
+  /** evaluate the body for n tuples, whose variable values are stored consecutively in vals,
+   * stores 1 (true), 0 (false) or -1 (unknown) for each tuple in res */
+  void evaluate( FirstOrderModelFmc * fm, FullModelChecker * mc, unsigned n,
+                 std::vector< int64_t >& vals, std::vector< char >& known, std::vector< int >& res );
+};/* class ModelEvalCode */
+
+}/* CVC4::theory::quantifiers::fmcheck namespace */
+}/* CVC4::theory::quantifiers namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__QUANTIFIERS__MODEL_EVAL_CODE_H */
@@ -24,6 +24,7 @@
 #include "theory/quantifiers/trigger.h"
 #include "theory/quantifiers/first_order_model.h"
 #include "theory/theory_engine.h"
+#include "theory/uf/equality_engine.h"
 
 using namespace CVC4::kind;
 using namespace std;
@@ -1733,7 +1734,7 @@ bool MatchGen::doMatching( QuantConflictFind * p, QuantInfo * qi ) {
             }else{
               //binding a variable
               d_qni_bound[index] = repVar;
-              std::map< TNode, TermArgTrie >::iterator it = d_qn[index]->d_data.begin();
+              TermArgTrie::iterator it = d_qn[index]->d_data.begin();
               if( it != d_qn[index]->d_data.end() ) {
                 d_qni.push_back( it );
                 //set the match
@@ -1760,7 +1761,7 @@ bool MatchGen::doMatching( QuantConflictFind * p, QuantInfo * qi ) {
           }
           if( !val.isNull() ){
             //constrained by val
-            std::map< TNode, TermArgTrie >::iterator it = d_qn[index]->d_data.find( val );
+            TermArgTrie::iterator it = d_qn[index]->d_data.find( val );
             if( it!=d_qn[index]->d_data.end() ){
               Debug("qcf-match-debug") << "       Match" << std::endl;
               d_qni.push_back( it );
@@ -1898,7 +1899,12 @@ bool MatchGen::isHandled( TNode n ) {
 
 QuantConflictFind::QuantConflictFind( QuantifiersEngine * qe, context::Context* c ) :
 QuantifiersModule( qe ),
-d_conflict( c, false ) {
+d_conflict( c, false ),
+d_watch_terms( c ),
+d_watch_diseqs( c ),
+d_watch_terms_pos( c, 0 ),
+d_watch_diseqs_pos( c, 0 ),
+d_watch_clean( c ) {
   d_fid_count = 0;
   d_true = NodeManager::currentNM()->mkConst<bool>(true);
   d_false = NodeManager::currentNM()->mkConst<bool>(false);
@@ -1922,6 +1928,10 @@ void QuantConflictFind::registerQuantifier( Node q ) {
     //make QcfNode structure
     Trace("qcf-qregister") << "- Get relevant equality/disequality pairs, calculate flattening..." << std::endl;
     d_qinfo[q].initialize( this, q, q[1] );
+    if( options::qcfWatch() ){
+      std::map< Node, bool > visited;
+      registerWatch( q, q[1], visited );
+    }
 
     //debug print
     if( Trace.isOn("qcf-qregister") ){
@@ -1982,17 +1992,127 @@ void QuantConflictFind::assertNode( Node q ) {
 
 /** new node */
 void QuantConflictFind::newEqClass( Node n ) {
-
+  if( options::qcfWatch() ){
+    d_watch_terms.push_back( n );
+  }
 }
 
 /** merge */
 void QuantConflictFind::merge( Node a, Node b ) {
-
+  if( options::qcfWatch() ){
+    //the terms in the equivalence class of b change representative
+    eq::EqClassIterator eqc_i = eq::EqClassIterator( b, d_quantEngine->getMasterEqualityEngine() );
+    while( !eqc_i.isFinished() ){
+      d_watch_terms.push_back( *eqc_i );
+      ++eqc_i;
+    }
+  }
 }
 
 /** assert disequal */
 void QuantConflictFind::assertDisequal( Node a, Node b ) {
+  if( options::qcfWatch() ){
+    d_watch_diseqs.push_back( a );
+  }
+}
+
+//-------------------------------------------------- watching equivalence classes
+
+Node QuantConflictFind::getWatchKey( Node n ) {
+  Node f = getTermDatabase()->getMatchOperator( n );
+  if( f.isNull() && n.getNumChildren()==0 && n.getKind()!=BOUND_VARIABLE ){
+    return n;
+  }
+  return f;
+}
+
+void QuantConflictFind::registerWatch( Node q, Node n, std::map< Node, bool >& visited ) {
+  if( visited.find( n )==visited.end() ){
+    visited[n] = true;
+    Node k = getWatchKey( n );
+    if( !k.isNull() ){
+      if( std::find( d_watch[k].begin(), d_watch[k].end(), q )==d_watch[k].end() ){
+        d_watch[k].push_back( q );
+      }
+    }else if( n.getNumChildren()>0 && ( !TermDb::isBoolConnective( n.getKind() ) || n.getKind()==FORALL || n.getKind()==SEP_STAR ) ){
+      //the value of n may change without a change to the equivalence classes of the keys of its subterms
+      Trace("qcf-watch") << "QCF watch : cannot watch " << n << " in " << q << std::endl;
+      d_watch_unsafe[q] = true;
+    }
+    if( n.getKind()==EQUAL && !n[0].getType().isBoolean() ){
+      std::vector< Node >& wd = d_watch_diseq[n[0].getType()];
+      if( std::find( wd.begin(), wd.end(), q )==wd.end() ){
+        wd.push_back( q );
+      }
+    }
+    for( unsigned i=0; i<n.getNumChildren(); i++ ){
+      registerWatch( q, n[i], visited );
+    }
+  }
+}
+
+void QuantConflictFind::invalidateWatch( Node q ) {
+  NodeIntMap::const_iterator it = d_watch_clean.find( q );
+  if( it!=d_watch_clean.end() && (*it).second>=0 ){
+    Trace("qcf-watch") << "QCF watch : invalidate " << q << std::endl;
+    d_watch_clean.insert( q, -1 );
+  }
+}
 
+void QuantConflictFind::processWatch() {
+  //update the operators of the parents of ground terms
+  for( std::map< Node, std::vector< Node > >::iterator it = d_watch.begin(); it != d_watch.end(); ++it ){
+    Node f = it->first;
+    unsigned nterms = getTermDatabase()->getNumGroundTerms( f );
+    for( unsigned i=d_watch_parents_count[f]; i<nterms; i++ ){
+      Node t = getTermDatabase()->getGroundTerm( f, i );
+      for( unsigned j=0; j<t.getNumChildren(); j++ ){
+        std::vector< Node >& wp = d_watch_parents[t[j]];
+        if( std::find( wp.begin(), wp.end(), f )==wp.end() ){
+          wp.push_back( f );
+        }
+      }
+    }
+    d_watch_parents_count[f] = nterms;
+  }
+  //collect the watched keys of terms that changed, and of their parents
+  std::map< Node, bool > keys;
+  for( unsigned i=d_watch_terms_pos.get(); i<d_watch_terms.size(); i++ ){
+    Node n = d_watch_terms[i];
+    Node k = getWatchKey( n );
+    if( !k.isNull() ){
+      keys[k] = true;
+    }
+    std::map< Node, std::vector< Node > >::iterator itp = d_watch_parents.find( n );
+    if( itp!=d_watch_parents.end() ){
+      for( unsigned j=0; j<itp->second.size(); j++ ){
+        keys[itp->second[j]] = true;
+      }
+    }
+  }
+  d_watch_terms_pos.set( d_watch_terms.size() );
+  for( std::map< Node, bool >::iterator it = keys.begin(); it != keys.end(); ++it ){
+    std::map< Node, std::vector< Node > >::iterator itw = d_watch.find( it->first );
+    if( itw!=d_watch.end() ){
+      for( unsigned j=0; j<itw->second.size(); j++ ){
+        invalidateWatch( itw->second[j] );
+      }
+    }
+  }
+  //disequalities may falsify equalities between any terms of their type
+  std::map< TypeNode, bool > types;
+  for( unsigned i=d_watch_diseqs_pos.get(); i<d_watch_diseqs.size(); i++ ){
+    types[d_watch_diseqs[i].getType()] = true;
+  }
+  d_watch_diseqs_pos.set( d_watch_diseqs.size() );
+  for( std::map< TypeNode, bool >::iterator it = types.begin(); it != types.end(); ++it ){
+    std::map< TypeNode, std::vector< Node > >::iterator itw = d_watch_diseq.find( it->first );
+    if( itw!=d_watch_diseq.end() ){
+      for( unsigned j=0; j<itw->second.size(); j++ ){
+        invalidateWatch( itw->second[j] );
+      }
+    }
+  }
 }
 
 //-------------------------------------------------- check function
@@ -2049,6 +2169,9 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
         Trace("qcf-engine") << "---Conflict Find Engine Round, effort = " << level << "---" << std::endl;
       }
       computeRelevantEqr();
+      if( options::qcfWatch() ){
+        processWatch();
+      }
 
       d_irr_func.clear();
       d_irr_quant.clear();
@@ -2069,11 +2192,26 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
             QuantInfo * qi = &d_qinfo[q];
 
             Assert( d_qinfo.find( q )!=d_qinfo.end() );
-            if( qi->matchGeneratorIsValid() ){
+            bool watchClean = false;
+            if( options::qcfWatch() && d_watch_unsafe.find( q )==d_watch_unsafe.end() ){
+              NodeIntMap::const_iterator itc = d_watch_clean.find( q );
+              if( itc!=d_watch_clean.end() && (*itc).second>=e ){
+                //nothing q depends on changed since it was checked at this effort
+                Trace("qcf-watch") << "QCF watch : skip " << q << " at effort " << e << std::endl;
+                ++(d_statistics.d_watch_skipped);
+                watchClean = true;
+              }
+            }
+            if( !watchClean && qi->matchGeneratorIsValid() ){
+              int prevLemmas = addedLemmas;
+              //whether all matches were enumerated
+              bool exhausted = true;
               Trace("qcf-check") << "Check quantified formula ";
               debugPrintQuant("qcf-check", q);
               Trace("qcf-check") << " : " << q << "..." << std::endl;
 
+              quantifiers::InstProfile* ip = d_quantEngine->getInstProfile( q );
+              double clSetq = ip ? quantifiers::InstProfile::getTime() : 0;
               Trace("qcf-check-debug") << "Reset round..." << std::endl;
               if( qi->reset_round( this ) ){
                 //try to make a matches making the body false
@@ -2103,6 +2241,9 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
                           Trace("qcf-inst") << std::endl;
                           ++addedLemmas;
                           if( e==effort_conflict ){
+                            if( ip ){
+                              ip->d_conflicts++;
+                            }
                             d_quantEngine->markRelevant( q );
                             ++(d_quantEngine->d_statistics.d_instantiations_qcf);
                             if( options::qcfAllConflict() ){
@@ -2110,6 +2251,7 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
                             }else{
                               d_conflict.set( true );
                             }
+                            exhausted = false;
                             break;
                           }else if( e==effort_prop_eq ){
                             d_quantEngine->markRelevant( q );
@@ -2119,6 +2261,7 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
                           Trace("qcf-inst") << "   ... Failed to add instantiation" << std::endl;
                           //this should only happen if the algorithm generates the same propagating instance twice this round
                           //in this case, break to avoid exponential behavior
+                          exhausted = false;
                           break;
                         }
                       }else{
@@ -2134,11 +2277,18 @@ void QuantConflictFind::check( Theory::Effort level, unsigned quant_e ) {
                     Trace("qcf-inst") << "   ... Spurious instantiation (match is inconsistent)" << std::endl;
                   }
                 }
-                Trace("qcf-check") << "Done, conflict = " << d_conflict << std::endl;
-                if( d_conflict ){
-                  break;
+                if( options::qcfWatch() && exhausted && addedLemmas==prevLemmas ){
+                  d_watch_clean.insert( q, e );
                 }
               }
+              //the time of a failed reset counts as well
+              if( ip ){
+                ip->d_qcf_time += quantifiers::InstProfile::getTime() - clSetq;
+              }
+              Trace("qcf-check") << "Done, conflict = " << d_conflict << std::endl;
+              if( d_conflict ){
+                break;
+              }
             }
           }
         }
@@ -2240,15 +2390,18 @@ void QuantConflictFind::debugPrintQuantBody( const char * c, Node q, Node n, boo
 
 QuantConflictFind::Statistics::Statistics():
   d_inst_rounds("QuantConflictFind::Inst_Rounds", 0),
-  d_entailment_checks("QuantConflictFind::Entailment_Checks",0)
+  d_entailment_checks("QuantConflictFind::Entailment_Checks",0),
+  d_watch_skipped("QuantConflictFind::Watch_Skipped",0)
 {
   smtStatisticsRegistry()->registerStat(&d_inst_rounds);
   smtStatisticsRegistry()->registerStat(&d_entailment_checks);
+  smtStatisticsRegistry()->registerStat(&d_watch_skipped);
 }
 
 QuantConflictFind::Statistics::~Statistics(){
   smtStatisticsRegistry()->unregisterStat(&d_inst_rounds);
   smtStatisticsRegistry()->unregisterStat(&d_entailment_checks);
+  smtStatisticsRegistry()->unregisterStat(&d_watch_skipped);
 }
 
 TNode QuantConflictFind::getZero( Kind k ) {
@@ -19,6 +19,8 @@
 
 #include "context/cdhashmap.h"
 #include "context/cdchunk_list.h"
+#include "context/cdlist.h"
+#include "context/cdo.h"
 #include "theory/quantifiers_engine.h"
 #include "theory/quantifiers/term_database.h"
 
@@ -43,7 +45,7 @@ private:
   //MatchGen * getChild( int i ) { return &d_children[i]; }
   //current matching information
   std::vector< TermArgTrie * > d_qn;
-  std::vector< std::map< TNode, TermArgTrie >::iterator > d_qni;
+  std::vector< TermArgTrie::iterator > d_qni;
   bool doMatching( QuantConflictFind * p, QuantInfo * qi );
   //for matching : each index is either a variable or a ground term
   unsigned d_qni_size;
@@ -190,6 +192,7 @@ class QuantConflictFind : public QuantifiersModule
   friend class QuantInfo;
   typedef context::CDChunkList<Node> NodeList;
   typedef context::CDHashMap<Node, bool, NodeHashFunction> NodeBoolMap;
+  typedef context::CDHashMap<Node, int, NodeHashFunction> NodeIntMap;
 private:
   context::CDO< bool > d_conflict;
   std::map< Kind, Node > d_zero;
@@ -200,6 +203,27 @@ private:
   std::map< TNode, bool > d_irr_func;
   std::map< Node, bool > d_irr_quant;
   void setIrrelevantFunction( TNode f );
+private:  //optimization: watch the equivalence classes that quantified formulas depend on
+  /** for each match operator or ground term, the quantified formulas whose bodies contain it */
+  std::map< Node, std::vector< Node > > d_watch;
+  /** for each type, the quantified formulas with an equality between terms of that type */
+  std::map< TypeNode, std::vector< Node > > d_watch_diseq;
+  /** for each ground term, the watched match operators of terms it is an argument of */
+  std::map< Node, std::vector< Node > > d_watch_parents;
+  std::map< Node, unsigned > d_watch_parents_count;
+  /** terms whose equivalence class changed, and terms that became disequal */
+  context::CDList< Node > d_watch_terms;
+  context::CDList< Node > d_watch_diseqs;
+  context::CDO< unsigned > d_watch_terms_pos;
+  context::CDO< unsigned > d_watch_diseqs_pos;
+  /** the highest effort at which each quantified formula was checked without result, since its watched terms changed */
+  NodeIntMap d_watch_clean;
+  /** quantified formulas with subterms that have no watch key, e.g. interpreted terms, these are never skipped */
+  std::map< Node, bool > d_watch_unsafe;
+  Node getWatchKey( Node n );
+  void registerWatch( Node q, Node n, std::map< Node, bool >& visited );
+  void invalidateWatch( Node q );
+  void processWatch();
 private:
   std::map< Node, Node > d_op_node;
   int d_fid_count;
@@ -261,6 +285,7 @@ public:
   public:
     IntStat d_inst_rounds;
     IntStat d_entailment_checks;
+    IntStat d_watch_skipped;
     Statistics();
     ~Statistics();
   };
@@ -40,6 +40,64 @@ namespace CVC4 {
 namespace theory {
 namespace quantifiers {
 
+TermArgTrie::Children::Children( const Children& other ) : d_index( NULL ) {
+  *this = other;
+}
+
+TermArgTrie::Children::~Children() {
+  clear();
+}
+
+TermArgTrie::Children& TermArgTrie::Children::operator=( const Children& other ) {
+  if( this!=&other ){
+    clear();
+    for( unsigned i=0; i<other.d_entries.size(); i++ ){
+      Entry* e = other.d_entries[i];
+      (*this)[e->first] = e->second;
+    }
+  }
+  return *this;
+}
+
+void TermArgTrie::Children::clear() {
+  for( unsigned i=0; i<d_entries.size(); i++ ){
+    delete d_entries[i];
+  }
+  d_entries.clear();
+  delete d_index;
+  d_index = NULL;
+}
+
+TermArgTrie::Children::iterator TermArgTrie::Children::find( TNode n ) {
+  if( d_index ){
+    __gnu_cxx::hash_map< TNode, unsigned, TNodeHashFunction >::const_iterator it = d_index->find( n );
+    return it==d_index->end() ? end() : iterator( d_entries.begin() + it->second );
+  }
+  for( std::vector< Entry* >::iterator it = d_entries.begin(); it != d_entries.end(); ++it ){
+    if( (*it)->first==n ){
+      return iterator( it );
+    }
+  }
+  return end();
+}
+
+TermArgTrie& TermArgTrie::Children::operator[]( TNode n ) {
+  iterator it = find( n );
+  if( it!=end() ){
+    return it->second;
+  }
+  d_entries.push_back( new Entry( n, TermArgTrie() ) );
+  if( d_index ){
+    (*d_index)[n] = d_entries.size() - 1;
+  }else if( d_entries.size()>s_indexThreshold ){
+    d_index = new __gnu_cxx::hash_map< TNode, unsigned, TNodeHashFunction >();
+    for( unsigned i=0; i<d_entries.size(); i++ ){
+      (*d_index)[d_entries[i]->first] = i;
+    }
+  }
+  return d_entries.back()->second;
+}
+
 TNode TermArgTrie::existsTerm( std::vector< TNode >& reps, int argIndex ) {
   if( argIndex==(int)reps.size() ){
     if( d_data.empty() ){
@@ -48,7 +106,7 @@ TNode TermArgTrie::existsTerm( std::vector< TNode >& reps, int argIndex ) {
       return d_data.begin()->first;
     }
   }else{
-    std::map< TNode, TermArgTrie >::iterator it = d_data.find( reps[argIndex] );
+    TermArgTrie::iterator it = d_data.find( reps[argIndex] );
     if( it==d_data.end() ){
       return Node::null();
     }else{
@@ -76,7 +134,7 @@ TNode TermArgTrie::addOrGetTerm( TNode n, std::vector< TNode >& reps, int argInd
 }
 
 void TermArgTrie::debugPrint( const char * c, Node n, unsigned depth ) {
-  for( std::map< TNode, TermArgTrie >::iterator it = d_data.begin(); it != d_data.end(); ++it ){
+  for( TermArgTrie::iterator it = d_data.begin(); it != d_data.end(); ++it ){
     for( unsigned i=0; i<depth; i++ ){ Trace(c) << "  "; }
     Trace(c) << it->first << std::endl;
     it->second.debugPrint( c, n, depth+1 );
@@ -87,6 +145,9 @@ TermDb::TermDb(context::Context* c, context::UserContext* u,
                QuantifiersEngine* qe)
     : d_quantEngine(qe),
       d_inactive_map(c),
+      d_func_map_valid(c),
+      d_func_map_eqc_valid(c),
+      d_index_gen_count(0),
       d_op_id_count(0),
       d_typ_id_count(0),
       d_sygus_tdb(NULL) {
@@ -180,6 +241,7 @@ void TermDb::addTerm( Node n, std::set< Node >& added, bool withinQuant, bool wi
           Trace("term-db-debug") << "  match operator is : " << op << std::endl;
           d_op_map[op].push_back( n );
           added.insert( n );
+          invalidateIndex( op );
           
           if( d_sygus_tdb ){
             d_sygus_tdb->registerEvalTerm( n );
@@ -214,6 +276,7 @@ void TermDb::computeArgReps( TNode n ) {
 
 void TermDb::computeUfEqcTerms( TNode f ) {
   if( d_func_map_eqc_trie.find( f )==d_func_map_eqc_trie.end() ){
+    TimerStat::CodeTimer codeTimer(d_quantEngine->d_statistics.d_term_db_index_time);
     d_func_map_eqc_trie[f].clear();
     eq::EqualityEngine * ee = d_quantEngine->getTheoryEngine()->getMasterEqualityEngine();
     for( unsigned i=0; i<d_op_map[f].size(); i++ ){
@@ -223,14 +286,20 @@ void TermDb::computeUfEqcTerms( TNode f ) {
           computeArgReps( n );
           TNode r = ee->hasTerm( n ) ? ee->getRepresentative( n ) : n;
           d_func_map_eqc_trie[f].d_data[r].addTerm( n, d_arg_reps[n] );
+          addRepOp( r, f, true );
+          for( unsigned j=0; j<d_arg_reps[n].size(); j++ ){
+            addRepOp( d_arg_reps[n][j], f, true );
+          }
         }
       }
     }
+    setIndexValid( f, true );
   }
 }
 
 void TermDb::computeUfTerms( TNode f ) {
   if( d_op_nonred_count.find( f )==d_op_nonred_count.end() ){
+    TimerStat::CodeTimer codeTimer(d_quantEngine->d_statistics.d_term_db_index_time);
     d_op_nonred_count[ f ] = 0;
     std::map< Node, std::vector< Node > >::iterator it = d_op_map.find( f );
     if( it!=d_op_map.end() ){
@@ -258,6 +327,10 @@ void TermDb::computeUfTerms( TNode f ) {
             }
             Trace("term-db-debug") << std::endl;
             Trace("term-db-debug") << "  and value : " << ee->getRepresentative( n ) << std::endl;
+            addRepOp( ee->getRepresentative( n ), f, false );
+            for( unsigned i=0; i<d_arg_reps[n].size(); i++ ){
+              addRepOp( d_arg_reps[n][i], f, false );
+            }
             Node at = d_func_map_trie[ f ].addOrGetTerm( n, d_arg_reps[n] );
             Trace("term-db-debug2") << "...add term returned " << at << std::endl;
             if( at!=n && ee->areEqual( at, n ) ){
@@ -302,9 +375,101 @@ void TermDb::computeUfTerms( TNode f ) {
         Trace("tdb") << relevantCount << " / " << it->second.size() << std::endl;
       }
     }
+    //after setTermInactive above, which invalidates the index of f
+    setIndexValid( f, false );
   }
 }
 
+void TermDb::setIndexValid( TNode f, bool eqc ) {
+  d_index_gen_count++;
+  if( eqc ){
+    d_func_map_eqc_gen[f] = d_index_gen_count;
+    d_func_map_eqc_valid[f] = d_index_gen_count;
+  }else{
+    d_func_map_gen[f] = d_index_gen_count;
+    d_func_map_valid[f] = d_index_gen_count;
+  }
+}
+
+bool TermDb::isIndexValid( TNode f, bool eqc ) {
+  //the generation in the context may be older than the stored index if we backtracked over a rebuild
+  NodeIntMap& valid = eqc ? d_func_map_eqc_valid : d_func_map_valid;
+  std::map< Node, int >& gen = eqc ? d_func_map_eqc_gen : d_func_map_gen;
+  NodeIntMap::const_iterator itv = valid.find( f );
+  std::map< Node, int >::iterator itg = gen.find( f );
+  return itv!=valid.end() && itg!=gen.end() && (*itv).second==itg->second;
+}
+
+void TermDb::invalidateIndex( TNode f ) {
+  if( d_func_map_valid.find( f )!=d_func_map_valid.end() ){
+    d_func_map_valid[f] = 0;
+  }
+  if( d_func_map_eqc_valid.find( f )!=d_func_map_eqc_valid.end() ){
+    d_func_map_eqc_valid[f] = 0;
+  }
+}
+
+void TermDb::addRepOp( TNode r, TNode f, bool eqc ) {
+  std::map< Node, std::set< Node > >& rep_ops = eqc ? d_rep_ops_eqc : d_rep_ops;
+  if( rep_ops[r].insert( f ).second ){
+    std::map< Node, std::vector< Node > >& op_reps = eqc ? d_op_reps_eqc : d_op_reps;
+    op_reps[f].push_back( r );
+  }
+}
+
+void TermDb::removeRepOps( TNode f, bool eqc ) {
+  std::map< Node, std::set< Node > >& rep_ops = eqc ? d_rep_ops_eqc : d_rep_ops;
+  std::map< Node, std::vector< Node > >& op_reps = eqc ? d_op_reps_eqc : d_op_reps;
+  std::map< Node, std::vector< Node > >::iterator it = op_reps.find( f );
+  if( it!=op_reps.end() ){
+    for( unsigned i=0; i<it->second.size(); i++ ){
+      std::map< Node, std::set< Node > >::iterator itr = rep_ops.find( it->second[i] );
+      if( itr!=rep_ops.end() ){
+        itr->second.erase( f );
+        if( itr->second.empty() ){
+          rep_ops.erase( itr );
+        }
+      }
+    }
+    op_reps.erase( it );
+  }
+}
+
+void TermDb::invalidateIndexForRep( TNode r ) {
+  for( unsigned e=0; e<2; e++ ){
+    std::map< Node, std::set< Node > >& rep_ops = e==1 ? d_rep_ops_eqc : d_rep_ops;
+    std::map< Node, std::set< Node > >::iterator it = rep_ops.find( r );
+    if( it!=rep_ops.end() ){
+      for( std::set< Node >::iterator ito = it->second.begin(); ito != it->second.end(); ++ito ){
+        invalidateIndex( *ito );
+      }
+    }
+  }
+}
+
+void TermDb::invalidateIndexForTerm( TNode n ) {
+  //only terms in the operator map are indexed, their match operator is already computed
+  if( d_processed.find( n )!=d_processed.end() && !TermDb::hasInstConstAttr( n ) && inst::Trigger::isAtomicTrigger( n ) ){
+    invalidateIndex( getMatchOperator( n ) );
+  }
+}
+
+void TermDb::eqNotifyNewClass( TNode t ) {
+  invalidateIndexForTerm( t );
+}
+
+void TermDb::eqNotifyPreMerge( TNode t1, TNode t2 ) {
+  invalidateIndexForRep( t1 );
+  invalidateIndexForRep( t2 );
+}
+
+void TermDb::eqNotifyDisequal( TNode t1, TNode t2 ) {
+  //may make two congruent terms disequal, the indices are keyed by representatives
+  eq::EqualityEngine* ee = d_quantEngine->getMasterEqualityEngine();
+  invalidateIndexForRep( ee->getRepresentative( t1 ) );
+  invalidateIndexForRep( ee->getRepresentative( t2 ) );
+}
+
 bool TermDb::inRelevantDomain( TNode f, unsigned i, TNode r ) {
   computeUfTerms( f );
   Assert( d_quantEngine->getTheoryEngine()->getMasterEqualityEngine()->getRepresentative( r )==r );
@@ -569,6 +734,7 @@ bool TermDb::isTermActive( Node n ) {
 
 void TermDb::setTermInactive( Node n ) {
   d_inactive_map[n] = true;
+  invalidateIndexForTerm( n );
   //Trace("term-db-debug2") << "set no match attribute" << std::endl;
   //NoMatchAttribute nma;
   //n.setAttribute(nma,true);
@@ -669,17 +835,53 @@ void TermDb::presolve() {
     d_type_map.clear();
     d_processed.clear();
     d_iclosure_processed.clear();
+    //the indices were built from the old operator map
+    d_func_map_gen.clear();
+    d_func_map_eqc_gen.clear();
+    d_rep_ops.clear();
+    d_rep_ops_eqc.clear();
+    d_op_reps.clear();
+    d_op_reps_eqc.clear();
   }
 }
 
 bool TermDb::reset( Theory::Effort effort ){
-  d_op_nonred_count.clear();
   d_arg_reps.clear();
-  d_func_map_trie.clear();
-  d_func_map_eqc_trie.clear();
-  d_func_map_rel_dom.clear();
   d_consistent_ee = true;
 
+  //keep the indices of the operators whose terms, and the equivalence classes of their terms
+  // and arguments, have not changed since they were built.  The relevant terms may change
+  // with any new fact, so only do this if all terms are relevant.
+  bool keepIndices = options::termDbMode()==TERM_DB_ALL && !options::lteRestrictInstClosure();
+  std::vector< Node > ops;
+  for( std::map< Node, int >::iterator it = d_op_nonred_count.begin(); it != d_op_nonred_count.end(); ++it ){
+    ops.push_back( it->first );
+  }
+  for( unsigned i=0; i<ops.size(); i++ ){
+    if( keepIndices && isIndexValid( ops[i], false ) ){
+      ++(d_quantEngine->d_statistics.d_term_db_indices_reused);
+    }else{
+      ++(d_quantEngine->d_statistics.d_term_db_indices_rebuilt);
+      d_op_nonred_count.erase( ops[i] );
+      d_func_map_trie.erase( ops[i] );
+      d_func_map_rel_dom.erase( ops[i] );
+      removeRepOps( ops[i], false );
+    }
+  }
+  ops.clear();
+  for( std::map< Node, TermArgTrie >::iterator it = d_func_map_eqc_trie.begin(); it != d_func_map_eqc_trie.end(); ++it ){
+    ops.push_back( it->first );
+  }
+  for( unsigned i=0; i<ops.size(); i++ ){
+    if( keepIndices && isIndexValid( ops[i], true ) ){
+      ++(d_quantEngine->d_statistics.d_term_db_indices_reused);
+    }else{
+      ++(d_quantEngine->d_statistics.d_term_db_indices_rebuilt);
+      d_func_map_eqc_trie.erase( ops[i] );
+      removeRepOps( ops[i], true );
+    }
+  }
+
   eq::EqualityEngine* ee = d_quantEngine->getMasterEqualityEngine();
   //compute has map
   if( options::termDbMode()==TERM_DB_RELEVANT || options::lteRestrictInstClosure() ){
@@ -758,7 +960,7 @@ TermArgTrie * TermDb::getTermArgTrie( Node eqc, Node f ) {
     if( eqc.isNull() ){
       return &itut->second;
     }else{
-      std::map< TNode, TermArgTrie >::iterator itute = itut->second.d_data.find( eqc );
+      TermArgTrie::iterator itute = itut->second.d_data.find( eqc );
       if( itute!=itut->second.d_data.end() ){
         return &itute->second;
       }else{
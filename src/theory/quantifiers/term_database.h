@@ -22,6 +22,7 @@
 #include "theory/type_enumerator.h"
 #include "theory/quantifiers/quant_util.h"
 
+#include <ext/hash_map>
 #include <map>
 
 namespace CVC4 {
@@ -114,14 +115,54 @@ class QuantifiersEngine;
 
 namespace inst{
   class Trigger;
+  class InstMatchCodeTree;
 }
 
 namespace quantifiers {
 
 class TermArgTrie {
 public:
+  typedef std::pair< TNode, TermArgTrie > Entry;
+  /**
+   * The children of a trie node, kept in insertion order.  Most nodes have
+   * a handful of children, which are found by a linear scan; a hash index
+   * is added once a node has more than s_indexThreshold children.  Entries
+   * are allocated once and never move, so references to them stay valid
+   * while children are added.
+   */
+  class Children {
+    std::vector< Entry* > d_entries;
+    __gnu_cxx::hash_map< TNode, unsigned, TNodeHashFunction >* d_index;
+    static const unsigned s_indexThreshold = 64;
+  public:
+    class iterator {
+      std::vector< Entry* >::iterator d_it;
+    public:
+      iterator() {}
+      iterator( std::vector< Entry* >::iterator it ) : d_it( it ) {}
+      Entry& operator*() const { return **d_it; }
+      Entry* operator->() const { return *d_it; }
+      iterator& operator++() { ++d_it; return *this; }
+      iterator operator++( int ) { iterator tmp = *this; ++d_it; return tmp; }
+      bool operator==( const iterator& other ) const { return d_it==other.d_it; }
+      bool operator!=( const iterator& other ) const { return d_it!=other.d_it; }
+    };/* class TermArgTrie::Children::iterator */
+    Children() : d_index( NULL ) {}
+    Children( const Children& other );
+    ~Children();
+    Children& operator=( const Children& other );
+    iterator begin() { return iterator( d_entries.begin() ); }
+    iterator end() { return iterator( d_entries.end() ); }
+    iterator find( TNode n );
+    /** returns the child for n, adding it if it does not exist */
+    TermArgTrie& operator[]( TNode n );
+    bool empty() const { return d_entries.empty(); }
+    size_t size() const { return d_entries.size(); }
+    void clear();
+  };/* class TermArgTrie::Children */
+  typedef Children::iterator iterator;
   /** the data */
-  std::map< TNode, TermArgTrie > d_data;
+  Children d_data;
 public:
   bool hasNodeData() { return !d_data.empty(); }
   TNode getNodeData() { return d_data.begin()->first; }
@@ -170,6 +211,7 @@ class TermDb : public QuantifiersUtil {
   friend class ::CVC4::theory::QuantifiersEngine;
   //TODO: eliminate most of these
   friend class ::CVC4::theory::inst::Trigger;
+  friend class ::CVC4::theory::inst::InstMatchCodeTree;
   friend class ::CVC4::theory::quantifiers::fmcheck::FullModelChecker;
   friend class ::CVC4::theory::quantifiers::QuantConflictFind;
   friend class ::CVC4::theory::quantifiers::RelevantDomain;
@@ -206,6 +248,10 @@ private:
   bool reset( Theory::Effort effort );
   /** identify */
   std::string identify() const { return "TermDb"; }  
+  /** notifications from the master equality engine, which may invalidate the term indices */
+  void eqNotifyNewClass( TNode t );
+  void eqNotifyPreMerge( TNode t1, TNode t2 );
+  void eqNotifyDisequal( TNode t1, TNode t2 );
  private:
   /** map from operators to ground terms for that operator */
   std::map< Node, std::vector< Node > > d_op_map;
@@ -223,6 +269,29 @@ private:
   std::map< Node, TermArgTrie > d_func_map_eqc_trie;
   /** mapping from operators to their representative relevant domains */
   std::map< Node, std::map< unsigned, std::vector< Node > > > d_func_map_rel_dom;
+  /** generation of the indices stored in d_func_map_trie/d_func_map_eqc_trie for each operator */
+  std::map< Node, int > d_func_map_gen;
+  std::map< Node, int > d_func_map_eqc_gen;
+  /** generation of the indices that are valid in the current context for each operator (0 if none) */
+  NodeIntMap d_func_map_valid;
+  NodeIntMap d_func_map_eqc_valid;
+  int d_index_gen_count;
+  /** operators whose indices use each representative, and the representatives used by the index of each operator */
+  std::map< Node, std::set< Node > > d_rep_ops;
+  std::map< Node, std::set< Node > > d_rep_ops_eqc;
+  std::map< Node, std::vector< Node > > d_op_reps;
+  std::map< Node, std::vector< Node > > d_op_reps_eqc;
+  /** record that the index for f uses representative r */
+  void addRepOp( TNode r, TNode f, bool eqc );
+  /** forget the representatives used by the index for f, when it is dropped */
+  void removeRepOps( TNode f, bool eqc );
+  /** mark the indices for f valid in the current context */
+  void setIndexValid( TNode f, bool eqc );
+  bool isIndexValid( TNode f, bool eqc );
+  /** invalidate the indices for f, or for the operators whose indices use representative r */
+  void invalidateIndex( TNode f );
+  void invalidateIndexForRep( TNode r );
+  void invalidateIndexForTerm( TNode n );
   /** has map */
   std::map< Node, bool > d_has_map;
   /** map from reps to a term in eqc in d_has_map */
@@ -88,6 +88,13 @@ void TheoryQuantifiers::presolve() {
   }
 }
 
+void TheoryQuantifiers::postsolve() {
+  Debug("quantifiers-postsolve") << "TheoryQuantifiers::postsolve()" << endl;
+  if( getQuantifiersEngine() ){
+    getQuantifiersEngine()->postsolve();
+  }
+}
+
 void TheoryQuantifiers::ppNotifyAssertions( std::vector< Node >& assertions ) {
   Trace("quantifiers-presolve") << "TheoryQuantifiers::ppNotifyAssertions" << std::endl;
   if( getQuantifiersEngine() ){
@@ -15,6 +15,7 @@
 #include "theory/quantifiers/trigger.h"
 #include "theory/quantifiers/candidate_generator.h"
 #include "theory/quantifiers/inst_match_generator.h"
+#include "theory/quantifiers/inst_profile.h"
 #include "theory/quantifiers/term_database.h"
 #include "theory/quantifiers_engine.h"
 #include "theory/theory_engine.h"
@@ -44,7 +45,7 @@ void TriggerTermInfo::init( Node q, Node n, int reqPol, Node reqPolEq ){
 
 /** trigger class constructor */
 Trigger::Trigger( QuantifiersEngine* qe, Node f, std::vector< Node >& nodes )
-    : d_quantEngine( qe ), d_f( f ) {
+    : d_quantEngine( qe ), d_f( f ), d_profile( NULL ), d_qprofile( NULL ) {
   d_nodes.insert( d_nodes.begin(), nodes.begin(), nodes.end() );
   Trace("trigger") << "Trigger for " << f << ": " << std::endl;
   for( unsigned i=0; i<d_nodes.size(); i++ ){
@@ -54,8 +55,14 @@ Trigger::Trigger( QuantifiersEngine* qe, Node f, std::vector< Node >& nodes )
     if( isSimpleTrigger( d_nodes[0] ) ){
       d_mg = new InstMatchGeneratorSimple( f, d_nodes[0], qe );
     }else{
-      d_mg = InstMatchGenerator::mkInstMatchGenerator( f, d_nodes[0], qe );
-      d_mg->setActiveAdd(true);
+      d_mg = NULL;
+      if( options::ematchCodeTree() ){
+        d_mg = InstMatchGeneratorCodeTree::mkInstMatchGeneratorCodeTree( f, d_nodes[0], qe );
+      }
+      if( d_mg==NULL ){
+        d_mg = InstMatchGenerator::mkInstMatchGenerator( f, d_nodes[0], qe );
+        d_mg->setActiveAdd(true);
+      }
     }
   }else{
     d_mg = new InstMatchGeneratorMulti( f, d_nodes, qe );
@@ -106,7 +113,23 @@ Node Trigger::getInstPattern(){
 }
 
 int Trigger::addInstantiations( InstMatch& baseMatch ){
+  double clSet = 0;
+  if( options::instProfile() ){
+    if( d_profile==NULL ){
+      d_qprofile = d_quantEngine->getInstProfile( d_f );
+      Node pat = d_nodes.size()==1 ? d_nodes[0] : getInstPattern();
+      d_profile = &d_qprofile->d_triggers[pat];
+    }
+    clSet = quantifiers::InstProfile::getTime();
+  }
   int addedLemmas = d_mg->addInstantiations( d_f, baseMatch, d_quantEngine );
+  if( d_profile ){
+    double t = quantifiers::InstProfile::getTime() - clSet;
+    d_profile->d_calls++;
+    d_profile->d_insts += addedLemmas;
+    d_profile->d_time += t;
+    d_qprofile->d_match_time += t;
+  }
   if( addedLemmas>0 ){
     Debug("inst-trigger") << "Added " << addedLemmas << " lemmas, trigger was ";
     for( int i=0; i<(int)d_nodes.size(); i++ ){
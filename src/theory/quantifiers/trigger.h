@@ -29,6 +29,11 @@ namespace theory {
 
 class QuantifiersEngine;
 
+namespace quantifiers {
+class InstProfile;
+class TriggerProfile;
+}/* CVC4::theory::quantifiers namespace */
+
 namespace inst {
 
 class IMGenerator;
@@ -154,6 +159,9 @@ private:
   Node d_f;
   /** match generators */
   IMGenerator* d_mg;
+  /** the profiles of this trigger and its quantified formula (if --inst-profile) */
+  quantifiers::TriggerProfile* d_profile;
+  quantifiers::InstProfile* d_qprofile;
 }; /* class Trigger */
 
 /** a trie of triggers */
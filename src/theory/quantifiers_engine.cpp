@@ -14,6 +14,9 @@
 
 #include "theory/quantifiers_engine.h"
 
+#include <algorithm>
+#include <sstream>
+
 #include "options/quantifiers_options.h"
 #include "options/uf_options.h"
 #include "smt/smt_statistics_registry.h"
@@ -29,6 +32,7 @@
 #include "theory/quantifiers/full_model_check.h"
 #include "theory/quantifiers/fun_def_engine.h"
 #include "theory/quantifiers/inst_strategy_cbqi.h"
+#include "theory/quantifiers/inst_match_code_tree.h"
 #include "theory/quantifiers/inst_strategy_e_matching.h"
 #include "theory/quantifiers/instantiation_engine.h"
 #include "theory/quantifiers/local_theory_ext.h"
@@ -88,6 +92,12 @@ QuantifiersEngine::QuantifiersEngine(context::Context* c, context::UserContext*
   }
 
   d_tr_trie = new inst::TriggerTrie;
+  d_inst_batch = false;
+  if( options::ematchCodeTree() ){
+    d_code_tree = new inst::InstMatchCodeTree( c, this );
+  }else{
+    d_code_tree = NULL;
+  }
   d_curr_effort_level = QEFFORT_NONE;
   d_conflict = false;
   d_hasAddedLemma = false;
@@ -140,6 +150,18 @@ QuantifiersEngine::QuantifiersEngine(context::Context* c, context::UserContext*
   d_builder = NULL;
 
   d_total_inst_count_debug = 0;
+  d_throttle_insts = 0;
+  d_throttle_start = 0;
+  d_throttle_min_score = 0;
+  d_throttle_active = false;
+  d_throttled = false;
+  d_throttled_count = 0;
+  if( options::instProfile() ){
+    d_inst_profile_stat = new quantifiers::InstProfileStat( "QuantifiersEngine::Inst_Profile", d_inst_profile );
+    smtStatisticsRegistry()->registerStat( d_inst_profile_stat );
+  }else{
+    d_inst_profile_stat = NULL;
+  }
   //allow theory combination to go first, once initially
   d_ierCounter = options::instWhenTcFirst() ? 0 : 1;
   d_ierCounter_c = d_ierCounter;
@@ -156,6 +178,16 @@ QuantifiersEngine::~QuantifiersEngine(){
     delete (*i).second;
   }
   d_c_inst_match_trie.clear();
+  if( d_inst_profile_stat ){
+    smtStatisticsRegistry()->unregisterStat( d_inst_profile_stat );
+    delete d_inst_profile_stat;
+  }
+  for( std::map< Node, inst::InstMatchHashSet* >::iterator it = d_inst_match_hash.begin(); it != d_inst_match_hash.end(); ++it ){
+    delete it->second;
+  }
+  for( std::map< Node, inst::CDInstMatchHashSet* >::iterator it = d_c_inst_match_hash.begin(); it != d_c_inst_match_hash.end(); ++it ){
+    delete it->second;
+  }
 
   delete d_alpha_equiv;
   delete d_builder;
@@ -169,6 +201,7 @@ QuantifiersEngine::~QuantifiersEngine(){
   delete d_rel_dom;
   delete d_model;
   delete d_tr_trie;
+  delete d_code_tree;
   delete d_term_db;
   delete d_eq_query;
   delete d_sg_gen;
@@ -347,6 +380,9 @@ void QuantifiersEngine::presolve() {
     d_modules[i]->presolve();
   }
   d_term_db->presolve();
+  if( d_code_tree ){
+    d_code_tree->presolve();
+  }
   d_presolve = false;
   //add all terms to database
   if( options::incrementalSolving() ){
@@ -358,6 +394,14 @@ void QuantifiersEngine::presolve() {
   }
 }
 
+void QuantifiersEngine::postsolve() {
+  if( options::instProfile() ){
+    std::stringstream ss;
+    printInstantiationProfile( ss );
+    Message() << ss.str();
+  }
+}
+
 void QuantifiersEngine::ppNotifyAssertions( std::vector< Node >& assertions ) {
   Trace("quant-engine-proc") << "ppNotifyAssertions in QE, #assertions = " << assertions.size() << " check epr = " << (d_qepr!=NULL) << std::endl;
   if( ( options::instLevelInputOnly() && options::instMaxLevel()!=-1 ) || d_qepr!=NULL ){
@@ -425,6 +469,15 @@ void QuantifiersEngine::check( Theory::Effort e ){
       d_recorded_inst.clear();
     }
     
+    if( options::instThrottle() ){
+      //reset the budget for this round
+      d_throttle_insts = 0;
+      d_throttle_start = double(clock())/double(CLOCKS_PER_SEC);
+      d_throttle_min_score = (uint64_t)-1;
+      d_throttle_active = false;
+      d_throttled = false;
+    }
+
     double clSet = 0;
     if( Trace.isOn("quant-engine") ){
       clSet = double(clock())/double(CLOCKS_PER_SEC);
@@ -635,6 +688,10 @@ void QuantifiersEngine::check( Theory::Effort e ){
         Trace("quant-engine-debug") << "Done building the model." << std::endl;
       }
     }
+    if( d_throttled ){
+      Trace("quant-engine") << "Set incomplete because instantiations were throttled." << std::endl;
+      setIncomplete = true;
+    }
     if( setIncomplete ){
       Trace("quant-engine") << "Set incomplete flag." << std::endl;
       getOutputChannel().setIncomplete();
@@ -823,12 +880,23 @@ void QuantifiersEngine::addTermToDatabase( Node n, bool withinQuant, bool within
 
 void QuantifiersEngine::eqNotifyNewClass(TNode t) {
   addTermToDatabase( t );
+  d_term_db->eqNotifyNewClass( t );
+  if( d_qcf ){
+    d_qcf->newEqClass( t );
+  }
   if( d_eq_query->getEqualityInference() ){
     d_eq_query->getEqualityInference()->eqNotifyNewClass( t );
   }
 }
 
 void QuantifiersEngine::eqNotifyPreMerge(TNode t1, TNode t2) {
+  d_term_db->eqNotifyPreMerge( t1, t2 );
+  if( d_code_tree ){
+    d_code_tree->eqNotifyPreMerge( t1, t2 );
+  }
+  if( d_qcf ){
+    d_qcf->merge( t1, t2 );
+  }
   if( d_eq_query->getEqualityInference() ){
     d_eq_query->getEqualityInference()->eqNotifyMerge( t1, t2 );
   }
@@ -839,9 +907,10 @@ void QuantifiersEngine::eqNotifyPostMerge(TNode t1, TNode t2) {
 }
 
 void QuantifiersEngine::eqNotifyDisequal(TNode t1, TNode t2, TNode reason) {
-  //if( d_qcf ){
-  //  d_qcf->assertDisequal( t1, t2 );
-  //}
+  d_term_db->eqNotifyDisequal( t1, t2 );
+  if( d_qcf ){
+    d_qcf->assertDisequal( t1, t2 );
+  }
 }
 
 void QuantifiersEngine::computeTermVector( Node f, InstMatch& m, std::vector< Node >& vars, std::vector< Node >& terms ){
@@ -860,6 +929,30 @@ bool QuantifiersEngine::recordInstantiationInternal( Node q, std::vector< Node >
     //record the instantiation for deletion later
     d_recorded_inst.push_back( std::pair< Node, std::vector< Node > >( q, terms ) );
   }
+  //exact duplicates are found in the hash sets, all other queries are answered by the tries
+  bool useHash = options::instDedupHash() && !modEq;
+  size_t h = 0;
+  if( useHash ){
+    ++(d_statistics.d_inst_dedup_queries);
+    h = inst::InstMatchHashFunction()( terms );
+    bool filtered = false;
+    bool exists;
+    if( options::incrementalSolving() ){
+      std::map< Node, inst::CDInstMatchHashSet* >::iterator it = d_c_inst_match_hash.find( q );
+      exists = it!=d_c_inst_match_hash.end() && it->second->contains( terms, h, filtered );
+    }else{
+      std::map< Node, inst::InstMatchHashSet* >::iterator it = d_inst_match_hash.find( q );
+      exists = it!=d_inst_match_hash.end() && it->second->contains( terms, h, filtered );
+    }
+    if( filtered ){
+      ++(d_statistics.d_inst_dedup_filtered);
+    }
+    if( exists ){
+      Trace("inst-add-debug") << "Found in inst hash set" << std::endl;
+      ++(d_statistics.d_inst_dedup_hits);
+      return false;
+    }
+  }
   if( options::incrementalSolving() ){
     Trace("inst-add-debug") << "Adding into context-dependent inst trie, modEq = " << modEq << std::endl;
     inst::CDInstMatchTrie* imt;
@@ -870,15 +963,97 @@ bool QuantifiersEngine::recordInstantiationInternal( Node q, std::vector< Node >
       imt = new CDInstMatchTrie( getUserContext() );
       d_c_inst_match_trie[q] = imt;
     }
-    return imt->addInstMatch( this, q, terms, getUserContext(), modEq );
+    bool ret = imt->addInstMatch( this, q, terms, getUserContext(), modEq );
+    if( useHash ){
+      std::map< Node, inst::CDInstMatchHashSet* >::iterator it = d_c_inst_match_hash.find( q );
+      if( it==d_c_inst_match_hash.end() ){
+        d_c_inst_match_hash[q] = new inst::CDInstMatchHashSet( getUserContext() );
+      }
+      d_c_inst_match_hash[q]->add( terms, h );
+    }
+    return ret;
   }else{
     Trace("inst-add-debug") << "Adding into inst trie" << std::endl;
-    return d_inst_match_trie[q].addInstMatch( this, q, terms, modEq );
+    bool ret = d_inst_match_trie[q].addInstMatch( this, q, terms, modEq );
+    if( useHash ){
+      std::map< Node, inst::InstMatchHashSet* >::iterator it = d_inst_match_hash.find( q );
+      if( it==d_inst_match_hash.end() ){
+        d_inst_match_hash[q] = new inst::InstMatchHashSet;
+      }
+      d_inst_match_hash[q]->add( terms, h );
+    }
+    return ret;
   }
 }
 
+quantifiers::InstProfile* QuantifiersEngine::getInstProfile( Node q ) {
+  return options::instProfile() ? &d_inst_profile[q] : NULL;
+}
+
+uint64_t QuantifiersEngine::getInstantiationScore( Node q, std::vector< Node >& terms, uint64_t& gen ) {
+  //the generation is one more than the maximum instantiation level of the terms
+  gen = 0;
+  for( unsigned i=0; i<terms.size(); i++ ){
+    if( terms[i].hasAttribute(InstLevelAttribute()) ){
+      uint64_t il = terms[i].getAttribute(InstLevelAttribute());
+      gen = il>gen ? il : gen;
+    }
+  }
+  gen++;
+  uint64_t score = gen;
+  //penalize quantified formulas that were instantiated often (logarithmically)
+  std::map< Node, quantifiers::InstProfile >::iterator it = d_inst_profile.find( q );
+  if( it!=d_inst_profile.end() ){
+    for( unsigned n = it->second.d_insts; n>0; n = n/2 ){
+      score++;
+    }
+  }
+  //penalize quantified formulas that are not relevant to the goal
+  if( d_quant_rel ){
+    int r = d_quant_rel->getRelevance( q );
+    if( r>0 ){
+      score += r;
+    }
+  }
+  return score;
+}
+
+bool QuantifiersEngine::isInstantiationThrottled( Node q, uint64_t score ) {
+  if( !d_throttle_active ){
+    if( d_throttle_insts>=options::instThrottleLemmas() ){
+      Trace("inst-throttle") << "Lemma budget exhausted after " << d_throttle_insts << " instantiations." << std::endl;
+      d_throttle_active = true;
+    }else if( options::instThrottleTime()>0 ){
+      double clSet = double(clock())/double(CLOCKS_PER_SEC);
+      if( ( clSet-d_throttle_start )*1000>options::instThrottleTime() ){
+        Trace("inst-throttle") << "Time budget exhausted after " << d_throttle_insts << " instantiations." << std::endl;
+        d_throttle_active = true;
+      }
+    }
+    if( d_throttle_active ){
+      ++(d_statistics.d_inst_throttle_rounds);
+    }
+  }
+  //once the budget is exhausted, only instantiations with the best score of this round are added
+  if( d_throttle_active && score>d_throttle_min_score ){
+    ++(d_statistics.d_inst_throttled);
+    d_throttled = true;
+    d_throttled_count++;
+    if( options::instProfile() ){
+      d_inst_profile[q].d_throttled++;
+    }
+    return true;
+  }
+  d_throttle_min_score = score<d_throttle_min_score ? score : d_throttle_min_score;
+  return false;
+}
+
 bool QuantifiersEngine::removeInstantiationInternal( Node q, std::vector< Node >& terms ) {
   if( options::incrementalSolving() ){
+    std::map< Node, inst::CDInstMatchHashSet* >::iterator ith = d_c_inst_match_hash.find( q );
+    if( ith!=d_c_inst_match_hash.end() ){
+      ith->second->remove( terms );
+    }
     std::map< Node, inst::CDInstMatchTrie* >::iterator it = d_c_inst_match_trie.find( q );
     if( it!=d_c_inst_match_trie.end() ){
       return it->second->removeInstMatch( this, q, terms );
@@ -886,6 +1061,10 @@ bool QuantifiersEngine::removeInstantiationInternal( Node q, std::vector< Node >
       return false;
     }
   }else{
+    std::map< Node, inst::InstMatchHashSet* >::iterator ith = d_inst_match_hash.find( q );
+    if( ith!=d_inst_match_hash.end() ){
+      ith->second->remove( terms );
+    }
     return d_inst_match_trie[q].removeInstMatch( this, q, terms );
   }
 }
@@ -1075,7 +1254,6 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
   Assert( !d_conflict );
   Assert( terms.size()==q[0].getNumChildren() );
   Trace("inst-add-debug") << "For quantified formula " << q << ", add instantiation: " << std::endl;
-  std::vector< Node > rlv_cond;
   for( unsigned i=0; i<terms.size(); i++ ){
     Trace("inst-add-debug") << "  " << q[0][i];
     Trace("inst-add-debug2") << " -> " << terms[i];
@@ -1093,11 +1271,6 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
     if( terms[i].isNull() ){
       Trace("inst-add-debug") << " --> Failed to make term vector, due to term/type restrictions." << std::endl;
       return false;
-    }else{
-      //get relevancy conditions
-      if( options::instRelevantCond() ){
-        quantifiers::TermDb::getRelevancyCondition( terms[i], rlv_cond );
-      }
     }
 #ifdef CVC4_ASSERTIONS
     bool bad_inst = false;
@@ -1161,9 +1334,46 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
   if( alreadyExists ){
     Trace("inst-add-debug") << " --> Already exists." << std::endl;
     ++(d_statistics.d_inst_duplicate_eq);
+    if( options::instProfile() ){
+      d_inst_profile[q].d_duplicates++;
+    }
     return false;
   }
 
+  //check the budget for instantiations in this round, only new instantiations count
+  if( options::instThrottle() ){
+    if( !doVts ){
+      uint64_t gen;
+      uint64_t score = getInstantiationScore( q, terms, gen );
+      if( isInstantiationThrottled( q, score ) ){
+        Trace("inst-add-debug") << " --> Throttled, score = " << score << "." << std::endl;
+        //not added, so it must not be considered a duplicate later
+        removeInstantiationInternal( q, terms );
+        return false;
+      }
+    }
+    //counted when accepted, so that batched instantiations count before the batch is flushed
+    d_throttle_insts++;
+  }
+
+  if( d_inst_batch ){
+    Trace("inst-add-debug") << " --> Added to batch." << std::endl;
+    d_inst_batch_pending.push_back( std::pair< Node, std::vector< Node > >( q, terms ) );
+    d_inst_batch_vts.push_back( doVts );
+    return true;
+  }
+  return addInstantiationLemma( q, terms, doVts );
+}
+
+bool QuantifiersEngine::addInstantiationLemma( Node q, std::vector< Node >& terms, bool doVts ) {
+  //get relevancy conditions
+  std::vector< Node > rlv_cond;
+  if( options::instRelevantCond() ){
+    for( unsigned i=0; i<terms.size(); i++ ){
+      quantifiers::TermDb::getRelevancyCondition( terms[i], rlv_cond );
+    }
+  }
+
   //construct the instantiation
   Trace("inst-add-debug") << "Constructing instantiation..." << std::endl;
   Assert( d_term_db->d_vars[q].size()==terms.size() );
@@ -1205,10 +1415,10 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
         }
       }
     }
-    if( options::instMaxLevel()!=-1 ){
+    if( options::instMaxLevel()!=-1 || options::instThrottle() || options::instProfile() ){
       if( doVts ){
         //virtual term substitution/instantiation level features are incompatible
-        Assert( false );
+        Assert( options::instMaxLevel()==-1 );
       }else{
         uint64_t maxInstLevel = 0;
         for( unsigned i=0; i<terms.size(); i++ ){
@@ -1219,6 +1429,11 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
           }
         }
         setInstantiationLevelAttr( orig_body, q[1], maxInstLevel+1 );
+        if( options::instThrottle() || options::instProfile() ){
+          quantifiers::InstProfile& ip = d_inst_profile[q];
+          ip.d_insts++;
+          ip.d_max_gen = maxInstLevel+1>ip.d_max_gen ? maxInstLevel+1 : ip.d_max_gen;
+        }
       }
     }
     if( d_curr_effort_level>QEFFORT_CONFLICT && d_curr_effort_level<QEFFORT_NONE ){
@@ -1226,6 +1441,9 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
       for( unsigned j=0; j<d_inst_notify.size(); j++ ){
         if( !d_inst_notify[j]->notifyInstantiation( d_curr_effort_level, q, lem, terms, body ) ){
           Trace("inst-add-debug") << "...we are in conflict." << std::endl;
+          if( options::instProfile() ){
+            d_inst_profile[q].d_conflicts++;
+          }
           d_conflict = true;
           d_conflict_c = true;
           Assert( !d_lemmas_waiting.empty() );
@@ -1253,6 +1471,55 @@ bool QuantifiersEngine::addInstantiation( Node q, std::vector< Node >& terms, bo
   }
 }
 
+namespace {
+
+/** orders the instantiations of a batch by quantified formula, then by terms */
+class InstBatchSort {
+  std::vector< std::pair< Node, std::vector< Node > > >* d_pending;
+public:
+  InstBatchSort( std::vector< std::pair< Node, std::vector< Node > > >* pending ) : d_pending( pending ) {}
+  bool operator()( unsigned i, unsigned j ) {
+    return (*d_pending)[i]<(*d_pending)[j];
+  }
+};/* class InstBatchSort */
+
+}/* anonymous namespace */
+
+void QuantifiersEngine::beginInstantiationBatch() {
+  Assert( d_inst_batch_pending.empty() );
+  d_inst_batch = true;
+}
+
+unsigned QuantifiersEngine::flushInstantiationBatch() {
+  d_inst_batch = false;
+  if( d_inst_batch_pending.empty() ){
+    return 0;
+  }
+  ++(d_statistics.d_inst_batches);
+  d_statistics.d_inst_batched += d_inst_batch_pending.size();
+  Trace("inst-batch") << "Flush batch of " << d_inst_batch_pending.size() << " instantiations." << std::endl;
+  //the order does not depend on the order in which the quantified formulas were processed
+  std::vector< unsigned > order;
+  for( unsigned i=0; i<d_inst_batch_pending.size(); i++ ){
+    order.push_back( i );
+  }
+  InstBatchSort ibs( &d_inst_batch_pending );
+  std::sort( order.begin(), order.end(), ibs );
+  unsigned addedLemmas = 0;
+  for( unsigned i=0; i<order.size(); i++ ){
+    std::pair< Node, std::vector< Node > >& inst = d_inst_batch_pending[order[i]];
+    if( d_conflict ){
+      //not added, so it must not be considered a duplicate later
+      removeInstantiationInternal( inst.first, inst.second );
+    }else if( addInstantiationLemma( inst.first, inst.second, d_inst_batch_vts[order[i]] ) ){
+      addedLemmas++;
+    }
+  }
+  d_inst_batch_pending.clear();
+  d_inst_batch_vts.clear();
+  return addedLemmas;
+}
+
 bool QuantifiersEngine::removeInstantiation( Node q, Node lem, std::vector< Node >& terms ) {
   //lem must occur in d_waiting_lemmas
   if( removeLemma( lem ) ){
@@ -1441,6 +1708,12 @@ void QuantifiersEngine::getExplanationForInstLemmas( std::vector< Node >& lems,
   }
 }
 
+void QuantifiersEngine::printInstantiationProfile( std::ostream& out ) {
+  for( std::map< Node, quantifiers::InstProfile >::iterator it = d_inst_profile.begin(); it != d_inst_profile.end(); ++it ){
+    out << "[quantifier_instances] " << it->first << " : " << it->second.d_insts << " : " << it->second.d_max_gen << " : " << it->second.d_throttled << std::endl;
+  }
+}
+
 void QuantifiersEngine::printInstantiations( std::ostream& out ) {
   bool useUnsatCore = false;
   std::vector< Node > active_lemmas;
@@ -1584,7 +1857,26 @@ QuantifiersEngine::Statistics::Statistics()
       d_instantiations_fmf_exh("QuantifiersEngine::Instantiations_Fmf_Exh", 0),
       d_instantiations_fmf_mbqi("QuantifiersEngine::Instantiations_Fmf_Mbqi", 0),
       d_instantiations_cbqi("QuantifiersEngine::Instantiations_Cbqi", 0),
-      d_instantiations_rr("QuantifiersEngine::Instantiations_Rewrite_Rules", 0)
+      d_instantiations_rr("QuantifiersEngine::Instantiations_Rewrite_Rules", 0),
+      d_term_db_index_time("QuantifiersEngine::TermDb_Index_Time"),
+      d_term_db_indices_reused("QuantifiersEngine::TermDb_Indices_Reused", 0),
+      d_term_db_indices_rebuilt("QuantifiersEngine::TermDb_Indices_Rebuilt", 0),
+      d_code_tree_instructions("QuantifiersEngine::CodeTree_Instructions", 0),
+      d_code_tree_shared("QuantifiersEngine::CodeTree_Shared_Instructions", 0),
+      d_code_tree_full_runs("QuantifiersEngine::CodeTree_Full_Runs", 0),
+      d_code_tree_incremental_runs("QuantifiersEngine::CodeTree_Incremental_Runs", 0),
+      d_code_tree_candidates("QuantifiersEngine::CodeTree_Candidates", 0),
+      d_inst_batches("QuantifiersEngine::Inst_Batches", 0),
+      d_inst_batched("QuantifiersEngine::Inst_Batched", 0),
+      d_inst_dedup_queries("QuantifiersEngine::Inst_Dedup_Queries", 0),
+      d_inst_dedup_filtered("QuantifiersEngine::Inst_Dedup_Filtered", 0),
+      d_inst_dedup_hits("QuantifiersEngine::Inst_Dedup_Hits", 0),
+      d_inst_throttled("QuantifiersEngine::Inst_Throttled", 0),
+      d_fmc_defs_reused("QuantifiersEngine::FMC_Defs_Reused", 0),
+      d_fmc_quants_reused("QuantifiersEngine::FMC_Quant_Checks_Reused", 0),
+      d_fmc_eval_tuples("QuantifiersEngine::FMC_Eval_Tuples", 0),
+      d_fmc_eval_filtered("QuantifiersEngine::FMC_Eval_Filtered", 0),
+      d_inst_throttle_rounds("QuantifiersEngine::Inst_Throttle_Rounds", 0)
 {
   smtStatisticsRegistry()->registerStat(&d_time);
   smtStatisticsRegistry()->registerStat(&d_qcf_time);
@@ -1610,6 +1902,25 @@ QuantifiersEngine::Statistics::Statistics()
   smtStatisticsRegistry()->registerStat(&d_instantiations_fmf_mbqi);
   smtStatisticsRegistry()->registerStat(&d_instantiations_cbqi);
   smtStatisticsRegistry()->registerStat(&d_instantiations_rr);
+  smtStatisticsRegistry()->registerStat(&d_term_db_index_time);
+  smtStatisticsRegistry()->registerStat(&d_term_db_indices_reused);
+  smtStatisticsRegistry()->registerStat(&d_term_db_indices_rebuilt);
+  smtStatisticsRegistry()->registerStat(&d_code_tree_instructions);
+  smtStatisticsRegistry()->registerStat(&d_code_tree_shared);
+  smtStatisticsRegistry()->registerStat(&d_code_tree_full_runs);
+  smtStatisticsRegistry()->registerStat(&d_code_tree_incremental_runs);
+  smtStatisticsRegistry()->registerStat(&d_code_tree_candidates);
+  smtStatisticsRegistry()->registerStat(&d_inst_batches);
+  smtStatisticsRegistry()->registerStat(&d_inst_batched);
+  smtStatisticsRegistry()->registerStat(&d_inst_dedup_queries);
+  smtStatisticsRegistry()->registerStat(&d_inst_dedup_filtered);
+  smtStatisticsRegistry()->registerStat(&d_inst_dedup_hits);
+  smtStatisticsRegistry()->registerStat(&d_inst_throttled);
+  smtStatisticsRegistry()->registerStat(&d_fmc_defs_reused);
+  smtStatisticsRegistry()->registerStat(&d_fmc_quants_reused);
+  smtStatisticsRegistry()->registerStat(&d_fmc_eval_tuples);
+  smtStatisticsRegistry()->registerStat(&d_fmc_eval_filtered);
+  smtStatisticsRegistry()->registerStat(&d_inst_throttle_rounds);
 }
 
 QuantifiersEngine::Statistics::~Statistics(){
@@ -1637,6 +1948,25 @@ QuantifiersEngine::Statistics::~Statistics(){
   smtStatisticsRegistry()->unregisterStat(&d_instantiations_fmf_mbqi);
   smtStatisticsRegistry()->unregisterStat(&d_instantiations_cbqi);
   smtStatisticsRegistry()->unregisterStat(&d_instantiations_rr);
+  smtStatisticsRegistry()->unregisterStat(&d_term_db_index_time);
+  smtStatisticsRegistry()->unregisterStat(&d_term_db_indices_reused);
+  smtStatisticsRegistry()->unregisterStat(&d_term_db_indices_rebuilt);
+  smtStatisticsRegistry()->unregisterStat(&d_code_tree_instructions);
+  smtStatisticsRegistry()->unregisterStat(&d_code_tree_shared);
+  smtStatisticsRegistry()->unregisterStat(&d_code_tree_full_runs);
+  smtStatisticsRegistry()->unregisterStat(&d_code_tree_incremental_runs);
+  smtStatisticsRegistry()->unregisterStat(&d_code_tree_candidates);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_batches);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_batched);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_dedup_queries);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_dedup_filtered);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_dedup_hits);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_throttled);
+  smtStatisticsRegistry()->unregisterStat(&d_fmc_defs_reused);
+  smtStatisticsRegistry()->unregisterStat(&d_fmc_quants_reused);
+  smtStatisticsRegistry()->unregisterStat(&d_fmc_eval_tuples);
+  smtStatisticsRegistry()->unregisterStat(&d_fmc_eval_filtered);
+  smtStatisticsRegistry()->unregisterStat(&d_inst_throttle_rounds);
 }
 
 eq::EqualityEngine* QuantifiersEngine::getMasterEqualityEngine(){
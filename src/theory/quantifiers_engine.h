@@ -26,6 +26,7 @@
 #include "expr/attribute.h"
 #include "options/quantifiers_modes.h"
 #include "theory/quantifiers/inst_match.h"
+#include "theory/quantifiers/inst_profile.h"
 #include "theory/quantifiers/quant_util.h"
 #include "theory/theory.h"
 #include "util/hash.h"
@@ -79,6 +80,7 @@ namespace quantifiers {
 
 namespace inst {
   class TriggerTrie;
+  class InstMatchCodeTree;
 }/* CVC4::theory::inst */
 
 //class EfficientEMatcher;
@@ -181,6 +183,9 @@ private:
   /** list of all instantiations produced for each quantifier */
   std::map< Node, inst::InstMatchTrie > d_inst_match_trie;
   std::map< Node, inst::CDInstMatchTrie* > d_c_inst_match_trie;
+  /** the same instantiations, for detecting duplicates without traversing the tries */
+  std::map< Node, inst::InstMatchHashSet* > d_inst_match_hash;
+  std::map< Node, inst::CDInstMatchHashSet* > d_c_inst_match_hash;
   /** recorded instantiations */
   std::vector< std::pair< Node, std::vector< Node > > > d_recorded_inst;
   /** quantifiers that have been skolemized */
@@ -189,8 +194,25 @@ private:
   quantifiers::TermDb* d_term_db;
   /** all triggers will be stored in this trie */
   inst::TriggerTrie* d_tr_trie;
+  /** code tree for matching single triggers (if --ematch-code-tree) */
+  inst::InstMatchCodeTree* d_code_tree;
   /** extended model object */
   quantifiers::FirstOrderModel* d_model;
+  /** instantiation profile of each quantified formula (if --inst-throttle or --inst-profile) */
+  std::map< Node, quantifiers::InstProfile > d_inst_profile;
+  /** statistic reporting d_inst_profile (if --inst-profile) */
+  quantifiers::InstProfileStat* d_inst_profile_stat;
+  /** throttling of the current round : number of instantiations, start time */
+  unsigned d_throttle_insts;
+  double d_throttle_start;
+  /** lowest score of an instantiation in the current round */
+  uint64_t d_throttle_min_score;
+  /** whether the budget of the current round is exhausted */
+  bool d_throttle_active;
+  /** whether an instantiation was rejected by throttling in the current round */
+  bool d_throttled;
+  /** number of instantiations rejected by throttling so far */
+  unsigned d_throttled_count;
   /** statistics for debugging */
   std::map< Node, int > d_total_inst_debug;
   std::map< Node, int > d_temp_inst_debug;
@@ -279,6 +301,8 @@ public:
   void finishInit();
   /** presolve */
   void presolve();
+  /** postsolve */
+  void postsolve();
   /** notify preprocessed assertion */
   void ppNotifyAssertions( std::vector< Node >& assertions );
   /** check at level */
@@ -304,8 +328,19 @@ private:
   bool recordInstantiationInternal( Node q, std::vector< Node >& terms, bool modEq = false, bool addedLem = true );
   /** remove instantiation */
   bool removeInstantiationInternal( Node q, std::vector< Node >& terms );
+  /** construct and add the lemma for a recorded instantiation */
+  bool addInstantiationLemma( Node q, std::vector< Node >& terms, bool doVts );
+  /** whether instantiations are collected into a batch instead of being added */
+  bool d_inst_batch;
+  /** the instantiations collected in the current batch */
+  std::vector< std::pair< Node, std::vector< Node > > > d_inst_batch_pending;
+  std::vector< bool > d_inst_batch_vts;
   /** set instantiation level attr */
   static void setInstantiationLevelAttr( Node n, Node qn, uint64_t level );
+  /** get the score of instantiating q with terms, lower is better, gen is its generation */
+  uint64_t getInstantiationScore( Node q, std::vector< Node >& terms, uint64_t& gen );
+  /** is the instantiation with score rejected by the budget of the current round */
+  bool isInstantiationThrottled( Node q, uint64_t score );
 public:
   /** flush lemmas */
   void flushLemmas();
@@ -329,6 +364,11 @@ public:
   bool addInstantiation( Node q, std::vector< Node >& terms, bool mkRep = false, bool modEq = false, bool doVts = false );
   /** remove pending instantiation */
   bool removeInstantiation( Node q, Node lem, std::vector< Node >& terms );
+  /** collect the instantiations added from now on without constructing their lemmas */
+  void beginInstantiationBatch();
+  /** add the lemmas for the instantiations collected since beginInstantiationBatch,
+   * ordered by quantified formula and terms, returns the number of lemmas added */
+  unsigned flushInstantiationBatch();
   /** split on node n */
   bool addSplit( Node n, bool reqPhase = false, bool reqPhasePol = true );
   /** add split equality */
@@ -358,6 +398,8 @@ public:
   quantifiers::TermDbSygus* getTermDatabaseSygus();
   /** get trigger database */
   inst::TriggerTrie* getTriggerDatabase() { return d_tr_trie; }
+  /** get code tree for matching single triggers, NULL if not in use */
+  inst::InstMatchCodeTree* getInstMatchCodeTree() { return d_code_tree; }
   /** add term to database */
   void addTermToDatabase( Node n, bool withinQuant = false, bool withinInstClosure = false );
   /** notification when master equality engine is updated */
@@ -370,6 +412,12 @@ public:
   /** debug print equality engine */
   void debugPrintEqualityEngine( const char * c );
 public:
+  /** get the instantiation profile of q, or NULL if profiling is disabled */
+  quantifiers::InstProfile* getInstProfile( Node q );
+  /** get the number of instantiations rejected by throttling so far */
+  unsigned getNumThrottledInstantiations() { return d_throttled_count; }
+  /** print the instantiation profile of each quantified formula */
+  void printInstantiationProfile( std::ostream& out );
   /** print instantiations */
   void printInstantiations( std::ostream& out );
   /** print solution for synthesis conjectures */
@@ -416,6 +464,25 @@ public:
     IntStat d_instantiations_fmf_mbqi;
     IntStat d_instantiations_cbqi;
     IntStat d_instantiations_rr;
+    TimerStat d_term_db_index_time;
+    IntStat d_term_db_indices_reused;
+    IntStat d_term_db_indices_rebuilt;
+    IntStat d_code_tree_instructions;
+    IntStat d_code_tree_shared;
+    IntStat d_code_tree_full_runs;
+    IntStat d_code_tree_incremental_runs;
+    IntStat d_code_tree_candidates;
+    IntStat d_inst_batches;
+    IntStat d_inst_batched;
+    IntStat d_inst_dedup_queries;
+    IntStat d_inst_dedup_filtered;
+    IntStat d_inst_dedup_hits;
+    IntStat d_inst_throttled;
+    IntStat d_fmc_defs_reused;
+    IntStat d_fmc_quants_reused;
+    IntStat d_fmc_eval_tuples;
+    IntStat d_fmc_eval_filtered;
+    IntStat d_inst_throttle_rounds;
     Statistics();
     ~Statistics();
   };/* class QuantifiersEngine::Statistics */
@@ -23,10 +23,12 @@
 #include "expr/attribute.h"
 #include "expr/node.h"
 #include "expr/node_builder.h"
+#include "options/base_options.h"
 #include "options/bv_options.h"
 #include "options/options.h"
 #include "options/proof_options.h"
 #include "options/quantifiers_options.h"
+#include "options/theory_options.h"
 #include "proof/cnf_proof.h"
 #include "proof/lemma_proof.h"
 #include "proof/proof_manager.h"
@@ -293,9 +295,15 @@ TheoryEngine::TheoryEngine(context::Context* context,
   d_propagationMapTimestamp(context, 0),
   d_propagatedLiterals(context),
   d_propagatedLiteralsIndex(context, 0),
+  d_explanationCache(context),
   d_atomRequests(context),
   d_tform_remover(iteRemover),
   d_combineTheoriesTime("TheoryEngine::combineTheoriesTime"),
+  d_combineTheoriesSplits("TheoryEngine::combineTheoriesSplits", 0),
+  d_combineTheoriesSplitsAvoided("TheoryEngine::combineTheoriesSplitsAvoided", 0),
+  d_explanationTime("TheoryEngine::explanationTime"),
+  d_theoryExplanations("TheoryEngine::theoryExplanations", 0),
+  d_explanationCacheHits("TheoryEngine::explanationCacheHits", 0),
   d_true(),
   d_false(),
   d_interrupted(false),
@@ -322,6 +330,11 @@ TheoryEngine::TheoryEngine(context::Context* context,
   d_curr_model_builder = new theory::TheoryEngineModelBuilder(this);
 
   smtStatisticsRegistry()->registerStat(&d_combineTheoriesTime);
+  smtStatisticsRegistry()->registerStat(&d_combineTheoriesSplits);
+  smtStatisticsRegistry()->registerStat(&d_combineTheoriesSplitsAvoided);
+  smtStatisticsRegistry()->registerStat(&d_explanationTime);
+  smtStatisticsRegistry()->registerStat(&d_theoryExplanations);
+  smtStatisticsRegistry()->registerStat(&d_explanationCacheHits);
   d_true = NodeManager::currentNM()->mkConst<bool>(true);
   d_false = NodeManager::currentNM()->mkConst<bool>(false);
 
@@ -354,6 +367,11 @@ TheoryEngine::~TheoryEngine() {
   delete d_masterEqualityEngine;
 
   smtStatisticsRegistry()->unregisterStat(&d_combineTheoriesTime);
+  smtStatisticsRegistry()->unregisterStat(&d_combineTheoriesSplits);
+  smtStatisticsRegistry()->unregisterStat(&d_combineTheoriesSplitsAvoided);
+  smtStatisticsRegistry()->unregisterStat(&d_explanationTime);
+  smtStatisticsRegistry()->unregisterStat(&d_theoryExplanations);
+  smtStatisticsRegistry()->unregisterStat(&d_explanationCacheHits);
 
   delete d_unconstrainedSimp;
 
@@ -508,6 +526,11 @@ void TheoryEngine::check(Theory::Effort effort) {
   // Reset the interrupt flag
   d_interrupted = false;
 
+  // Flush the statistics if requested (e.g. by a signal to the driver)
+  if(StatisticsRegistry::flushRequested()) {
+    smtStatisticsRegistry()->flushInformation(*options::err());
+  }
+
 #ifdef CVC4_FOR_EACH_THEORY_STATEMENT
 #undef CVC4_FOR_EACH_THEORY_STATEMENT
 #endif
@@ -655,6 +678,10 @@ void TheoryEngine::combineTheories() {
 
   Trace("combineTheories") << "TheoryEngine::combineTheories(): care graph size = " << careGraph.size() << endl;
 
+  // With finite model finding the uf model may identify distinct classes, so
+  // we can't trust the model values of uninterpreted sorts
+  bool modelBased = options::modelBasedCombination() && !options::finiteModelFind();
+
   // Now add splitters for the ones we are interested in
   CareGraph::const_iterator care_it = careGraph.begin();
   CareGraph::const_iterator care_it_end = careGraph.end();
@@ -680,8 +707,19 @@ void TheoryEngine::combineTheories() {
     //   es == EQUALITY_UNKNOWN ? "EQUALITY_UNKNOWN" :
     //    "Unexpected case") << endl;
 
+    // If the values don't collide in the model, the theory that asked for the
+    // pair can agree on the disequality, as long as it takes the values of
+    // the owner of the type into account; otherwise we only prefer it
+    bool disequalInModel = modelBased && areDisequalInModel(carePair.a, carePair.b);
+    if (disequalInModel && agreesWithModelOf(carePair.theory, carePair.a)) {
+      Debug("combineTheories") << "TheoryEngine::combineTheories(): disequal in model, no split" << endl;
+      ++ d_combineTheoriesSplitsAvoided;
+      continue;
+    }
+
     // We need to split on it
     Debug("combineTheories") << "TheoryEngine::combineTheories(): requesting a split " << endl;
+    ++ d_combineTheoriesSplits;
 
     lemma(equality.orNode(equality.notNode()), RULE_INVALID, false, false, false, carePair.theory);
 
@@ -690,7 +728,7 @@ void TheoryEngine::combineTheories() {
     // if (true) {
     //   if (es == EQUALITY_TRUE || es == EQUALITY_TRUE_IN_MODEL) {
     Node e = ensureLiteral(equality);
-    d_propEngine->requirePhase(e, true);
+    d_propEngine->requirePhase(e, !disequalInModel);
     //   }
     //   else if (es == EQUALITY_FALSE_IN_MODEL) {
     //     Node e = ensureLiteral(equality);
@@ -700,6 +738,25 @@ void TheoryEngine::combineTheories() {
   }
 }
 
+bool TheoryEngine::areDisequalInModel(TNode a, TNode b) {
+  TheoryId owner = Theory::theoryOf(a.getType());
+  // The owner of the type only has a model value for the terms it was told about
+  if (!a.isConst() && !Theory::setContains(owner, d_sharedTerms.getNotifiedTheories(a))) {
+    return false;
+  }
+  if (!b.isConst() && !Theory::setContains(owner, d_sharedTerms.getNotifiedTheories(b))) {
+    return false;
+  }
+  return theoryOf(owner)->getEqualityStatus(a, b) == EQUALITY_FALSE_IN_MODEL;
+}
+
+bool TheoryEngine::agreesWithModelOf(TheoryId theory, TNode a) {
+  // Uninterpreted functions are interpreted over the values of their
+  // arguments when the model is built.  Arrays, datatypes and sets build
+  // their models from their own equivalence classes only.
+  return theory == Theory::theoryOf(a.getType()) || theory == THEORY_UF;
+}
+
 void TheoryEngine::propagate(Theory::Effort effort) {
   // Reset the interrupt flag
   d_interrupted = false;
@@ -1530,9 +1587,34 @@ static Node mkExplanation(const std::vector<NodeTheoryPair>& explanation) {
   return conjunction;
 }
 
+Node TheoryEngine::explainFromTheory(TNode node, TheoryId theory) {
+  ++ d_theoryExplanations;
+
+  NodeTheoryPair key(node, theory);
+  ExplanationCache::const_iterator find = d_explanationCache.find(key);
+  if (find != d_explanationCache.end()) {
+    ++ d_explanationCacheHits;
+    return (*find).second;
+  }
+
+  Node explanation;
+  if (theory == THEORY_BUILTIN) {
+    explanation = d_sharedTerms.explain(node);
+  } else {
+    explanation = theoryOf(theory)->explain(node);
+  }
+
+  if (d_explanationCache.size() < options::explanationCacheSize()) {
+    d_explanationCache.insert(key, explanation);
+  }
+  return explanation;
+}
+
 Node TheoryEngine::getExplanationAndRecipe(TNode node, LemmaProofRecipe* proofRecipe) {
   Debug("theory::explain") << "TheoryEngine::getExplanation(" << node << "): current propagation index = " << d_propagationMapTimestamp << endl;
 
+  TimerStat::CodeTimer explanationTimer(d_explanationTime, true);
+
   bool polarity = node.getKind() != kind::NOT;
   TNode atom = polarity ? node : node[0];
 
@@ -1542,7 +1624,7 @@ Node TheoryEngine::getExplanationAndRecipe(TNode node, LemmaProofRecipe* proofRe
                              << " Responsible theory is: "
                              << theoryOf(atom)->getId() << std::endl;
 
-    Node explanation = theoryOf(atom)->explain(node);
+    Node explanation = explainFromTheory(node, theoryOf(atom)->getId());
     Debug("theory::explain") << "TheoryEngine::getExplanation(" << node << ") => " << explanation << endl;
     PROOF({
         if(proofRecipe) {
@@ -2036,6 +2118,8 @@ bool TheoryEngine::donePPSimpITE(std::vector<Node>& assertions){
 void TheoryEngine::getExplanation(std::vector<NodeTheoryPair>& explanationVector, LemmaProofRecipe* proofRecipe) {
   Assert(explanationVector.size() > 0);
 
+  TimerStat::CodeTimer explanationTimer(d_explanationTime, true);
+
   unsigned i = 0; // Index of the current literal we are processing
   unsigned j = 0; // Index of the last literal we are keeping
 
@@ -2105,16 +2189,9 @@ void TheoryEngine::getExplanation(std::vector<NodeTheoryPair>& explanationVector
     }
 
     // It was produced by the theory, so ask for an explanation
-    Node explanation;
-    if (toExplain.theory == THEORY_BUILTIN) {
-      explanation = d_sharedTerms.explain(toExplain.node);
-      Debug("theory::explain") << "\tTerm was propagated by THEORY_BUILTIN. Explanation: " << explanation << std::endl;
-    } else {
-      explanation = theoryOf(toExplain.theory)->explain(toExplain.node);
-      Debug("theory::explain") << "\tTerm was propagated by owner theory: "
-                               << theoryOf(toExplain.theory)->getId()
-                               << ". Explanation: " << explanation << std::endl;
-    }
+    Node explanation = explainFromTheory(toExplain.node, toExplain.theory);
+    Debug("theory::explain") << "\tTerm was propagated by " << toExplain.theory
+                             << ". Explanation: " << explanation << std::endl;
 
     Debug("theory::explain") << "TheoryEngine::explain(): got explanation " << explanation << " got from " << toExplain.theory << endl;
     Assert( explanation != toExplain.node, "wasn't sent to you, so why are you explaining it trivially");
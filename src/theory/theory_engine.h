@@ -387,6 +387,23 @@ class TheoryEngine {
    */
   context::CDO<unsigned> d_propagatedLiteralsIndex;
 
+  /**
+   * Explanations the theories gave for their propagations. Explanations are
+   * only requested lazily by the SAT solver, but conflict analysis and the
+   * explanation of shared propagations ask for the same literals repeatedly.
+   * The cache is SAT context dependent (an explanation stays valid until the
+   * level it was computed at is popped) and bounded by
+   * options::explanationCacheSize().
+   */
+  typedef context::CDHashMap<NodeTheoryPair, Node, NodeTheoryPairHashFunction> ExplanationCache;
+  ExplanationCache d_explanationCache;
+
+  /**
+   * Get the explanation of node from the theory that propagated it,
+   * going through the explanation cache.
+   */
+  Node explainFromTheory(TNode node, theory::TheoryId theory);
+
   /**
    * Called by the output channel to propagate literals and facts
    * @return false if immediate conflict
@@ -447,6 +464,35 @@ class TheoryEngine {
   /** Time spent in theory combination */
   TimerStat d_combineTheoriesTime;
 
+  /** Number of splits on care pairs requested by theory combination */
+  IntStat d_combineTheoriesSplits;
+
+  /** Number of care pairs for which model-based combination avoided a split */
+  IntStat d_combineTheoriesSplitsAvoided;
+
+  /** Time spent constructing explanations */
+  TimerStat d_explanationTime;
+
+  /** Number of explanations requested from the theories */
+  IntStat d_theoryExplanations;
+
+  /** Number of theory explanations found in the explanation cache */
+  IntStat d_explanationCacheHits;
+
+  /**
+   * Returns true if a and b have different values in the model of the theory
+   * owning their type, in which case (with model-based theory combination)
+   * no split on a = b is needed.
+   */
+  bool areDisequalInModel(TNode a, TNode b);
+
+  /**
+   * Returns true if the model built by theory is consistent with any values
+   * the theory owning the type of a assigns to a and the terms it is paired
+   * with, so that a care pair of theory may be skipped when they differ.
+   */
+  bool agreesWithModelOf(theory::TheoryId theory, TNode a);
+
   Node d_true;
   Node d_false;
 
@@ -17,6 +17,7 @@
 
 #include "theory/uf/equality_engine.h"
 
+#include "options/uf_options.h"
 #include "smt/smt_statistics_registry.h"
 
 namespace CVC4 {
@@ -27,12 +28,20 @@ EqualityEngine::Statistics::Statistics(std::string name)
     : mergesCount(name + "::mergesCount", 0),
       termsCount(name + "::termsCount", 0),
       functionTermsCount(name + "::functionTermsCount", 0),
-      constantTermsCount(name + "::constantTermsCount", 0)
+      constantTermsCount(name + "::constantTermsCount", 0),
+      explanationsCount(name + "::explanationsCount", 0),
+      explanationCacheHits(name + "::explanationCacheHits", 0),
+      explanationLength(name + "::explanationLength"),
+      explanationTime(name + "::explanationTime")
 {
   smtStatisticsRegistry()->registerStat(&mergesCount);
   smtStatisticsRegistry()->registerStat(&termsCount);
   smtStatisticsRegistry()->registerStat(&functionTermsCount);
   smtStatisticsRegistry()->registerStat(&constantTermsCount);
+  smtStatisticsRegistry()->registerStat(&explanationsCount);
+  smtStatisticsRegistry()->registerStat(&explanationCacheHits);
+  smtStatisticsRegistry()->registerStat(&explanationLength);
+  smtStatisticsRegistry()->registerStat(&explanationTime);
 }
 
 EqualityEngine::Statistics::~Statistics() {
@@ -40,6 +49,10 @@ EqualityEngine::Statistics::~Statistics() {
   smtStatisticsRegistry()->unregisterStat(&termsCount);
   smtStatisticsRegistry()->unregisterStat(&functionTermsCount);
   smtStatisticsRegistry()->unregisterStat(&constantTermsCount);
+  smtStatisticsRegistry()->unregisterStat(&explanationsCount);
+  smtStatisticsRegistry()->unregisterStat(&explanationCacheHits);
+  smtStatisticsRegistry()->unregisterStat(&explanationLength);
+  smtStatisticsRegistry()->unregisterStat(&explanationTime);
 }
 
 /**
@@ -183,16 +196,16 @@ EqualityNodeId EqualityEngine::newApplicationNode(TNode original, EqualityNodeId
   d_applications[funId] = FunctionApplicationPair(funOriginal, funNormalized);
 
   // Add the lookup data, if it's not already there
-  ApplicationIdsMap::iterator find = d_applicationLookup.find(funNormalized);
-  if (find == d_applicationLookup.end()) {
+  EqualityNodeId find = d_applicationLookup.find(funNormalized);
+  if (find == null_id) {
     Debug("equality") << d_name << "::eq::newApplicationNode(" << original << ", " << t1 << ", " << t2 << "): no lookup, setting up" << std::endl;
     // Mark the normalization to the lookup
     storeApplicationLookup(funNormalized, funId);
   } else {
     // If it's there, we need to merge these two
     Debug("equality") << d_name << "::eq::newApplicationNode(" << original << ", " << t1 << ", " << t2 << "): lookup exists, adding to queue" << std::endl;
-    Debug("equality") << d_name << "::eq::newApplicationNode(" << original << ", " << t1 << ", " << t2 << "): lookup = " << d_nodes[find->second] << std::endl;
-    enqueue(MergeCandidate(funId, find->second, MERGED_THROUGH_CONGRUENCE, TNode::null()));
+    Debug("equality") << d_name << "::eq::newApplicationNode(" << original << ", " << t1 << ", " << t2 << "): lookup = " << d_nodes[find] << std::endl;
+    enqueue(MergeCandidate(funId, find, MERGED_THROUGH_CONGRUENCE, TNode::null()));
   }
 
   // Add to the use lists
@@ -639,11 +652,11 @@ bool EqualityEngine::merge(EqualityNode& class1, EqualityNode& class2, std::vect
         EqualityNodeId aNormalized = getEqualityNode(fun.a).getFind();
         EqualityNodeId bNormalized = getEqualityNode(fun.b).getFind();
         FunctionApplication funNormalized(fun.type, aNormalized, bNormalized);
-        ApplicationIdsMap::iterator find = d_applicationLookup.find(funNormalized);
-        if (find != d_applicationLookup.end()) {
+        EqualityNodeId find = d_applicationLookup.find(funNormalized);
+        if (find != null_id) {
           // Applications fun and the funNormalized can be merged due to congruence
-          if (getEqualityNode(funId).getFind() != getEqualityNode(find->second).getFind()) {
-            enqueue(MergeCandidate(funId, find->second, MERGED_THROUGH_CONGRUENCE, TNode::null()));
+          if (getEqualityNode(funId).getFind() != getEqualityNode(find).getFind()) {
+            enqueue(MergeCandidate(funId, find, MERGED_THROUGH_CONGRUENCE, TNode::null()));
           }
         } else {
           // There is no representative, so we can add one, we remove this when backtracking
@@ -810,6 +823,8 @@ void EqualityEngine::backtrack() {
     }
 
     d_equalityEdges.resize(2 * d_assertedEqualitiesCount);
+
+    backtrackExplanationCache();
   }
 
   if (d_triggerTermSetUpdates.size() > d_triggerTermSetUpdatesSize) {
@@ -837,6 +852,7 @@ void EqualityEngine::backtrack() {
       d_applicationLookup.erase(d_applicationLookups[i]);
     }
     d_applicationLookups.resize(d_applicationLookupsCount);
+    d_applicationLookup.compact();
   }
 
   if (d_subtermEvaluates.size() > d_subtermEvaluatesSize) {
@@ -920,9 +936,27 @@ std::string EqualityEngine::edgesToString(EqualityEdgeId edgeId) const {
   return out.str();
 }
 
+void EqualityEngine::backtrackExplanationCache() {
+  // Keys were inserted with non-decreasing counts of asserted equalities, so the
+  // invalidated entries are a suffix of the key list
+  while (!d_explanationCacheKeys.empty()) {
+    ExplanationCache::iterator find = d_explanationCache.find(d_explanationCacheKeys.back());
+    Assert(find != d_explanationCache.end());
+    if (find->second.assertedEqualities <= d_assertedEqualitiesCount) {
+      break;
+    }
+    d_explanationCache.erase(find);
+    d_explanationCacheKeys.pop_back();
+  }
+}
+
 void EqualityEngine::explainEquality(TNode t1, TNode t2, bool polarity, std::vector<TNode>& equalities, EqProof * eqp) const {
   Debug("equality") << d_name << "::eq::explainEquality(" << t1 << ", " << t2 << ", " << (polarity ? "true" : "false") << ")" << ", proof = " << (eqp ? "ON" : "OFF") << std::endl;
 
+  TimerStat::CodeTimer explanationTimer(d_stats.explanationTime);
+  ++ d_stats.explanationsCount;
+  size_t explanationStart = equalities.size();
+
   // The terms must be there already
   Assert(hasTerm(t1) && hasTerm(t2));;
 
@@ -1006,14 +1040,20 @@ void EqualityEngine::explainEquality(TNode t1, TNode t2, bool polarity, std::vec
       eqp->debug_print("pf::ee", 1);
     }
   }
+
+  d_stats.explanationLength.addEntry(equalities.size() - explanationStart);
 }
 
 void EqualityEngine::explainPredicate(TNode p, bool polarity, std::vector<TNode>& assertions, EqProof * eqp) const {
   Debug("equality") << d_name << "::eq::explainPredicate(" << p << ")" << std::endl;
+  TimerStat::CodeTimer explanationTimer(d_stats.explanationTime);
+  ++ d_stats.explanationsCount;
+  size_t explanationStart = assertions.size();
   // Must have the term
   Assert(hasTerm(p));
   // Get the explanation
   getExplanation(getNodeId(p), polarity ? d_trueId : d_falseId, assertions, eqp);
+  d_stats.explanationLength.addEntry(assertions.size() - explanationStart);
 }
 
 void EqualityEngine::getExplanation(EqualityNodeId t1Id, EqualityNodeId t2Id, std::vector<TNode>& equalities, EqProof * eqp) const {
@@ -1046,6 +1086,33 @@ void EqualityEngine::getExplanation(EqualityNodeId t1Id, EqualityNodeId t2Id, st
     return;
   }
 
+  // Proofs are always reconstructed from the graph
+  if (eqp || !options::eeExplanationCache()) {
+    getExplanationFromGraph(t1Id, t2Id, equalities, eqp);
+    return;
+  }
+
+  EqualityPair key = t1Id < t2Id ? EqualityPair(t1Id, t2Id) : EqualityPair(t2Id, t1Id);
+  ExplanationCache::const_iterator find = d_explanationCache.find(key);
+  if (find != d_explanationCache.end()) {
+    Debug("equality") << d_name << "::eq::getExplanation(): cached" << std::endl;
+    ++ d_stats.explanationCacheHits;
+    const std::vector<TNode>& reasons = find->second.reasons;
+    equalities.insert(equalities.end(), reasons.begin(), reasons.end());
+    return;
+  }
+
+  size_t explanationStart = equalities.size();
+  getExplanationFromGraph(t1Id, t2Id, equalities, NULL);
+
+  CachedExplanation& cached = d_explanationCache[key];
+  cached.reasons.assign(equalities.begin() + explanationStart, equalities.end());
+  // Count the edges rather than the equalities, as an edge is added before its equality
+  cached.assertedEqualities = d_equalityEdges.size() / 2;
+  d_explanationCacheKeys.push_back(key);
+}
+
+void EqualityEngine::getExplanationFromGraph(EqualityNodeId t1Id, EqualityNodeId t2Id, std::vector<TNode>& equalities, EqProof * eqp) const {
 
   if (Debug.isOn("equality::internal")) {
     debugPrintGraph();
@@ -1677,13 +1744,13 @@ bool EqualityEngine::areDisequal(TNode t1, TNode t2, bool ensureProof) const
 
   // Create the equality
   FunctionApplication eqNormalized(APP_EQUALITY, t1ClassId, t2ClassId);
-  ApplicationIdsMap::const_iterator find = d_applicationLookup.find(eqNormalized);
-  if (find != d_applicationLookup.end()) {
-    if (getEqualityNode(find->second).getFind() == getEqualityNode(d_falseId).getFind()) {
+  EqualityNodeId find = d_applicationLookup.find(eqNormalized);
+  if (find != null_id) {
+    if (getEqualityNode(find).getFind() == getEqualityNode(d_falseId).getFind()) {
       if (ensureProof) {
-        const FunctionApplication original = d_applications[find->second].original;
+        const FunctionApplication original = d_applications[find].original;
         nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(t1Id, original.a));
-        nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(find->second, d_falseId));
+        nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(find, d_falseId));
         nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(t2Id, original.b));
         nonConst->storePropagatedDisequality(THEORY_LAST, t1Id, t2Id);
       }
@@ -1695,12 +1762,12 @@ bool EqualityEngine::areDisequal(TNode t1, TNode t2, bool ensureProof) const
   // Check the symmetric disequality
   std::swap(eqNormalized.a, eqNormalized.b);
   find = d_applicationLookup.find(eqNormalized);
-  if (find != d_applicationLookup.end()) {
-    if (getEqualityNode(find->second).getFind() == getEqualityNode(d_falseId).getFind()) {
+  if (find != null_id) {
+    if (getEqualityNode(find).getFind() == getEqualityNode(d_falseId).getFind()) {
       if (ensureProof) {
-        const FunctionApplication original = d_applications[find->second].original;
+        const FunctionApplication original = d_applications[find].original;
         nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(t2Id, original.a));
-        nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(find->second, d_falseId));
+        nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(find, d_falseId));
         nonConst->d_deducedDisequalityReasons.push_back(EqualityPair(t1Id, original.b));
         nonConst->storePropagatedDisequality(THEORY_LAST, t1Id, t2Id);
       }
@@ -1832,8 +1899,8 @@ TNode EqualityEngine::getTriggerTermRepresentative(TNode t, TheoryId tag) const
 }
 
 void EqualityEngine::storeApplicationLookup(FunctionApplication& funNormalized, EqualityNodeId funId) {
-  Assert(d_applicationLookup.find(funNormalized) == d_applicationLookup.end());
-  d_applicationLookup[funNormalized] = funId;
+  Assert(d_applicationLookup.find(funNormalized) == null_id);
+  d_applicationLookup.insert(funNormalized, funId);
   d_applicationLookups.push_back(funNormalized);
   d_applicationLookupsCount = d_applicationLookupsCount + 1;
   Debug("equality::backtrack") << "d_applicationLookupsCount = " << d_applicationLookupsCount << std::endl;
@@ -204,6 +204,14 @@ public:
     IntStat functionTermsCount;
     /** Number of constant terms managed by the system */
     IntStat constantTermsCount;
+    /** Number of explanations requested from outside */
+    IntStat explanationsCount;
+    /** Number of (sub)explanations answered from the explanation cache */
+    IntStat explanationCacheHits;
+    /** Average number of assertions in an explanation */
+    AverageStat explanationLength;
+    /** Time spent constructing explanations */
+    TimerStat explanationTime;
 
     Statistics(std::string name);
 
@@ -236,14 +244,11 @@ private:
   /** Map from nodes to their ids */
   __gnu_cxx::hash_map<TNode, EqualityNodeId, TNodeHashFunction> d_nodeIds;
 
-  /** Map from function applications to their ids */
-  typedef __gnu_cxx::hash_map<FunctionApplication, EqualityNodeId, FunctionApplicationHashFunction> ApplicationIdsMap;
-
   /**
    * A map from a pair (a', b') to a function application f(a, b), where a' and b' are the current representatives
    * of a and b.
    */
-  ApplicationIdsMap d_applicationLookup;
+  ApplicationLookupTable d_applicationLookup;
 
   /** Application lookups in order, so that we can backtrack. */
   std::vector<FunctionApplication> d_applicationLookups;
@@ -477,8 +482,8 @@ private:
    */
   void addTriggerToList(EqualityNodeId nodeId, TriggerId triggerId);
 
-  /** Statistics */
-  Statistics d_stats;
+  /** Statistics (mutable, as the explanation methods are const) */
+  mutable Statistics d_stats;
 
   /** Add a new function application node to the database, i.e APP t1 t2 */
   EqualityNodeId newApplicationNode(TNode original, EqualityNodeId t1, EqualityNodeId t2, FunctionApplicationType type);
@@ -505,6 +510,36 @@ private:
    */
   void getExplanation(EqualityEdgeId t1Id, EqualityNodeId t2Id, std::vector<TNode>& equalities, EqProof * eqp) const;
 
+  /**
+   * Does the actual work of getExplanation() by searching for a path from t1 to t2
+   * in the equality graph.
+   */
+  void getExplanationFromGraph(EqualityNodeId t1Id, EqualityNodeId t2Id, std::vector<TNode>& equalities, EqProof * eqp) const;
+
+  /**
+   * A cached explanation: the asserted equalities explaining a pair of nodes, and the
+   * number of asserted equalities in the graph when it was computed.
+   */
+  struct CachedExplanation {
+    std::vector<TNode> reasons;
+    DefaultSizeType assertedEqualities;
+  };/* struct EqualityEngine::CachedExplanation */
+
+  typedef __gnu_cxx::hash_map<EqualityPair, CachedExplanation, EqualityPairHashFunction> ExplanationCache;
+
+  /**
+   * Explanations computed without proofs, keyed by the ordered pair of node ids. An
+   * explanation only uses edges that were in the graph when it was computed, so it stays
+   * valid until one of these equalities is backtracked.
+   */
+  mutable ExplanationCache d_explanationCache;
+
+  /** The keys of the explanation cache in insertion order, so that we can backtrack */
+  mutable std::vector<EqualityPair> d_explanationCacheKeys;
+
+  /** Remove the cached explanations that depend on backtracked equalities */
+  void backtrackExplanationCache();
+
   /**
    * Print the equality graph.
    */
@@ -17,9 +17,11 @@
 
 #include "cvc4_private.h"
 
+#include <stdint.h>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 namespace CVC4 {
 namespace theory {
@@ -330,6 +332,144 @@ struct FunctionApplicationHashFunction {
   }
 };
 
+/**
+ * Lookup table from normalized function applications to the ids of the
+ * application nodes, used for detecting congruences. The arguments of an
+ * application are packed into a 64-bit signature and the entries are kept
+ * in a single open-addressing (linear probing) array, so the lookups done
+ * for each use-list entry during a merge don't chase any pointers. Erased
+ * entries are only marked as deleted; once they pile up (e.g. after
+ * backtracking) the table is rebuilt in bulk by compact().
+ */
+class ApplicationLookupTable {
+
+  enum SlotState {
+    SLOT_EMPTY,
+    SLOT_FULL,
+    SLOT_DELETED
+  };
+
+  struct Slot {
+    /** The arguments a and b of the application, packed */
+    uint64_t signature;
+    /** The application node */
+    EqualityNodeId id;
+    /** The FunctionApplicationType of the application */
+    unsigned char type;
+    /** One of SlotState */
+    unsigned char state;
+    Slot() : signature(0), id(null_id), type(0), state(SLOT_EMPTY) {}
+  };
+
+  /** The slots, the number of which is always a power of two */
+  std::vector<Slot> d_slots;
+
+  /** Number of full slots */
+  size_t d_size;
+
+  /** Number of deleted slots */
+  size_t d_deleted;
+
+  static uint64_t signature(const FunctionApplication& app) {
+    return (((uint64_t) app.a) << 32) | app.b;
+  }
+
+  static size_t hash(uint64_t signature, unsigned char type) {
+    // Finalizer of MurmurHash3, mixing in the type
+    uint64_t h = signature ^ (type * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return (size_t) h;
+  }
+
+  /** Returns the slot of the application, or the first empty slot on its probe sequence */
+  size_t findSlot(uint64_t sig, unsigned char type) const {
+    size_t mask = d_slots.size() - 1;
+    size_t i = hash(sig, type) & mask;
+    while (true) {
+      const Slot& slot = d_slots[i];
+      if (slot.state == SLOT_EMPTY) {
+        return i;
+      }
+      if (slot.state == SLOT_FULL && slot.signature == sig && slot.type == type) {
+        return i;
+      }
+      i = (i + 1) & mask;
+    }
+  }
+
+  /** Rebuild the table with the given number of slots, dropping the deleted slots */
+  void rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(d_slots);
+    d_slots.resize(capacity);
+    d_deleted = 0;
+    for (size_t i = 0; i < old.size(); ++ i) {
+      if (old[i].state == SLOT_FULL) {
+        d_slots[findSlot(old[i].signature, old[i].type)] = old[i];
+      }
+    }
+  }
+
+public:
+
+  ApplicationLookupTable(size_t capacity = 64)
+  : d_size(0), d_deleted(0)
+  {
+    size_t initial = 1;
+    while (initial < capacity) {
+      initial <<= 1;
+    }
+    d_slots.resize(initial);
+  }
+
+  /** Returns the id stored for the application, or null_id if none */
+  EqualityNodeId find(const FunctionApplication& app) const {
+    const Slot& slot = d_slots[findSlot(signature(app), app.type)];
+    return slot.state == SLOT_FULL ? slot.id : null_id;
+  }
+
+  /** Store the id for the application, which must not be in the table */
+  void insert(const FunctionApplication& app, EqualityNodeId id) {
+    Assert(find(app) == null_id);
+    // Keep the load (including deleted slots) under 3/4
+    if (4 * (d_size + d_deleted + 1) > 3 * d_slots.size()) {
+      rehash(2 * (d_size + 1) > d_slots.size() ? 2 * d_slots.size() : d_slots.size());
+    }
+    uint64_t sig = signature(app);
+    Slot& slot = d_slots[findSlot(sig, app.type)];
+    slot.signature = sig;
+    slot.id = id;
+    slot.type = app.type;
+    slot.state = SLOT_FULL;
+    ++ d_size;
+  }
+
+  /** Remove the application from the table */
+  void erase(const FunctionApplication& app) {
+    Slot& slot = d_slots[findSlot(signature(app), app.type)];
+    Assert(slot.state == SLOT_FULL);
+    slot.state = SLOT_DELETED;
+    -- d_size;
+    ++ d_deleted;
+  }
+
+  /** Rebuild the table if too many slots are marked as deleted */
+  void compact() {
+    if (4 * d_deleted > d_slots.size()) {
+      rehash(d_slots.size());
+    }
+  }
+
+  /** Number of applications in the table */
+  size_t size() const {
+    return d_size;
+  }
+};/* class ApplicationLookupTable */
+
 /**
  * At time of addition a function application can already normalize to something, so
  * we keep both the original, and the normalized version.
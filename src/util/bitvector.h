@@ -20,7 +20,9 @@
 #ifndef __CVC4__BITVECTOR_H
 #define __CVC4__BITVECTOR_H
 
+#include <stdint.h>
 #include <iosfwd>
+#include <string>
 
 #include "base/exception.h"
 #include "util/integer.h"
@@ -30,58 +32,95 @@ namespace CVC4 {
 class CVC4_PUBLIC BitVector {
 public:
 
-  BitVector(unsigned size, const Integer& val):
-    d_size(size),
-    d_value(val.modByPow2(size))
-      {}
+  BitVector(unsigned size, const Integer& val)
+    : d_size(size),
+      d_value(size > s_smallWidth ? val.modByPow2(size) : Integer()),
+      d_small(0) {
+    if(isSmall()) {
+      d_small = toUint64(val.modByPow2(size));
+    }
+  }
 
   BitVector(unsigned size = 0)
-    : d_size(size), d_value(0) {}
+    : d_size(size), d_small(0) {}
 
   BitVector(unsigned size, unsigned int z)
-    : d_size(size), d_value(z) {
-    d_value = d_value.modByPow2(size);
+    : d_size(size), d_small(0) {
+    if(isSmall()) {
+      d_small = z & mask(size);
+    } else {
+      d_value = Integer(z).modByPow2(size);
+    }
   }
 
   BitVector(unsigned size, unsigned long int z)
-    : d_size(size), d_value(z) {
-    d_value = d_value.modByPow2(size);
+    : d_size(size), d_small(0) {
+    if(isSmall()) {
+      d_small = z & mask(size);
+    } else {
+      d_value = Integer(z).modByPow2(size);
+    }
   }
 
   BitVector(unsigned size, const BitVector& q)
-    : d_size(size), d_value(q.d_value) {}
+    : d_size(size), d_small(0) {
+    if(isSmall() && q.isSmall()) {
+      d_small = q.d_small & mask(size);
+    } else {
+      setValue(q.toInteger().modByPow2(size));
+    }
+  }
 
   BitVector(const std::string& num, unsigned base = 2);
 
+  BitVector(const BitVector& x)
+    : d_size(x.d_size), d_small(x.d_small) {
+    if(!x.isSmall()) {
+      d_value = x.d_value;
+    }
+  }
+
   ~BitVector() {}
 
   Integer toInteger() const {
-    return d_value;
+    return isSmall() ? fromUint64(d_small) : d_value;
   }
 
   BitVector& operator =(const BitVector& x) {
     if(this == &x)
       return *this;
     d_size = x.d_size;
-    d_value = x.d_value;
+    d_small = x.d_small;
+    if(!x.isSmall()) {
+      d_value = x.d_value;
+    }
     return *this;
   }
 
   bool operator ==(const BitVector& y) const {
     if (d_size != y.d_size) return false;
-    return d_value == y.d_value;
+    return isSmall() ? d_small == y.d_small : d_value == y.d_value;
   }
 
   bool operator !=(const BitVector& y) const {
-    if (d_size != y.d_size) return true;
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   BitVector concat (const BitVector& other) const {
-    return BitVector(d_size + other.d_size, (d_value.multiplyByPow2(other.d_size)) + other.d_value);
+    unsigned size = d_size + other.d_size;
+    if(size <= s_smallWidth) {
+      return mkSmall(size, shiftLeft(d_small, other.d_size) | other.d_small);
+    }
+    if(!isSmall() && !other.isSmall()) {
+      return BitVector(size, (d_value.multiplyByPow2(other.d_size)) + other.d_value);
+    }
+    return BitVector(size, (toInteger().multiplyByPow2(other.d_size)) + other.toInteger());
   }
 
   BitVector extract(unsigned high, unsigned low) const {
+    if(isSmall()) {
+      return mkSmall(high - low + 1, shiftRight(d_small, low));
+    }
     return BitVector(high - low + 1, d_value.extractBitRange(high - low + 1, low));
   }
 
@@ -92,23 +131,35 @@ public:
   // xor
   BitVector operator ^(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small ^ y.d_small);
+    }
     return BitVector(d_size, d_value.bitwiseXor(y.d_value));
   }
 
   // or
   BitVector operator |(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small | y.d_small);
+    }
     return BitVector(d_size, d_value.bitwiseOr(y.d_value));
   }
 
   // and
   BitVector operator &(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small & y.d_small);
+    }
     return BitVector(d_size, d_value.bitwiseAnd(y.d_value));
   }
 
   // not
   BitVector operator ~() const {
+    if(isSmall()) {
+      return mkSmall(d_size, ~d_small);
+    }
     return BitVector(d_size, d_value.bitwiseNot());
   }
 
@@ -118,30 +169,39 @@ public:
 
 
   bool operator <(const BitVector& y) const {
-    return d_value < y.d_value;
+    if(isSmall() && y.isSmall()) {
+      return d_small < y.d_small;
+    }
+    return toInteger() < y.toInteger();
   }
 
   bool operator >(const BitVector& y) const {
-    return d_value > y.d_value ;
+    return y < *this;
   }
 
   bool operator <=(const BitVector& y) const {
-    return d_value <= y.d_value;
+    return !(y < *this);
   }
 
   bool operator >=(const BitVector& y) const {
-    return d_value >= y.d_value ;
+    return !(*this < y);
   }
 
 
   BitVector operator +(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small + y.d_small);
+    }
     Integer sum = d_value +  y.d_value;
     return BitVector(d_size, sum);
   }
 
   BitVector operator -(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small - y.d_small);
+    }
     // to maintain the invariant that we are only adding BitVectors of the
     // same size
     BitVector one(d_size, Integer(1));
@@ -149,24 +209,36 @@ public:
   }
 
   BitVector operator -() const {
+    if(isSmall()) {
+      return mkSmall(d_size, 0 - d_small);
+    }
     BitVector one(d_size, Integer(1));
     return ~(*this) + one;
   }
 
   BitVector operator *(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small * y.d_small);
+    }
     Integer prod = d_value * y.d_value;
     return BitVector(d_size, prod);
   }
 
   BitVector setBit(uint32_t i) const {
     CheckArgument(i < d_size, i);
+    if(isSmall()) {
+      return mkSmall(d_size, d_small | (uint64_t(1) << i));
+    }
     Integer res = d_value.setBit(i);
     return BitVector(d_size, res);
   }
 
   bool isBitSet(uint32_t i) const {
     CheckArgument(i < d_size, i);
+    if(isSmall()) {
+      return (d_small >> i) & 1;
+    }
     return d_value.isBitSet(i);
   }
 
@@ -176,6 +248,10 @@ public:
   BitVector unsignedDivTotal (const BitVector& y) const {
 
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      // under division by zero return -1
+      return mkSmall(d_size, y.d_small == 0 ? ~uint64_t(0) : d_small / y.d_small);
+    }
     if (y.d_value == 0) {
       // under division by zero return -1
       return BitVector(d_size, Integer(1).oneExtend(1, d_size - 1));
@@ -190,6 +266,9 @@ public:
    */
   BitVector unsignedRemTotal(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return mkSmall(d_size, y.d_small == 0 ? d_small : d_small % y.d_small);
+    }
     if (y.d_value == 0) {
       return BitVector(d_size, d_value);
     }
@@ -201,6 +280,9 @@ public:
 
   bool signedLessThan(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return toInt64(d_small, d_size) < toInt64(y.d_small, d_size);
+    }
     CheckArgument(d_value >= 0, this);
     CheckArgument(y.d_value >= 0, y);
     Integer a = (*this).toSignedInt();
@@ -211,6 +293,9 @@ public:
 
   bool unsignedLessThan(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return d_small < y.d_small;
+    }
     CheckArgument(d_value >= 0, this);
     CheckArgument(y.d_value >= 0, y);
     return d_value < y.d_value;
@@ -218,6 +303,9 @@ public:
 
   bool signedLessThanEq(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, y);
+    if(isSmall()) {
+      return toInt64(d_small, d_size) <= toInt64(y.d_small, d_size);
+    }
     CheckArgument(d_value >= 0, this);
     CheckArgument(y.d_value >= 0, y);
     Integer a = (*this).toSignedInt();
@@ -228,6 +316,9 @@ public:
 
   bool unsignedLessThanEq(const BitVector& y) const {
     CheckArgument(d_size == y.d_size, this);
+    if(isSmall()) {
+      return d_small <= y.d_small;
+    }
     CheckArgument(d_value >= 0, this);
     CheckArgument(y.d_value >= 0, y);
     return d_value <= y.d_value;
@@ -238,15 +329,22 @@ public:
     Extend operations
    */
   BitVector zeroExtend(unsigned amount) const {
-    return BitVector(d_size + amount, d_value);
+    if(d_size + amount <= s_smallWidth) {
+      return mkSmall(d_size + amount, d_small);
+    }
+    return BitVector(d_size + amount, toInteger());
   }
 
   BitVector signExtend(unsigned amount) const {
-    Integer sign_bit = d_value.extractBitRange(1, d_size -1);
-    if(sign_bit == Integer(0)) {
-      return BitVector(d_size + amount, d_value);
+    bool sign_bit = d_size > 0 && isBitSet(d_size - 1);
+    if(d_size + amount <= s_smallWidth) {
+      uint64_t ones = sign_bit ? ~mask(d_size) : 0;
+      return mkSmall(d_size + amount, d_small | ones);
+    }
+    if(!sign_bit) {
+      return BitVector(d_size + amount, toInteger());
     } else {
-      Integer val = d_value.oneExtend(d_size, amount);
+      Integer val = toInteger().oneExtend(d_size, amount);
       return BitVector(d_size+ amount, val);
     }
   }
@@ -255,53 +353,47 @@ public:
     Shifts on BitVectors
    */
   BitVector leftShift(const BitVector& y) const {
-    if (y.d_value > Integer(d_size)) {
-      return BitVector(d_size, Integer(0));
+    unsigned amount = getShiftAmount(y);
+    if(isSmall()) {
+      return mkSmall(d_size, shiftLeft(d_small, amount));
     }
-    if (y.d_value == 0) {
-      return *this;
+    if (amount == d_size) {
+      return BitVector(d_size, Integer(0));
     }
-
-    // making sure we don't lose information casting
-    CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
-    uint32_t amount = y.d_value.toUnsignedInt();
     Integer res = d_value.multiplyByPow2(amount);
     return BitVector(d_size, res);
   }
 
   BitVector logicalRightShift(const BitVector& y) const {
-    if(y.d_value > Integer(d_size)) {
+    unsigned amount = getShiftAmount(y);
+    if(isSmall()) {
+      return mkSmall(d_size, shiftRight(d_small, amount));
+    }
+    if(amount == d_size) {
       return BitVector(d_size, Integer(0));
     }
-
-    // making sure we don't lose information casting
-    CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
-    uint32_t amount = y.d_value.toUnsignedInt();
     Integer res = d_value.divByPow2(amount);
     return BitVector(d_size, res);
   }
 
   BitVector arithRightShift(const BitVector& y) const {
-    Integer sign_bit = d_value.extractBitRange(1, d_size - 1);
-    if(y.d_value > Integer(d_size)) {
-      if(sign_bit == Integer(0)) {
+    unsigned amount = getShiftAmount(y);
+    bool sign_bit = d_size > 0 && isBitSet(d_size - 1);
+    if(isSmall()) {
+      uint64_t ones = sign_bit ? ~shiftRight(mask(d_size), amount) : 0;
+      return mkSmall(d_size, shiftRight(d_small, amount) | ones);
+    }
+    if(amount == d_size) {
+      if(!sign_bit) {
         return BitVector(d_size, Integer(0));
       } else {
-        return BitVector(d_size, Integer(d_size).multiplyByPow2(d_size) -1 );
+        return BitVector(d_size, Integer(1).oneExtend(1, d_size - 1));
       }
     }
 
-    if (y.d_value == 0) {
-      return *this;
-    }
-
-    // making sure we don't lose information casting
-    CheckArgument(y.d_value < Integer(1).multiplyByPow2(32), y);
-
-    uint32_t amount  = y.d_value.toUnsignedInt();
     Integer rest = d_value.divByPow2(amount);
 
-    if(sign_bit == Integer(0)) {
+    if(!sign_bit) {
       return BitVector(d_size, rest);
     }
     Integer res = rest.oneExtend(d_size - amount, amount);
@@ -314,11 +406,14 @@ public:
    */
 
   size_t hash() const {
+    if(isSmall()) {
+      return size_t(d_small ^ (d_small >> 32)) + d_size;
+    }
     return d_value.hash() + d_size;
   }
 
   std::string toString(unsigned int base = 2) const {
-    std::string str = d_value.toString(base);
+    std::string str = isSmall() ? smallToString(d_small, base) : d_value.toString(base);
     if( base == 2 && d_size > str.size() ) {
       std::string zeroes;
       for( unsigned int i=0; i < d_size - str.size(); ++i ) {
@@ -334,17 +429,17 @@ public:
     return d_size;
   }
 
-  const Integer& getValue() const {
-    return d_value;
+  Integer getValue() const {
+    return toInteger();
   }
 
   Integer toSignedInt() const {
     // returns Integer corresponding to two's complement interpretation of bv
-    unsigned size = d_size;
-    Integer sign_bit = d_value.extractBitRange(1,size-1);
-    Integer val = d_value.extractBitRange(size-1, 0);
-    Integer res = Integer(-1) * sign_bit.multiplyByPow2(size - 1) + val;
-    return res;
+    Integer val = toInteger();
+    if(d_size > 0 && isBitSet(d_size - 1)) {
+      val = val - Integer(1).multiplyByPow2(d_size);
+    }
+    return val;
   }
 
   /**
@@ -353,23 +448,115 @@ public:
    @return k if the integer is equal to 2^{k-1} and zero otherwise
    */
   unsigned isPow2() {
+    if(isSmall()) {
+      if(d_small == 0 || (d_small & (d_small - 1)) != 0) {
+        return 0;
+      }
+      unsigned k = 1;
+      for(uint64_t v = d_small; v != 1; v >>= 1) {
+        ++k;
+      }
+      return k;
+    }
     return d_value.isPow2();
   }
 
 private:
+  /** Bit-vectors up to this width are stored in d_small */
+  static const unsigned s_smallWidth = 64;
+
+  bool isSmall() const {
+    return d_size <= s_smallWidth;
+  }
+
+  static uint64_t mask(unsigned size) {
+    return size >= 64 ? ~uint64_t(0) : (uint64_t(1) << size) - 1;
+  }
+
+  static uint64_t shiftLeft(uint64_t v, unsigned amount) {
+    return amount >= 64 ? 0 : v << amount;
+  }
+
+  static uint64_t shiftRight(uint64_t v, unsigned amount) {
+    return amount >= 64 ? 0 : v >> amount;
+  }
+
+  /** The two's complement value of the low size bits of v */
+  static int64_t toInt64(uint64_t v, unsigned size) {
+    if(size > 0 && size < 64 && ((v >> (size - 1)) & 1)) {
+      v |= ~mask(size);
+    }
+    return int64_t(v);
+  }
+
+  static Integer fromUint64(uint64_t v) {
+    if(sizeof(unsigned long) >= sizeof(uint64_t)) {
+      return Integer((unsigned long)v);
+    }
+    return Integer((unsigned long)(v >> 32)).multiplyByPow2(32) +
+           Integer((unsigned long)(v & 0xffffffff));
+  }
+
+  static uint64_t toUint64(const Integer& val) {
+    if(sizeof(unsigned long) >= sizeof(uint64_t)) {
+      return val.getUnsignedLong();
+    }
+    return (uint64_t(val.divByPow2(32).getUnsignedLong()) << 32) |
+           val.extractBitRange(32, 0).getUnsignedLong();
+  }
+
+  static std::string smallToString(uint64_t v, unsigned base) {
+    if(v == 0) {
+      return "0";
+    }
+    std::string str;
+    for(; v != 0; v /= base) {
+      str.push_back("0123456789abcdefghijklmnopqrstuvwxyz"[v % base]);
+    }
+    return std::string(str.rbegin(), str.rend());
+  }
+
+  /** Makes a bit-vector of width size <= 64 from the low bits of v */
+  static BitVector mkSmall(unsigned size, uint64_t v) {
+    BitVector res(size);
+    res.d_small = v & mask(size);
+    return res;
+  }
+
+  /** Sets the value, which must be in [0, 2^d_size) */
+  void setValue(const Integer& val) {
+    if(isSmall()) {
+      d_small = toUint64(val);
+    } else {
+      d_value = val;
+    }
+  }
+
+  /** The shift amount given by y, at most d_size */
+  unsigned getShiftAmount(const BitVector& y) const {
+    if(y.isSmall()) {
+      return y.d_small < d_size ? unsigned(y.d_small) : d_size;
+    }
+    return y.d_value < Integer(d_size) ? y.d_value.toUnsignedInt() : d_size;
+  }
+
   /*
     Class invariants:
     * no overflows: 2^d_size < d_value
     * no negative numbers: d_value >= 0
+    * bit-vectors of width at most 64 keep their value in d_small and
+      leave d_value unused, wider ones keep it in d_value
    */
   unsigned d_size;
   Integer d_value;
+  uint64_t d_small;
 
 };/* class BitVector */
 
 
 
-inline BitVector::BitVector(const std::string& num, unsigned base) {
+inline BitVector::BitVector(const std::string& num, unsigned base)
+  : d_small(0) {
   CheckArgument(base == 2 || base == 16, base);
 
   if( base == 2 ) {
@@ -378,7 +565,7 @@ inline BitVector::BitVector(const std::string& num, unsigned base) {
     d_size = num.size() * 4;
   }
 
-  d_value = Integer(num, base);
+  setValue(Integer(num, base));
 }/* BitVector::BitVector() */
 
 
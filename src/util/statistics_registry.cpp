@@ -139,6 +139,9 @@ std::ostream& operator<<(std::ostream& os, const timespec& t) {
 }
 
 
+/** Set by a signal handler to request that the statistics be flushed */
+volatile sig_atomic_t StatisticsRegistry::s_flushRequested = 0;
+
 /** Construct a statistics registry */
 StatisticsRegistry::StatisticsRegistry(const std::string& name)
   throw(CVC4::IllegalArgumentException) :
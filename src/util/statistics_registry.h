@@ -39,6 +39,7 @@
 #include <stdint.h>
 
 #include <cassert>
+#include <csignal>
 #include <ctime>
 #include <iomanip>
 #include <map>
@@ -660,6 +661,29 @@ public:
   /** Unregister a new statistic */
   void unregisterStat(Stat* s) throw(CVC4::IllegalArgumentException);
 
+  /**
+   * Request that the statistics be flushed the next time the solver
+   * polls for it with flushRequested().  This is safe to call from a
+   * signal handler.
+   */
+  static void requestFlush() {
+    s_flushRequested = 1;
+  }
+
+  /** Returns true (once) if a flush was requested since the last call. */
+  static bool flushRequested() {
+    if(s_flushRequested) {
+      s_flushRequested = 0;
+      return true;
+    }
+    return false;
+  }
+
+private:
+
+  /** Whether a flush was requested */
+  static volatile sig_atomic_t s_flushRequested;
+
 };/* class StatisticsRegistry */
 
 class CodeTimer;
@@ -0,0 +1,22 @@
+; COMMAND-LINE: --tc-model-based --incremental --check-models
+; EXPECT: sat
+; EXPECT: sat
+; EXPECT: unsat
+; the care pairs of the array indices are asked for by the array theory
+(set-logic QF_AUFLIA)
+(declare-fun A () (Array Int Int))
+(declare-fun i () Int)
+(declare-fun j () Int)
+(assert (= (select (store A i 1) j) 2))
+(push 1)
+(assert (< i j))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= (select A i) 1))
+(assert (= (select A j) 2))
+(check-sat)
+(pop 1)
+(assert (<= i j))
+(assert (>= i j))
+(check-sat)
@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bv-cegar --bv-cegar-width=8
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (= (bvmul x y) #x0f))
+(assert (bvugt x #x01))
+(assert (bvugt y x))
+(assert (= (bvurem x y) x))
+(assert (= (bvudiv y x) #x01))
+(check-sat)
@@ -0,0 +1,9 @@
+; COMMAND-LINE: --bv-cegar --bv-cegar-width=8
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(declare-fun z () (_ BitVec 8))
+(assert (= (bvmul x x) #x02))
+(assert (or (= (bvudiv y z) #x03) (= (bvurem y z) #x05)))
+(check-sat)
@@ -0,0 +1,14 @@
+; COMMAND-LINE: --bitblast=eager --bv-eager-cones=3
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun a () (_ BitVec 8))
+(declare-fun b () (_ BitVec 8))
+(declare-fun c () (_ BitVec 16))
+(declare-fun d () (_ BitVec 16))
+(declare-fun e () (_ BitVec 4))
+(assert (= (bvmul a b) #x0f))
+(assert (bvult a b))
+(assert (= (bvadd c d) #x1234))
+(assert (= (bvmul e #x2) #x3))
+(assert (= ((_ extract 7 0) c) #x34))
+(check-sat)
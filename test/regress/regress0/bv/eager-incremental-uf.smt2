@@ -0,0 +1,26 @@
+; COMMAND-LINE: --incremental --bitblast=eager --no-check-models
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; the same applications of f are asserted again after being popped; eager
+; bit-blasting replaces them by skolems, so f has no model to check
+(set-logic QF_UFBV)
+(declare-fun f ((_ BitVec 8)) (_ BitVec 8))
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(push 1)
+(assert (= (f x) #x01))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= (f x) #x01))
+(assert (= x y))
+(assert (not (= (f y) #x01)))
+(check-sat)
+(pop 1)
+(assert (= (f y) #x02))
+(check-sat)
+(assert (= x y))
+(assert (= (f x) #x01))
+(check-sat)
@@ -0,0 +1,28 @@
+; COMMAND-LINE: --incremental --bitblast=eager
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (bvult x y))
+(check-sat)
+(push 1)
+(assert (= y #x00))
+(check-sat)
+(pop 1)
+(check-sat)
+(push 1)
+(assert (= (bvadd x #x01) y))
+(assert (= (bvmul y #x02) #x01))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= (bvmul x #x03) #x2b))
+(check-sat)
+(pop 1)
+(assert (= x #xff))
+(check-sat)
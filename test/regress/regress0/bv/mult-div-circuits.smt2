@@ -0,0 +1,7 @@
+; COMMAND-LINE: --bv-multiplier=dadda --bv-divider=non-restoring --bv-div-zero-const
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (not (= x (bvadd (bvmul (bvudiv x y) y) (bvurem x y)))))
+(check-sat)
@@ -0,0 +1,20 @@
+; COMMAND-LINE: --bv-multiplier=karatsuba --bv-karatsuba-threshold=4 --bv-mult-const-csd
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(declare-fun z () (_ BitVec 12))
+; the Karatsuba product of free operands against a shift-add sum over the bits of y,
+; and the signed-digit product by #x0f7 = 2^8 - 2^3 - 1 against shifts,
+; neither of which the rewriter can relate to bvmul
+(assert (or (not (= (bvmul x y)
+  (bvadd (bvadd (bvadd (bvadd (bvadd (bvadd (bvadd (ite (= ((_ extract 0 0) y) #b1) x (_ bv0 8))
+    (ite (= ((_ extract 1 1) y) #b1) (bvshl x (_ bv1 8)) (_ bv0 8)))
+    (ite (= ((_ extract 2 2) y) #b1) (bvshl x (_ bv2 8)) (_ bv0 8)))
+    (ite (= ((_ extract 3 3) y) #b1) (bvshl x (_ bv3 8)) (_ bv0 8)))
+    (ite (= ((_ extract 4 4) y) #b1) (bvshl x (_ bv4 8)) (_ bv0 8)))
+    (ite (= ((_ extract 5 5) y) #b1) (bvshl x (_ bv5 8)) (_ bv0 8)))
+    (ite (= ((_ extract 6 6) y) #b1) (bvshl x (_ bv6 8)) (_ bv0 8)))
+    (ite (= ((_ extract 7 7) y) #b1) (bvshl x (_ bv7 8)) (_ bv0 8)))))
+            (not (= (bvmul z #x0f7) (bvsub (bvsub (bvshl z #x008) (bvshl z #x003)) z)))))
+(check-sat)
@@ -0,0 +1,15 @@
+; COMMAND-LINE: --bitblast-native-aig
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 6))
+(declare-fun y () (_ BitVec 6))
+; the product of free operands against a shift-add sum over the bits of y,
+; which the rewriter cannot relate to bvmul
+(assert (not (= (bvmul x y)
+  (bvadd (bvadd (bvadd (bvadd (bvadd (ite (= ((_ extract 0 0) y) #b1) x (_ bv0 6))
+    (ite (= ((_ extract 1 1) y) #b1) (bvshl x (_ bv1 6)) (_ bv0 6)))
+    (ite (= ((_ extract 2 2) y) #b1) (bvshl x (_ bv2 6)) (_ bv0 6)))
+    (ite (= ((_ extract 3 3) y) #b1) (bvshl x (_ bv3 6)) (_ bv0 6)))
+    (ite (= ((_ extract 4 4) y) #b1) (bvshl x (_ bv4 6)) (_ bv0 6)))
+    (ite (= ((_ extract 5 5) y) #b1) (bvshl x (_ bv5 6)) (_ bv0 6))))))
+(check-sat)
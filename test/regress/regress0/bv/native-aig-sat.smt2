@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bitblast-native-aig
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(declare-fun b () Bool)
+(assert (= (bvmul x y) #x8f))
+(assert (bvult x y))
+(assert (or b (= x #x01)))
+(assert (not (= x #x01)))
+(check-sat)
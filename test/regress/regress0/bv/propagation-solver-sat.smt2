@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bv-propagation-solver
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(declare-fun c () Bool)
+(assert (= (bvand x #xf0) #x30))
+(assert (bvult y x))
+(assert (= (concat #b0 ((_ extract 6 0) y)) (ite c (bvsub x #x01) (bvmul y #x02))))
+(assert (not (= y #x00)))
+(check-sat)
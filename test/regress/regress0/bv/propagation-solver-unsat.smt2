@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bv-propagation-solver
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 16))
+(declare-fun y () (_ BitVec 16))
+(declare-fun z () (_ BitVec 16))
+(assert (= ((_ extract 15 12) x) #xf))
+(assert (= y (bvor x #x00ff)))
+(assert (bvult z #x1000))
+(assert (or (= z y) (bvule y (bvadd z #x0100))))
+(check-sat)
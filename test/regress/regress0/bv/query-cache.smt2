@@ -0,0 +1,35 @@
+; COMMAND-LINE: --incremental --bv-query-cache=2
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(declare-fun y () (_ BitVec 8))
+(assert (bvult x y))
+(check-sat)
+(push 1)
+(assert (= (bvadd x #x01) y))
+(assert (= (bvmul y #x02) #x01))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= (bvmul #x02 y) #x01))
+(assert (= y (bvadd #x01 x)))
+(check-sat)
+(pop 1)
+(check-sat)
+(push 1)
+(assert (= x #x00))
+(check-sat)
+(assert (= y #x00))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= y #x00))
+(assert (= x #x00))
+(check-sat)
+(pop 1)
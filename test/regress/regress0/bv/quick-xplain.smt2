@@ -0,0 +1,26 @@
+; COMMAND-LINE: --incremental --bv-quick-xplain --bv-quick-xplain-budget=1000
+; EXPECT: unsat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun a () (_ BitVec 8))
+(declare-fun b () (_ BitVec 8))
+(declare-fun c () (_ BitVec 8))
+(declare-fun d () (_ BitVec 8))
+(declare-fun e () (_ BitVec 8))
+(assert (= (bvand c d) #x0f))
+(assert (bvult e #x80))
+(push 1)
+(assert (= (bvadd a b) #x10))
+(assert (= (bvmul a #x03) b))
+(assert (= ((_ extract 0 0) a) #b1))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (= (bvadd a b) #x10))
+(assert (= (bvmul a #x03) b))
+(assert (= ((_ extract 0 0) a) #b1))
+(check-sat)
+(pop 1)
+(assert (= (bvadd a b) #x10))
+(check-sat)
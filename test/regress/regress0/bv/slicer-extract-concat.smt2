@@ -0,0 +1,11 @@
+; COMMAND-LINE: --bv-eq-slicer=auto
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 64))
+(declare-fun y () (_ BitVec 64))
+(declare-fun z () (_ BitVec 64))
+(assert (= y (concat ((_ extract 39 0) x) ((_ extract 63 40) x))))
+(assert (= z (concat ((_ extract 23 0) y) ((_ extract 63 24) y))))
+(assert (= ((_ extract 47 16) x) #xdeadbeef))
+(assert (not (= ((_ extract 31 0) z) ((_ extract 31 0) x))))
+(check-sat)
@@ -0,0 +1,18 @@
+; COMMAND-LINE: --tc-model-based --incremental --check-models
+; EXPECT: sat
+; EXPECT: unsat
+; the care pairs of the integer fields are asked for by the datatypes theory
+(set-logic ALL_SUPPORTED)
+(declare-datatypes () ((L (nil) (cons (hd Int) (tl L)))))
+(declare-fun x () L)
+(declare-fun a () Int)
+(declare-fun b () Int)
+(assert (= x (cons a nil)))
+(assert (not (= x (cons b nil))))
+(push 1)
+(assert (<= a b))
+(check-sat)
+(pop 1)
+(assert (<= a b))
+(assert (>= a b))
+(check-sat)
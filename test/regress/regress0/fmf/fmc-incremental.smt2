@@ -0,0 +1,20 @@
+; COMMAND-LINE: --finite-model-find --fmf-fmc-incremental
+; EXPECT: sat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun g (U U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+
+; f and g settle before P does, so their definitions can be reused across rounds
+(assert (forall ((x U)) (= (f (f x)) x)))
+(assert (forall ((x U) (y U)) (= (g x y) (g y x))))
+(assert (forall ((x U)) (=> (P x) (not (P (f x))))))
+(assert (forall ((x U)) (or (P x) (P (f x)))))
+(assert (distinct a b c))
+(assert (not (= (f a) a)))
+(assert (P a))
+(check-sat)
@@ -0,0 +1,15 @@
+; COMMAND-LINE: --fmf-bound --fmf-eval-code --fmf-eval-chunk=16
+; EXPECT: sat
+(set-logic ALL)
+(declare-fun a (Int) Int)
+(declare-fun n () Int)
+(assert (and (<= 50 n) (<= n 100)))
+
+; a is sorted and non-negative on [0,n)
+(assert (forall ((i Int)) (=> (and (<= 0 i) (< i n)) (<= 0 (a i)))))
+(assert (forall ((i Int) (j Int))
+  (=> (and (<= 0 i) (< i n) (<= 0 j) (< j n)) (=> (< i j) (<= (a i) (a j))))))
+(assert (= (a 0) 3))
+(assert (> (a (- n 1)) 7))
+
+(check-sat)
@@ -0,0 +1,20 @@
+; COMMAND-LINE: --incremental
+; the term index of f built while a = b holds keeps only one of f(a), f(b),
+; it must not be reused after the pop, or the instance x = b is missed
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun R (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(assert (forall ((x U)) (! (=> (R x) (P (f x))) :pattern ((f x)))))
+(assert (not (P (f b))))
+(push 1)
+(assert (= a b))
+; EXPECT: unknown
+(check-sat)
+(pop 1)
+(assert (R b))
+; EXPECT: unsat
+(check-sat)
@@ -0,0 +1,31 @@
+; COMMAND-LINE: --ematch-code-tree --no-quant-cf
+; EXPECT: unsat
+; Whichever of a = b and a = c is tried first makes f(g(b)) or f(g(c))
+; congruent to f(g(a)), so the trigger of the second formula skips it, and
+; the branch fails with the instance for the other term.  After the SAT
+; context is popped, the skipped term is needed, and the trigger must be
+; matched again even though the trigger of the first formula has been
+; executed since then.
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun g (U) U)
+(declare-fun h (U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun R (U) Bool)
+(declare-fun S (U) Bool)
+(declare-fun T (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(assert (T (f (g a))))
+(assert (T (h (g a))))
+(assert (forall ((x U)) (! (=> (S x) (Q (h (g x)))) :pattern ((h (g x))))))
+(assert (forall ((x U)) (! (=> (R x) (P (f (g x)))) :pattern ((f (g x))))))
+(assert (R b))
+(assert (R c))
+(assert (or (= a b) (= a c)))
+(assert (=> (= a b) (not (P (f (g c))))))
+(assert (=> (= a c) (not (P (f (g b))))))
+(check-sat)
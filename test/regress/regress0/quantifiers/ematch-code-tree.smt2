@@ -0,0 +1,19 @@
+; COMMAND-LINE: --ematch-code-tree
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun g (U) U)
+(declare-fun h (U U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+; the first two triggers share the code matching (f (g x))
+(assert (forall ((x U)) (! (= (f (g x)) x) :pattern ((f (g x))))))
+(assert (forall ((y U)) (! (P (f (g y))) :pattern ((f (g y))))))
+(assert (forall ((x U) (y U)) (! (= (h (g x) (g y)) (h (g y) (g x))) :pattern ((h (g x) (g y))))))
+(assert (= b (g a)))
+(assert (= c (h b (g c))))
+(assert (or (not (P a)) (not (= (f b) a))))
+(check-sat)
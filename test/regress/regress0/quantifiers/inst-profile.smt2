@@ -0,0 +1,23 @@
+; COMMAND-LINE: --inst-profile --no-quant-cf
+; SCRUBBER: grep -o -E '^(sat|unsat|unknown)$|\(:(instantiations|duplicates|throttled|max-generation) [0-9]+\)'
+; EXPECT: unsat
+; EXPECT: (:instantiations 2)
+; EXPECT: (:duplicates 0)
+; EXPECT: (:throttled 0)
+; EXPECT: (:max-generation 2)
+; EXPECT: (:instantiations 2)
+; the profile of the quantified formula, then of its trigger, which
+; matches f(a) and f(b) in the first round; x is instantiated by the
+; representative of its class, and f(b), equal to a, was given generation
+; 1 by the instance for b
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(assert (forall ((x U)) (! (P (f x)) :pattern ((f x)))))
+(assert (= (f b) a))
+(assert (not (P (f a))))
+(check-sat)
+(get-info :all-statistics)
@@ -0,0 +1,16 @@
+; COMMAND-LINE: --inst-round-batch
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun g (U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+; the instantiations of both quantified formulas are needed, and are added in one batch
+(assert (forall ((x U)) (! (=> (P x) (Q (f x))) :pattern ((f x)))))
+(assert (forall ((y U)) (! (=> (Q y) (= (g y) b)) :pattern ((g y)))))
+(assert (P a))
+(assert (not (= (g (f a)) b)))
+(check-sat)
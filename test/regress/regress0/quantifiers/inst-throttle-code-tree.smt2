@@ -0,0 +1,15 @@
+; COMMAND-LINE: --inst-throttle --inst-throttle-lemmas=1 --ematch-code-tree --no-quant-cf
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+; all three matches are found in the first round, but only one instance
+; per round is within the budget, and no new terms are created, so the
+; throttled matches must be found again by the code tree in later rounds
+(assert (forall ((x U)) (! (P (f x)) :pattern ((f x)))))
+(assert (or (not (P (f a))) (not (P (f b))) (not (P (f c)))))
+(check-sat)
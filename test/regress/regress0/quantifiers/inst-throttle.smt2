@@ -0,0 +1,15 @@
+; COMMAND-LINE: --inst-throttle --inst-throttle-lemmas=5
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun g (U) U)
+(declare-fun P (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+; a matching loop, whose instantiations of high generation are throttled
+(assert (forall ((x U)) (! (= (f x) (g (f (f x)))) :pattern ((f x)))))
+(assert (forall ((x U)) (! (P (g x)) :pattern ((g x)))))
+(assert (= b (f a)))
+(assert (not (P (g a))))
+(check-sat)
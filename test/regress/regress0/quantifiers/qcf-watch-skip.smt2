@@ -0,0 +1,23 @@
+; COMMAND-LINE: --qcf-watch --no-e-matching
+; SCRUBBER: grep -o -E '^(sat|unsat|unknown)$|"QuantConflictFind::Watch_Skipped" [0-9]+' | sed -e 's/ [1-9][0-9]*$/ N/'
+; EXPECT: unsat
+; EXPECT: "QuantConflictFind::Watch_Skipped" N
+; without E-matching, the instances of the second formula are found by
+; conflict find, one propagating instance per round, while the watched
+; terms of the first formula do not change after its first check, so it
+; is skipped in the later rounds
+(set-logic UF)
+(declare-sort U 0)
+(declare-sort V 0)
+(declare-fun f (U) U)
+(declare-fun g (U) U)
+(declare-fun a () U)
+(declare-fun Q (V) Bool)
+(declare-fun R (V) Bool)
+(declare-fun b () V)
+(assert (forall ((y V)) (or (Q y) (R y))))
+(assert (forall ((x U)) (= (f x) (g x))))
+(assert (not (= (f (f (f (f a)))) (g (g (g (g a)))))))
+(assert (Q b))
+(check-sat)
+(get-info :all-statistics)
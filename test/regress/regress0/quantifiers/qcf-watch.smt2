@@ -0,0 +1,19 @@
+; COMMAND-LINE: --qcf-watch
+; EXPECT: unsat
+(set-logic UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun P (U) Bool)
+(declare-fun Q (U) Bool)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+; each branch of the disjunction is refuted by a conflicting instance,
+; while the second formula is not affected by the merges of either branch
+(assert (forall ((x U)) (=> (P x) (= (f x) a))))
+(assert (forall ((x U) (y U)) (=> (and (Q x) (Q y)) (= x y))))
+(assert (Q b))
+(assert (or (P b) (P c)))
+(assert (not (= (f b) a)))
+(assert (not (= (f c) a)))
+(check-sat)
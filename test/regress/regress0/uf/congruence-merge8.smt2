@@ -0,0 +1,49 @@
+(set-logic QF_UF)
+(set-info :status unsat)
+(declare-sort U 0)
+(declare-fun f (U U) U)
+(declare-fun x_1 () U)
+(declare-fun x_2 () U)
+(declare-fun x_3 () U)
+(declare-fun x_4 () U)
+(declare-fun x_5 () U)
+(declare-fun x_6 () U)
+(declare-fun x_7 () U)
+(declare-fun x_8 () U)
+(assert (= (f x_1 x_2) (f (f x_2 x_1) x_1)))
+(assert (= (f x_1 x_3) (f (f x_3 x_1) x_1)))
+(assert (= (f x_1 x_4) (f (f x_4 x_1) x_1)))
+(assert (= (f x_1 x_5) (f (f x_5 x_1) x_1)))
+(assert (= (f x_1 x_6) (f (f x_6 x_1) x_1)))
+(assert (= (f x_1 x_7) (f (f x_7 x_1) x_1)))
+(assert (= (f x_1 x_8) (f (f x_8 x_1) x_1)))
+(assert (= (f x_2 x_3) (f (f x_3 x_2) x_2)))
+(assert (= (f x_2 x_4) (f (f x_4 x_2) x_2)))
+(assert (= (f x_2 x_5) (f (f x_5 x_2) x_2)))
+(assert (= (f x_2 x_6) (f (f x_6 x_2) x_2)))
+(assert (= (f x_2 x_7) (f (f x_7 x_2) x_2)))
+(assert (= (f x_2 x_8) (f (f x_8 x_2) x_2)))
+(assert (= (f x_3 x_4) (f (f x_4 x_3) x_3)))
+(assert (= (f x_3 x_5) (f (f x_5 x_3) x_3)))
+(assert (= (f x_3 x_6) (f (f x_6 x_3) x_3)))
+(assert (= (f x_3 x_7) (f (f x_7 x_3) x_3)))
+(assert (= (f x_3 x_8) (f (f x_8 x_3) x_3)))
+(assert (= (f x_4 x_5) (f (f x_5 x_4) x_4)))
+(assert (= (f x_4 x_6) (f (f x_6 x_4) x_4)))
+(assert (= (f x_4 x_7) (f (f x_7 x_4) x_4)))
+(assert (= (f x_4 x_8) (f (f x_8 x_4) x_4)))
+(assert (= (f x_5 x_6) (f (f x_6 x_5) x_5)))
+(assert (= (f x_5 x_7) (f (f x_7 x_5) x_5)))
+(assert (= (f x_5 x_8) (f (f x_8 x_5) x_5)))
+(assert (= (f x_6 x_7) (f (f x_7 x_6) x_6)))
+(assert (= (f x_6 x_8) (f (f x_8 x_6) x_6)))
+(assert (= (f x_7 x_8) (f (f x_8 x_7) x_7)))
+(assert (= x_1 x_2))
+(assert (= x_2 x_3))
+(assert (= x_3 x_4))
+(assert (= x_4 x_5))
+(assert (= x_5 x_6))
+(assert (= x_6 x_7))
+(assert (= x_7 x_8))
+(assert (not (= (f x_1 x_8) (f x_8 x_1))))
+(check-sat)
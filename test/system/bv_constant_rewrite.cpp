@@ -0,0 +1,135 @@
+/*********************                                                        */
+/*! \file bv_constant_rewrite.cpp
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Microbenchmark for rewriting constant bit-vector terms.
+ **
+ ** Builds terms over bit-vector constants of several widths, simplifies
+ ** them, and checks that each one folds to the value computed
+ ** independently on CVC4::Integer modulo 2^width.  The time spent per width is printed, so the
+ ** test doubles as a microbenchmark of constant folding; pass a number of
+ ** rounds on the command line to make it run longer.
+ **/
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "expr/expr.h"
+#include "smt/smt_engine.h"
+#include "util/bitvector.h"
+#include "util/integer.h"
+
+using namespace CVC4;
+using namespace std;
+
+namespace {
+
+unsigned long s_seed = 1;
+
+unsigned long nextRandom() {
+  s_seed = s_seed * 1103515245ul + 12345ul;
+  return s_seed >> 16;
+}
+
+/** Returns v modulo 2^width, as a non-negative integer. */
+Integer truncate(const Integer& v, unsigned width) {
+  Integer m = Integer(1).multiplyByPow2(width);
+  return v.floorDivideRemainder(m);
+}
+
+/**
+ * Builds a chain of depth operations over random constants of the given
+ * width, and sets expected to its value, computed without BitVector.
+ */
+Expr mkTerm(ExprManager& em, unsigned width, unsigned depth,
+            Integer& expected) {
+  Integer value = truncate(Integer(nextRandom()), width);
+  Integer mask = Integer(1).multiplyByPow2(width) - Integer(1);
+  Expr term = em.mkConst(BitVector(width, value));
+  for(unsigned i = 0; i < depth; ++i) {
+    Integer c = truncate(Integer(nextRandom()), width);
+    Expr constant = em.mkConst(BitVector(width, c));
+    switch(i % 8) {
+    case 0:
+      term = em.mkExpr(kind::BITVECTOR_PLUS, term, constant);
+      value = truncate(value + c, width);
+      break;
+    case 1:
+      term = em.mkExpr(kind::BITVECTOR_MULT, term, constant);
+      value = truncate(value * c, width);
+      break;
+    case 2:
+      term = em.mkExpr(kind::BITVECTOR_XOR, term, constant);
+      value = value.bitwiseXor(c);
+      break;
+    case 3:
+      term = em.mkExpr(kind::BITVECTOR_SUB, term, constant);
+      value = truncate(value - c, width);
+      break;
+    case 4: {
+      unsigned amount = nextRandom() % width;
+      term = em.mkExpr(kind::BITVECTOR_LSHR, term,
+                       em.mkConst(BitVector(width, amount)));
+      value = value.divByPow2(amount);
+      break;
+    }
+    case 5:
+      term = em.mkExpr(kind::BITVECTOR_OR, term, constant);
+      value = value.bitwiseOr(c);
+      break;
+    case 6: {
+      // concatenate and extract the middle bits back to the same width
+      unsigned low = nextRandom() % width;
+      Expr concat = em.mkExpr(kind::BITVECTOR_CONCAT, term, constant);
+      term = em.mkExpr(em.mkConst(BitVectorExtract(low + width - 1, low)),
+                       concat);
+      value = (value.multiplyByPow2(width) + c).extractBitRange(width, low);
+      break;
+    }
+    default:
+      term = em.mkExpr(kind::BITVECTOR_NOT,
+                       em.mkExpr(kind::BITVECTOR_AND, term, constant));
+      value = value.bitwiseAnd(c).bitwiseXor(mask);
+      break;
+    }
+  }
+  expected = value;
+  return term;
+}
+
+}/* anonymous namespace */
+
+int main(int argc, char* argv[]) {
+  unsigned rounds = argc > 1 ? atoi(argv[1]) : 1;
+
+  ExprManager em;
+  SmtEngine smt(&em);
+  smt.setLogic("QF_BV");
+
+  const unsigned widths[] = { 8, 16, 32, 64, 65, 128 };
+  for(unsigned w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+    clock_t start = clock();
+    for(unsigned i = 0; i < 200 * rounds; ++i) {
+      Integer expected;
+      Expr term = mkTerm(em, widths[w], 40, expected);
+      Expr result = smt.simplify(term);
+      if(!result.isConst() ||
+         result.getConst<BitVector>().getSize() != widths[w] ||
+         result.getConst<BitVector>().getValue() != expected) {
+        cout << "width " << widths[w] << ": " << term << " simplified to "
+             << result << ", expected " << expected << endl;
+        return 1;
+      }
+    }
+    cout << "width " << widths[w] << ": "
+         << double(clock() - start) / CLOCKS_PER_SEC << "s" << endl;
+  }
+
+  return 0;
+}
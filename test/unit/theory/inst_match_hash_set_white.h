@@ -0,0 +1,118 @@
+/*********************                                                        */
+/*! \file inst_match_hash_set_white.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::inst::InstMatchHashSet
+ **
+ ** White box testing of CVC4::theory::inst::InstMatchHashSet and
+ ** CVC4::theory::inst::CDInstMatchHashSet.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+
+#include "context/context.h"
+#include "expr/expr_manager.h"
+#include "expr/node_manager.h"
+#include "expr/type_node.h"
+#include "theory/quantifiers/inst_match.h"
+
+using namespace CVC4;
+using namespace CVC4::context;
+using namespace CVC4::theory;
+using namespace CVC4::theory::inst;
+
+using namespace std;
+
+class InstMatchHashSetWhite : public CxxTest::TestSuite {
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  NodeManagerScope* d_scope;
+  Context* d_ctxt;
+  std::vector<Node> d_consts;
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_scope = new NodeManagerScope(d_nm);
+    d_ctxt = new Context();
+    TypeNode u = d_nm->mkSort("U");
+    for(unsigned i = 0; i < 20; ++i) {
+      std::stringstream ss;
+      ss << "a" << i;
+      d_consts.push_back(d_nm->mkSkolem(ss.str(), u));
+    }
+  }
+
+  void tearDown() {
+    d_consts.clear();
+    delete d_ctxt;
+    delete d_scope;
+    delete d_em;
+  }
+
+  std::vector<Node> mkTerms(unsigned i, unsigned j) {
+    std::vector<Node> m;
+    m.push_back(d_consts[i]);
+    m.push_back(d_consts[j]);
+    return m;
+  }
+
+  bool contains(InstMatchHashSet& s, std::vector<Node> m) {
+    bool filtered;
+    return s.contains(m, InstMatchHashFunction()(m), filtered);
+  }
+
+  bool contains(CDInstMatchHashSet& s, std::vector<Node> m) {
+    bool filtered;
+    return s.contains(m, InstMatchHashFunction()(m), filtered);
+  }
+
+  void testAddRemove() {
+    InstMatchHashSet s;
+    // enough term vectors to resize the Bloom filter
+    for(unsigned i = 0; i < d_consts.size(); ++i) {
+      for(unsigned j = 0; j < d_consts.size(); j += 2) {
+        std::vector<Node> m = mkTerms(i, j);
+        TS_ASSERT(!contains(s, m));
+        s.add(m, InstMatchHashFunction()(m));
+        TS_ASSERT(contains(s, m));
+      }
+    }
+    for(unsigned i = 0; i < d_consts.size(); ++i) {
+      for(unsigned j = 0; j < d_consts.size(); ++j) {
+        TS_ASSERT_EQUALS(contains(s, mkTerms(i, j)), j % 2 == 0);
+      }
+    }
+    std::vector<Node> m = mkTerms(3, 4);
+    TS_ASSERT(s.remove(m));
+    TS_ASSERT(!s.remove(m));
+    TS_ASSERT(!contains(s, m));
+    s.clear();
+    TS_ASSERT(!contains(s, mkTerms(0, 0)));
+  }
+
+  void testContextDependent() {
+    CDInstMatchHashSet s(d_ctxt);
+    std::vector<Node> m1 = mkTerms(0, 1);
+    std::vector<Node> m2 = mkTerms(1, 0);
+    s.add(m1, InstMatchHashFunction()(m1));
+    d_ctxt->push();
+    s.add(m2, InstMatchHashFunction()(m2));
+    TS_ASSERT(s.remove(m1));
+    TS_ASSERT(!contains(s, m1));
+    TS_ASSERT(contains(s, m2));
+    d_ctxt->pop();
+    // the removal and the addition are both undone
+    TS_ASSERT(contains(s, m1));
+    TS_ASSERT(!contains(s, m2));
+  }
+};
@@ -0,0 +1,104 @@
+/*********************                                                        */
+/*! \file term_arg_trie_white.h
+ ** \verbatim
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2016 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::quantifiers::TermArgTrie
+ **
+ ** White box testing of CVC4::theory::quantifiers::TermArgTrie, in
+ ** particular of nodes whose children are found through the hash index.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+
+#include "expr/expr_manager.h"
+#include "expr/kind.h"
+#include "expr/node_manager.h"
+#include "expr/type_node.h"
+#include "theory/quantifiers/term_database.h"
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::theory::quantifiers;
+using namespace CVC4::kind;
+
+using namespace std;
+
+class TermArgTrieWhite : public CxxTest::TestSuite {
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  NodeManagerScope* d_scope;
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_scope = new NodeManagerScope(d_nm);
+  }
+
+  void tearDown() {
+    delete d_scope;
+    delete d_em;
+  }
+
+  void testAddOrGetTerm() {
+    TypeNode u = d_nm->mkSort("U");
+    Node f = d_nm->mkSkolem("f", d_nm->mkFunctionType(u, u));
+    // enough arguments to pass the point where the hash index is built
+    std::vector<Node> args;
+    std::vector<Node> terms;
+    for(unsigned i = 0; i < 100; ++i) {
+      std::stringstream ss;
+      ss << "a" << i;
+      args.push_back(d_nm->mkSkolem(ss.str(), u));
+      terms.push_back(d_nm->mkNode(APPLY_UF, f, args.back()));
+    }
+
+    TermArgTrie trie;
+    for(unsigned i = 0; i < args.size(); ++i) {
+      std::vector<TNode> reps;
+      reps.push_back(args[i]);
+      TS_ASSERT_EQUALS(trie.addOrGetTerm(terms[i], reps), terms[i]);
+    }
+    TS_ASSERT_EQUALS(trie.d_data.size(), args.size());
+
+    // congruent terms are found again, for both lookup paths
+    for(unsigned i = 0; i < args.size(); ++i) {
+      std::vector<TNode> reps;
+      reps.push_back(args[i]);
+      TS_ASSERT_EQUALS(trie.existsTerm(reps), terms[i]);
+      TS_ASSERT(!trie.addTerm(terms[(i + 1) % terms.size()], reps));
+    }
+    std::vector<TNode> reps;
+    reps.push_back(d_nm->mkSkolem("b", u));
+    TS_ASSERT(trie.existsTerm(reps).isNull());
+    TS_ASSERT_EQUALS(trie.d_data.size(), args.size());
+
+    // children are iterated in insertion order
+    unsigned i = 0;
+    for(TermArgTrie::iterator it = trie.d_data.begin();
+        it != trie.d_data.end(); ++it, ++i) {
+      TS_ASSERT_EQUALS(it->first, TNode(args[i]));
+      TS_ASSERT(it->second.hasNodeData());
+      TS_ASSERT_EQUALS(it->second.getNodeData(), TNode(terms[i]));
+    }
+    TS_ASSERT_EQUALS(i, args.size());
+
+    // copies are deep and keep their own index
+    TermArgTrie copy = trie;
+    trie.clear();
+    TS_ASSERT(!trie.hasNodeData());
+    for(unsigned j = 0; j < args.size(); ++j) {
+      std::vector<TNode> r;
+      r.push_back(args[j]);
+      TS_ASSERT_EQUALS(copy.existsTerm(r), terms[j]);
+    }
+  }
+};
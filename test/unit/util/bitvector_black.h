@@ -52,4 +52,66 @@ public:
     TS_ASSERT_EQUALS( "26", b4.toString(10) );
     TS_ASSERT_EQUALS( "1a", b4.toString(16) );
   }
+
+  void testArithmeticWraps() {
+    // widths up to 64 are computed on machine words, wider ones on Integers
+    BitVector max8(8, 255u);
+    BitVector one8(8, 1u);
+    TS_ASSERT_EQUALS( BitVector(8, 0u), max8 + one8 );
+    TS_ASSERT_EQUALS( max8, -one8 );
+    TS_ASSERT_EQUALS( one8, max8 * max8 );
+    TS_ASSERT_EQUALS( BitVector(8, 254u), ~one8 );
+
+    BitVector max64 = ~BitVector(64, 0u);
+    BitVector one64(64, 1u);
+    TS_ASSERT_EQUALS( BitVector(64, 0u), max64 + one64 );
+    TS_ASSERT_EQUALS( one64, max64 * max64 );
+    TS_ASSERT_EQUALS( 64u, max64.toString().size() );
+    TS_ASSERT_EQUALS( "ffffffffffffffff", max64.toString(16) );
+    TS_ASSERT_EQUALS( "18446744073709551615", max64.toString(10) );
+
+    BitVector max65 = max64.zeroExtend(1) + max64.zeroExtend(1) + BitVector(65, 1u);
+    TS_ASSERT_EQUALS( ~BitVector(65, 0u), max65 );
+    TS_ASSERT_EQUALS( BitVector(65, 0u), max65 + BitVector(65, 1u) );
+    TS_ASSERT_EQUALS( max64, max65.extract(64, 1) );
+    TS_ASSERT_EQUALS( max65, max64.concat(BitVector(1, 1u)) );
+    TS_ASSERT_EQUALS( max65, max64.signExtend(1) );
+  }
+
+  void testShiftsAndCompares() {
+    BitVector b("10010110", 2);
+    TS_ASSERT_EQUALS( "01011000", b.leftShift(BitVector(8, 2u)).toString() );
+    TS_ASSERT_EQUALS( "00100101", b.logicalRightShift(BitVector(8, 2u)).toString() );
+    TS_ASSERT_EQUALS( "11100101", b.arithRightShift(BitVector(8, 2u)).toString() );
+    TS_ASSERT_EQUALS( "00000000", b.leftShift(BitVector(8, 8u)).toString() );
+    TS_ASSERT_EQUALS( "11111111", b.arithRightShift(BitVector(8, 200u)).toString() );
+
+    BitVector m64 = BitVector(64, 1u).leftShift(BitVector(64, 63u));
+    TS_ASSERT( m64.signedLessThan(BitVector(64, 0u)) );
+    TS_ASSERT( BitVector(64, 0u).unsignedLessThan(m64) );
+    TS_ASSERT_EQUALS( Integer(-1).multiplyByPow2(63), m64.toSignedInt() );
+    TS_ASSERT_EQUALS( 64u, m64.isPow2() );
+    TS_ASSERT_EQUALS( ~BitVector(64, 0u), m64.arithRightShift(BitVector(64, 63u)) );
+
+    BitVector m65 = m64.signExtend(1);
+    TS_ASSERT( m65.signedLessThan(BitVector(65, 0u)) );
+    TS_ASSERT_EQUALS( m64.toSignedInt(), m65.toSignedInt() );
+    TS_ASSERT_EQUALS( BitVector(65, 1u).leftShift(BitVector(65, 64u)),
+                      m65.logicalRightShift(BitVector(65, 1u)).leftShift(BitVector(65, 2u)) );
+  }
+
+  void testDivision() {
+    BitVector a(32, 100u);
+    BitVector zero(32, 0u);
+    TS_ASSERT_EQUALS( BitVector(32, 14u), a.unsignedDivTotal(BitVector(32, 7u)) );
+    TS_ASSERT_EQUALS( BitVector(32, 2u), a.unsignedRemTotal(BitVector(32, 7u)) );
+    TS_ASSERT_EQUALS( ~zero, a.unsignedDivTotal(zero) );
+    TS_ASSERT_EQUALS( a, a.unsignedRemTotal(zero) );
+
+    BitVector w = a.zeroExtend(68);
+    BitVector wzero(100, 0u);
+    TS_ASSERT_EQUALS( BitVector(100, 14u), w.unsignedDivTotal(BitVector(100, 7u)) );
+    TS_ASSERT_EQUALS( ~wzero, w.unsignedDivTotal(wzero) );
+    TS_ASSERT_EQUALS( w, w.unsignedRemTotal(wzero) );
+  }
 };
@@ -15,8 +15,10 @@
  **/
 
 #include <cxxtest/TestSuite.h>
+#include <signal.h>
 #include <sstream>
 #include <string>
+#include <cstring>
 #include <ctime>
 
 #include "lib/clock_gettime.h"
@@ -37,6 +39,11 @@ bool operator==(const timespec& a, const timespec& b) {
   return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
 }
 
+/** The same handler as the driver installs for SIGUSR1. */
+void requestFlushHandler(int sig) {
+  StatisticsRegistry::requestFlush();
+}
+
 class StatsBlack : public CxxTest::TestSuite {
 public:
 
@@ -107,4 +114,28 @@ public:
 #endif /* CVC4_STATISTICS_ON */
   }
 
+  void testFlushRequest() {
+    // consume a request left over by an earlier test
+    StatisticsRegistry::flushRequested();
+    TS_ASSERT(!StatisticsRegistry::flushRequested());
+
+    // a request is reported once, however often it was made
+    StatisticsRegistry::requestFlush();
+    StatisticsRegistry::requestFlush();
+    TS_ASSERT(StatisticsRegistry::flushRequested());
+    TS_ASSERT(!StatisticsRegistry::flushRequested());
+
+    // a request made from a signal handler
+    struct sigaction act, old;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = requestFlushHandler;
+    sigemptyset(&act.sa_mask);
+    TS_ASSERT_EQUALS(sigaction(SIGUSR1, &act, &old), 0);
+    TS_ASSERT(!StatisticsRegistry::flushRequested());
+    raise(SIGUSR1);
+    TS_ASSERT(StatisticsRegistry::flushRequested());
+    TS_ASSERT(!StatisticsRegistry::flushRequested());
+    sigaction(SIGUSR1, &old, NULL);
+  }
+
 };